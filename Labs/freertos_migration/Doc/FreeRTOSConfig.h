@@ -11,6 +11,13 @@
 #define configMAX_TASK_NAME_LEN                     16
 #define configUSE_16_BIT_TICKS                      0           // Tick 计数器位数（ARM 用 0 = 32位）
 
+// tickless idle：所有任务都阻塞时停掉周期 tick，GPT1 比较值定到下一个唤醒时刻再 WFI（freertos_port.c）
+// 2 = 移植层自己实现 portSUPPRESS_TICKS_AND_SLEEP；改成 0 恢复每个 tick 一次中断，用来对比
+#define configUSE_TICKLESS_IDLE                     2
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP       2
+extern void vPortSuppressTicksAndSleep(uint32_t xExpectedIdleTime);
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
+
 // function         
 #define configUSE_MUTEXES                           1
 #define configUSE_RECURSIVE_MUTEXES                 0
@@ -67,7 +74,10 @@ extern void vClearTickInterrupt(void);
 #define configUSE_TRACE_FACILITY                    1
 #define configUSE_STATS_FORMATTING_FUNCTIONS        1
 
-#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() /* 空，GPT2 已初始化 */
-#define portGET_RUN_TIME_COUNTER_VALUE()         GPT2->CNT
+/* GPT1（Tick 定时器）计数经 timebase 扩展到 64 位（溢出中断），长时间运行的统计不会回绕 */
+extern uint64_t timebase_now64(void);
+#define configRUN_TIME_COUNTER_TYPE                 uint64_t
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() /* 空，vConfigureTickInterrupt() 已初始化 GPT1 和 timebase */
+#define portGET_RUN_TIME_COUNTER_VALUE()         timebase_now64()
 
 #endif //__FREERTOSCONFIG_H
\ No newline at end of file
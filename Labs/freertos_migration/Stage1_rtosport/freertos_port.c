@@ -1,19 +1,49 @@
 #include "bsp_int.h"
 #include "imx6ul.h"
-#include "FreeRTOS.h"
-#include "task.h"
+#include "freertos_port.h"
+#include "bsp_timebase.h"
+#include "bsp_timer_service.h"
+
+/* Tick compare: deadlines advance by whole periods, interval-error stats */
+static timebase_periodic_t g_tick_timer;
+
+/* GPT1 counts per RTOS tick: calibrated GPT1 rate / configTICK_RATE_HZ
+ * (645 at ~645 kHz), set in vConfigureTickInterrupt() */
+static uint32_t g_tick_period;
+static tickless_stats_t g_tickless_stats;
 
 // FreeRTOS Tick interrupt handler
 void freertos_gpt1_irq_handler(unsigned int giccIar, void *param)
 {
+    uint32_t entry = GPT1->CNT;
+    uint32_t periods;
+    BaseType_t switch_required = pdFALSE;
+    
+    /* GPT1_IRQn is shared: rollover (64-bit count) and the timer-service
+     * compares (OCR2/OCR3) are handled first, the tick only on its own flag */
+    timebase_irq_handler();
+    timer_service_irq_handler();
+    if (!(GPT1->SR & GPT1->IR & (1 << 0))) {
+        return;
+    }
+    
     /* Clear interrupt flag */
     GPT1->SR = 1 << 0;
+    g_tickless_stats.tick_interrupts++;
     
-    /* Update next compare value (required for FreeRun mode) */
-    GPT1->OCR[0] = GPT1->CNT + 1000;  // 1000 ticks = 1ms
+    /* Next compare = this deadline + period (not CNT + period): ISR latency
+     * no longer stretches the tick, so the tick count does not drift */
+    periods = timebase_periodic_advance(&g_tick_timer, entry);
     
-    /* Call FreeRTOS tick increment function */
-    if (xTaskIncrementTick() != pdFALSE) 
+    /* Call FreeRTOS tick increment function, once per elapsed period:
+     * ticks missed while interrupts were masked (or slept past after a
+     * tickless wake-up) are caught up here */
+    while (periods-- > 0) {
+        if (xTaskIncrementTick() != pdFALSE) {
+            switch_required = pdTRUE;
+        }
+    }
+    if (switch_required != pdFALSE)
     {
         /* Task switch needed */
         portYIELD();
@@ -27,34 +57,49 @@ void vConfigureTickInterrupt(void)
     /* 1. Disable GPT1 */
     GPT1->CR = 0;
     
-    /* 2. Set prescaler: 66MHz / 66 = 1MHz */
+    /* 2. Set prescaler: IPG_CLK / 66, nominally 1MHz but measured ~645kHz */
     GPT1->PR = 65;  // Prescaler = 65 (divide by 66)
     
-    /* 3. Set output compare register: 1MHz / 1000 = 1ms */
-    GPT1->OCR[0] = 1000;  // 1000 ticks at 1MHz = 1ms
-    
-    /* 4. Clear all status flags */
-    GPT1->SR = 0x3F;
-    
-    /* 5. Enable output compare interrupt */
-    GPT1->IR = 1 << 0;  // Enable OCR1 interrupt
-    
-    /* 6. Configure control register
+    /* 3. Configure control register
      * Bit 9 = 1: FreeRun mode
-     * Bit 6 = 1: Clock source IPG_CLK (66MHz)
+     * Bit 6 = 1: Clock source IPG_CLK
      * Bit 1 = 1: Enable mode (start counting from 0)
      * Bit 0 = 0: Don't start yet
      */
     GPT1->CR = (1 << 9) | (1 << 6) | (1 << 1);
     
-    /* 7. Register interrupt handler */
+    /* 4. Measure the GPT1 rate against the 32.768kHz RTC (~250ms, runs
+     * GPT1 temporarily); falls back to the nominal 645kHz */
+    timebase_calibrate(GPT1);
+    
+    /* 5. Set output compare register: one tick = rate / configTICK_RATE_HZ */
+    g_tick_period = timebase_rate_hz() / configTICK_RATE_HZ;
+    timebase_periodic_init(&g_tick_timer, GPT1, 0, g_tick_period);
+    
+    /* 6. Clear all status flags */
+    GPT1->SR = 0x3F;
+    
+    /* 7. Enable output compare interrupt */
+    GPT1->IR = 1 << 0;  // Enable OCR1 interrupt
+    
+    /* 8. Register interrupt handler */
     system_register_irqhandler(GPT1_IRQn, (system_irq_handler_t)freertos_gpt1_irq_handler, NULL);
     
-    /* 8. Enable GIC interrupt */
+    /* 9. Set interrupt priority: timer-service jobs call FromISR APIs
+     * (must be >= configMAX_API_CALL_INTERRUPT_PRIORITY) */
+    GIC_SetPriority(GPT1_IRQn, configMAX_API_CALL_INTERRUPT_PRIORITY);
+    
+    /* 10. Enable GIC interrupt */
     GIC_EnableIRQ(GPT1_IRQn);
     
-    /* 9. Start GPT1 */
+    /* 11. Start GPT1 */
     GPT1->CR |= (1 << 0);  // Set EN bit
+    
+    /* 12. GPT1 also serves as the 64-bit timebase (rollover interrupt) and
+     * carries the timer service on OCR2/OCR3, so no second GPT is needed for
+     * sampling (after IR is written: both only set their own IR bits) */
+    timebase_init(GPT1);
+    timer_service_init(GPT1, (1 << 1) | (1 << 2));
 }
 
 
@@ -66,6 +111,78 @@ void vClearTickInterrupt(void)
     /* GPT1 interrupt flag already cleared in freertos_gpt1_irq_handler */
 }
 
+/**
+ * Tickless idle (portSUPPRESS_TICKS_AND_SLEEP, called by the idle task with
+ * the scheduler suspended when every task is blocked for at least
+ * configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks)
+ *
+ * GPT1 keeps free-running: only the tick compare (OCR1) moves from the next
+ * tick to the tick the kernel expects to wake up on, then the core sits in
+ * WFI. On wake-up the ticks that passed are stepped into the kernel, counted
+ * from the last tick boundary, so the tick count stays locked to GPT1 and
+ * does not drift however often the core sleeps.
+ *
+ * Interrupts are masked with CPSR.I, not the GIC priority mask: a pending
+ * IRQ still ends WFI, but its handler only runs once the tick count has been
+ * corrected. The timer-service jobs (sampler) and the rollover interrupt
+ * wake the core the same way.
+ */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    uint32_t last, wake, start, next, periods;
+    
+    /* Keep the wake-up compare well inside half a counter wrap */
+    if (xExpectedIdleTime > 0x40000000u / g_tick_period) {
+        xExpectedIdleTime = 0x40000000u / g_tick_period;
+    }
+    
+    __asm volatile ("cpsid i" ::: "memory");
+    
+    /* A task became ready, or the next tick is (nearly) due: not worth it */
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep ||
+        (int32_t)(g_tick_timer.deadline - GPT1->CNT) < TIMEBASE_OCR_MARGIN) {
+        g_tickless_stats.aborted++;
+        __asm volatile ("cpsie i" ::: "memory");
+        return;
+    }
+    
+    /* Tick compare: next tick -> expected wake-up tick */
+    last = g_tick_timer.deadline - g_tick_period;  /* Last tick already counted */
+    wake = last + xExpectedIdleTime * g_tick_period;
+    GPT1->OCR[0] = wake;
+    
+    start = GPT1->CNT;
+    __asm volatile ("dsb\n\twfi\n\tisb" ::: "memory");
+    g_tickless_stats.sleep_counts += GPT1->CNT - start;
+    g_tickless_stats.sleeps++;
+    
+    /* Tick boundaries passed since the last counted tick: periods - 1 */
+    next = timebase_next_deadline(GPT1, last, g_tick_period, &periods);
+    if (periods - 1 >= xExpectedIdleTime) {
+        /* Woken by the tick compare (or it is about to fire): step all but
+         * the last tick, the pending tick interrupt counts that one plus any
+         * overrun through its catch-up */
+        vTaskStepTick(xExpectedIdleTime - 1);
+        g_tickless_stats.ticks_suppressed += xExpectedIdleTime - 1;
+        g_tick_timer.deadline = wake;
+    } else {
+        /* Woken early by another interrupt: step the ticks that passed and
+         * put the tick compare back on the next tick boundary */
+        vTaskStepTick(periods - 1);
+        g_tickless_stats.ticks_suppressed += periods - 1;
+        g_tick_timer.deadline = next;
+        GPT1->OCR[0] = next;
+        g_tickless_stats.early_wakeups++;
+    }
+    
+    __asm volatile ("cpsie i" ::: "memory");
+}
+
+tickless_stats_t *tickless_get_stats(void)
+{
+    return &g_tickless_stats;
+}
+
 void vApplicationIdleHook(void)
 {
     /* Can enter low power mode here */
@@ -0,0 +1,21 @@
+#ifndef __FREERTOS_PORT_H
+#define __FREERTOS_PORT_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Tick / tickless idle counters, all cumulative since boot */
+typedef struct {
+    uint32_t tick_interrupts;   /* Tick compare interrupts taken */
+    uint32_t sleeps;            /* WFI entries from the idle task */
+    uint32_t early_wakeups;     /* Woken by another interrupt before the expected tick */
+    uint32_t aborted;           /* Sleep abandoned: a task became ready or the tick was due */
+    uint32_t ticks_suppressed;  /* Ticks counted by vTaskStepTick() instead of an interrupt */
+    uint64_t sleep_counts;      /* GPT1 counts spent in WFI */
+} tickless_stats_t;
+
+void vConfigureTickInterrupt(void);
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime);
+tickless_stats_t *tickless_get_stats(void);
+
+#endif //__FREERTOS_PORT_H
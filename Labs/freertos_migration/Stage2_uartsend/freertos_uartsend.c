@@ -1,23 +1,28 @@
 #include "freertos_uartsend.h"
 #include "../bsp/uart/bsp_uart_async.h"  // Async UART
+#include "../bsp/timebase/bsp_timer_service.h"  // Sampling job on GPT1 (no GPT2)
 
 SemaphoreHandle_t timer_semaphore; 
 QueueHandle_t uart_queue;
 static uint32_t g_last_send_time = 0;  // Global variable: last async send start time
 
+/* Sampling job on the GPT1 timer service (dedicated compare channel):
+ * absolute deadlines, missed-deadline and interval-error stats */
+static timer_job_t g_sensor_job;
+
 static inline uint32_t get_high_precision_tick(void)
 {
-    return GPT2->CNT;
+    return GPT1->CNT;
 }
 
-void sensor_timer_irq_handler(unsigned int giccIar, void *param)
+/**
+ * Sampling job (GPT1 interrupt context, from the timer service)
+ * Deadlines advance by 50ms from the previous one, so ISR latency does not
+ * accumulate into sampling drift. Missed deadlines are skipped, not made up:
+ * the sensor task reads once per give and extra reads would return the same data
+ */
+static void sensor_timer_job(void *param, uint32_t periods)
 {
-    /* Clear interrupt flag */
-    GPT2->SR = 1 << 0;
-    
-    /* Update next compare value (FreeRun mode) */
-    GPT2->OCR[0] = GPT2->CNT + 32250;  // 645kHz * 50ms = 32250 ticks
-    
     // Give semaphore and check if immediate context switch needed
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
     xSemaphoreGiveFromISR(timer_semaphore, &xHigherPriorityTaskWoken);
@@ -26,52 +31,30 @@ void sensor_timer_irq_handler(unsigned int giccIar, void *param)
 }
 
 /**
- * Initialize sensor sampling timer (GPT2, 50ms)
+ * Initialize sensor sampling timer (50ms)
+ * Sampling is a job on the GPT1 timer service, which the port sets up along
+ * with the tick (vConfigureTickInterrupt): GPT2 is no longer used
  */
 void sensor_timer_init(void)
 {
-    /* 1. Disable GPT2 */
-    GPT2->CR = 0;
-    
-    /* 2. Set prescaler */
-    GPT2->PR = 65;  // 66MHz / 66 = 1MHz
-    
-    /* 3. Set output compare register: 50ms */
-    GPT2->OCR[0] = 32250;  // 32250
-    
-    /* 4. Clear all status flags */
-    GPT2->SR = 0x3F;
-    
-    /* 5. Enable output compare interrupt */
-    GPT2->IR = 1 << 0;
-    
-    /* 6. Configure control register */
-    GPT2->CR = (1 << 9) | (1 << 6) | (1 << 1);  // FreeRun + IPG_CLK
-    
-    /* 7. Register interrupt handler */
-    system_register_irqhandler(GPT2_IRQn, 
-                              (system_irq_handler_t)sensor_timer_irq_handler, 
-                              NULL);
-    
-    /* 8. Set interrupt priority (must be >= configMAX_API_CALL_INTERRUPT_PRIORITY) */
-    // Note: GIC_SetPriority() already does left shift internally, pass value directly
-    GIC_SetPriority(GPT2_IRQn, configMAX_API_CALL_INTERRUPT_PRIORITY);
-    
-    /* 9. Enable GIC interrupt */
-    GIC_EnableIRQ(GPT2_IRQn);
-
-    printf("[Sensor Timer] GPT2 initialized (not started yet)\r\n");
+    printf("[Sensor Timer] Sampling job on the GPT1 timer service (not started yet)\r\n");
 }
 
 
 void sensor_timer_start(void)
 {
-    GPT2->CR |= (1 << 0);
-    printf("[Sensor Timer] GPT2 started: 50ms period\r\n");
+    uint32_t period = timebase_ms_to_ticks(50);  // Calibrated GPT1 rate (32250 at 645kHz)
+    
+    timer_job_start(&g_sensor_job, period, period, TIMER_JOB_DEDICATED,
+                    sensor_timer_job, NULL);
+    printf("[Sensor Timer] Sampling job started: 50ms period\r\n");
 }
 
 void freertos_test2_loop(void)
 {
+    // CRC lookup tables (before any packet is sealed)
+    packet_crc_init();
+    
     // init async UART
     uart_async_init();
     printf("[FreeRTOS] Async UART initialized\r\n");
@@ -96,7 +79,7 @@ void freertos_test2_loop(void)
     xTaskCreate(uart_task2, "UART", 256, NULL, 2, NULL);      // Priority 2
     xTaskCreate(led_task2, "LED", 128, NULL, 1, NULL);        // Priority 1
     
-    // init GPT2 timer (but don't start yet)
+    // init sampling timer (but don't start yet)
     sensor_timer_init();
     
     // 5. Start scheduler
@@ -119,9 +102,9 @@ void sensor_task2(void *param)
     sensor_packet_t packet;
     static uint16_t seq_num = 0;
     
-    printf("[Sensor Task] Started, starting GPT2 timer...\r\n");
+    printf("[Sensor Task] Started, starting sampling timer...\r\n");
     
-    // Start GPT2 after scheduler is running (safe)
+    // Start the sampling job after scheduler is running (safe)
     sensor_timer_start();
     
     printf("[Sensor Task] Waiting for timer signal...\r\n");
@@ -145,12 +128,11 @@ void sensor_task2(void *param)
         uint32_t read_end = get_high_precision_tick();
         
         // Fill processing time and send time
-        packet.process_time_us = read_end - read_start;  // Sensor read time
-        packet.send_time_us = g_last_send_time;          // Last async send start time
-        packet.padding = 0;
+        packet.process_ticks = read_end - read_start;  // Sensor read time
+        packet.send_ticks = g_last_send_time;          // Last async send start time
         
-        // Calculate checksum
-        packet.checksum = calculate_checksum(&packet);
+        // Fill checksum / CRC-16 (PACKET_CHECK_MODE)
+        packet_seal(&packet);
         
         // Send to UART queue (non-blocking, returns immediately)
         xQueueSend(uart_queue, &packet, 0);
@@ -161,6 +143,9 @@ void uart_task2(void *param)
 {
     sensor_packet_t packet;
     
+    // GPT1 was calibrated when the scheduler set up the tick; the async UART's
+    // timeouts and latency stats use the measured rate from here on
+    uart_async_set_clock_hz(timebase_rate_hz());
     printf("[UART Task] Started, waiting for data from queue...\r\n");
     
     while(1) 
@@ -16,6 +16,7 @@
 
 // baseline header (for sensor_packet_t and calculate_checksum)
 #include "baseline.h"
+#include "packet_crc.h"  // packet_seal(): checksum / CRC-16
 
 void freertos_test2_loop(void);
 void sensor_task2(void *param);
@@ -1,79 +1,120 @@
 #include "freertos_uartsend.h"
 #include "../bsp/uart/bsp_uart_async.h"  // Async UART
+#include "../bsp/icm20608/bsp_icm20608_async.h"  // DRDY interrupt
+#include "../bsp/timebase/bsp_timebase.h"  // 64-bit GPT1 count
+#include "../bsp/timebase/bsp_timer_service.h"  // Sampling job on GPT1 (no GPT2)
+#include "timebase_frame.h"  // Full count for the receiver, once a second
+#include "freertos_port.h"  // Tickless idle stats
 
 SemaphoreHandle_t timer_semaphore; 
-QueueHandle_t uart_queue;
+
+// Sensor -> UART hand-off: packets are built in place in a ring slot and the
+// UART ISR reads them straight out of it (no queue copy in, no copy out)
+RING_SPSC_DEFINE(g_uart_ring, sensor_packet_t, 16);
+static TaskHandle_t g_uart_task = NULL;
 static uint32_t g_last_send_time = 0;  // Global variable: last async send start time
+static uint32_t g_last_timebase_time = 0;  // GPT1 count at the last timebase frame
+#if SENSOR_DRDY_MODE
+static volatile uint32_t g_drdy_edge_time = 0;  // GPT count latched at the last DRDY edge
+#endif
+
+/* Sampling job on the GPT1 timer service (dedicated compare channel):
+ * absolute deadlines, missed-deadline and interval-error stats */
+static timer_job_t g_sensor_job;
 
 static inline uint32_t get_high_precision_tick(void)
 {
-    return GPT2->CNT;
+    return GPT1->CNT;
 }
 
-void sensor_timer_irq_handler(unsigned int giccIar, void *param)
+#if !SENSOR_DRDY_MODE
+/**
+ * Sampling job (GPT1 interrupt context, from the timer service)
+ * Deadlines advance by 50ms from the previous one, so ISR latency does not
+ * accumulate into sampling drift. Missed deadlines are skipped, not made up:
+ * the sensor task reads once per give and extra reads would return the same data
+ */
+static void sensor_timer_job(void *param, uint32_t periods)
 {
-    /* Clear interrupt flag */
-    GPT2->SR = 1 << 0;
-    
-    /* Update next compare value (FreeRun mode) */
-    GPT2->OCR[0] = GPT2->CNT + 32250;  // 645kHz * 50ms = 32250 ticks
-    
     // Give semaphore and check if immediate context switch needed
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
     xSemaphoreGiveFromISR(timer_semaphore, &xHigherPriorityTaskWoken);
     // Yield based on return value
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
+#endif
 
 /**
- * Initialize sensor sampling timer (GPT2, 50ms)
+ * Zero-copy send completion (UART1 interrupt context)
+ * The claimed slots are in the TX FIFO: hand them back to the sensor task and
+ * wake the UART task, which may be waiting for a free TX descriptor
  */
-void sensor_timer_init(void)
+static void uart_send_done(void *param, uint32_t count)
 {
-    /* 1. Disable GPT2 */
-    GPT2->CR = 0;
-    
-    /* 2. Set prescaler */
-    GPT2->PR = 65;  // 66MHz / 66 = 1MHz
-    
-    /* 3. Set output compare register: 50ms */
-    GPT2->OCR[0] = 32250;  // 32250
-    
-    /* 4. Clear all status flags */
-    GPT2->SR = 0x3F;
-    
-    /* 5. Enable output compare interrupt */
-    GPT2->IR = 1 << 0;
-    
-    /* 6. Configure control register */
-    GPT2->CR = (1 << 9) | (1 << 6) | (1 << 1);  // FreeRun + IPG_CLK
-    
-    /* 7. Register interrupt handler */
-    system_register_irqhandler(GPT2_IRQn, 
-                              (system_irq_handler_t)sensor_timer_irq_handler, 
-                              NULL);
+    ring_spsc_release_claimed((ring_spsc_t *)param, count);
     
-    /* 8. Set interrupt priority (must be >= configMAX_API_CALL_INTERRUPT_PRIORITY) */
-    // Note: GIC_SetPriority() already does left shift internally, pass value directly
-    GIC_SetPriority(GPT2_IRQn, configMAX_API_CALL_INTERRUPT_PRIORITY);
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveFromISR(g_uart_task, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+#if SENSOR_DRDY_MODE
+/**
+ * DRDY callback (GPIO interrupt context)
+ * edge_time is latched by the driver as the first thing in the ISR,
+ * using ICM20608_ASYNC_NOW() (GPT1, the same counter as the sampling job)
+ */
+static void sensor_drdy_callback(uint32_t edge_time, void *param)
+{
+    g_drdy_edge_time = edge_time;
     
-    /* 9. Enable GIC interrupt */
-    GIC_EnableIRQ(GPT2_IRQn);
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(timer_semaphore, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+#endif
+
+/**
+ * Initialize sensor sampling timer (50ms)
+ * Sampling is a job on the GPT1 timer service, which the port sets up along
+ * with the tick (vConfigureTickInterrupt): GPT2 is no longer used
+ * In DRDY mode sampling is driven by the ICM20608 INT pin instead
+ */
+void sensor_timer_init(void)
+{
+#if SENSOR_DRDY_MODE
+    /* DRDY pin interrupt (callback uses FromISR API) */
+    icm20608_drdy_init(SENSOR_DRDY_ODR_HZ, sensor_drdy_callback, NULL);
+    GIC_SetPriority(ICM20608_DRDY_IRQn, configMAX_API_CALL_INTERRUPT_PRIORITY);
+#endif
 
-    printf("[Sensor Timer] GPT2 initialized (not started yet)\r\n");
+    printf("[Sensor Timer] Initialized (not started yet)\r\n");
 }
 
 
 void sensor_timer_start(void)
 {
-    GPT2->CR |= (1 << 0);
-    printf("[Sensor Timer] GPT2 started: 50ms period\r\n");
+#if SENSOR_DRDY_MODE
+    icm20608_drdy_enable();
+    printf("[Sensor Timer] Sampling on DRDY at %d Hz\r\n", SENSOR_DRDY_ODR_HZ);
+#else
+    uint32_t period = timebase_ms_to_ticks(50);  // Calibrated GPT1 rate (32250 at 645kHz)
+    
+    timer_job_start(&g_sensor_job, period, period, TIMER_JOB_DEDICATED,
+                    sensor_timer_job, NULL);
+    printf("[Sensor Timer] Sampling job started: 50ms period\r\n");
+#endif
 }
 
 void freertos_test2_loop(void)
 {
+    // CRC lookup tables (before any packet is sealed)
+    packet_crc_init();
+    
     // init async UART
     uart_async_init();
+    // Completion callback uses FromISR API (same rule as the sampling job)
+    GIC_SetPriority(UART1_IRQn, configMAX_API_CALL_INTERRUPT_PRIORITY);
     printf("[FreeRTOS] Async UART initialized\r\n");
     
     // Create semaphore
@@ -84,21 +125,17 @@ void freertos_test2_loop(void)
         while(1);
     }
     
-    // Create queue
-    uart_queue = xQueueCreate(16, sizeof(sensor_packet_t));
-    if (uart_queue == NULL) {
-        printf("[ERROR] Failed to create queue!\r\n");
-        while(1);
-    }
+    // Sensor -> UART ring (drop the newest sample when the link falls behind)
+    ring_spsc_reset(&g_uart_ring);
     
     // Create tasks
     xTaskCreate(sensor_task2, "Sensor", 512, NULL, 3, NULL);  // Priority 3 (highest)
-    xTaskCreate(uart_task2, "UART", 256, NULL, 2, NULL);      // Priority 2
+    xTaskCreate(uart_task2, "UART", 256, NULL, 2, &g_uart_task);  // Priority 2
     xTaskCreate(led_task2, "LED", 128, NULL, 1, NULL);        // Priority 1
     xTaskCreate(stats_task2, "Stats", 512, NULL, 0, NULL);    // Priority 0
 
     
-    // init GPT2 timer (but don't start yet)
+    // init sampling timer (but don't start yet)
     sensor_timer_init();
     
     // 5. Start scheduler
@@ -118,12 +155,12 @@ void led_task2(void *param)
 
 void sensor_task2(void *param)
 {
-    sensor_packet_t packet;
+    sensor_packet_t *packet;
     static uint16_t seq_num = 0;
     
-    printf("[Sensor Task] Started, starting GPT2 timer...\r\n");
+    printf("[Sensor Task] Started, starting sampling timer...\r\n");
     
-    // Start GPT2 after scheduler is running (safe)
+    // Start the sampling job after scheduler is running (safe)
     sensor_timer_start();
     
     printf("[Sensor Task] Waiting for timer signal...\r\n");
@@ -134,59 +171,95 @@ void sensor_task2(void *param)
         xSemaphoreTake(timer_semaphore, portMAX_DELAY);
         
         // ===== Execute after receiving signal =====
+        // Build the packet directly in a ring slot (NULL: ring full, sample dropped)
+        packet = ring_spsc_reserve(&g_uart_ring);
+        if (packet == NULL) {
+            seq_num++;  // keep the gap visible to the receiver
+            continue;
+        }
+        
         /* Fill packet header */
-        packet.header[0] = 0xAA;
-        packet.header[1] = 0x55;
-        packet.seq_num = seq_num++;
-        packet.timestamp = get_high_precision_tick();
+        packet->header[0] = 0xAA;
+        packet->header[1] = 0x55;
+        packet->seq_num = seq_num++;
+#if SENSOR_DRDY_MODE
+        packet->timestamp = g_drdy_edge_time;  // Conversion time, not task wake-up time
+#else
+        packet->timestamp = get_high_precision_tick();
+#endif
 
         // Read sensor data && time
         uint32_t read_start = get_high_precision_tick();
-        icm20608_read_data(&packet.accel_x, &packet.accel_y, &packet.accel_z,
-                          &packet.gyro_x, &packet.gyro_y, &packet.gyro_z);
+        icm20608_read_data(&packet->accel_x, &packet->accel_y, &packet->accel_z,
+                          &packet->gyro_x, &packet->gyro_y, &packet->gyro_z);
         uint32_t read_end = get_high_precision_tick();
         
         // Fill processing time and send time
-        packet.process_time_us = read_end - read_start;  // Sensor read time
-        packet.send_time_us = g_last_send_time;          // Last async send start time
-        packet.padding = 0;
+        packet->process_ticks = read_end - read_start;  // Sensor read time
+        packet->send_ticks = g_last_send_time;          // Last async send start time
         
-        // Calculate checksum
-        packet.checksum = calculate_checksum(&packet);
+        // Fill checksum / CRC-16 (PACKET_CHECK_MODE)
+        packet_seal(packet);
         
-        // Send to UART queue (non-blocking, returns immediately)
-        xQueueSend(uart_queue, &packet, 0);
+        // Publish the slot and wake the UART task (non-blocking)
+        ring_spsc_commit(&g_uart_ring);
+        xTaskNotifyGive(g_uart_task);
     }
 }
 
 void uart_task2(void *param)
 {
-    sensor_packet_t packet;
+    uint8_t *span;
+    uint32_t count;
     
-    printf("[UART Task] Started, waiting for data from queue...\r\n");
+    // GPT1 was calibrated when the scheduler set up the tick; the async UART's
+    // timeouts and latency stats use the measured rate from here on
+    uart_async_set_clock_hz(timebase_rate_hz());
+    printf("[UART Task] Started, waiting for data from ring...\r\n");
+    g_last_timebase_time = get_high_precision_tick() - TIMEBASE_FRAME_PERIOD_TICKS;  // first one right away
     
     while(1) 
     {
-        // Receive data from queue
-        // Block and wait until queue has data
-        if (xQueueReceive(uart_queue, &packet, portMAX_DELAY) == pdPASS) 
+        // Woken by the sensor task (new packet) or the UART ISR (TX descriptor freed)
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        
+        // Hand every pending slot to the UART by reference. The async UART
+        // queues up to UART_ASYNC_TX_QUEUE_DEPTH sends, so packets go out back
+        // to back; when the queue is full the next completion wakes us again.
+        while (uart_async_tx_free() > 0 &&
+               (span = ring_spsc_claim_span(&g_uart_ring, g_uart_ring.mask + 1, &count)) != NULL)
         {
-            // Wait for previous send to complete (if still in progress)
-            // This yields CPU, won't block other tasks
-            while (uart_async_is_busy()) {
-                vTaskDelay(1);  // Check every 1ms
-            }
-            
-            // Start async send (returns immediately)
             uint32_t send_start = get_high_precision_tick();
-            int ret = uart_async_send((uint8_t*)&packet, sizeof(sensor_packet_t));
+            int ret = uart_async_send_ref(span, sizeof(sensor_packet_t), g_uart_ring.stride,
+                                          count, uart_send_done, &g_uart_ring);
             uint32_t send_end = get_high_precision_tick();
             
             if (ret == 0) 
             {
-                // Successfully started, record start time
+                // Queued, record start time; slots come back in uart_send_done()
                 g_last_send_time = send_end - send_start;
             }
+            else
+            {
+                ring_spsc_claim_cancel(&g_uart_ring, count);
+                break;
+            }
+        }
+        
+        // Once a second, the full 64-bit GPT1 count: the receiver restores the
+        // upper bits of the 32-bit packet timestamps from it (copied, so the
+        // stack buffer can go as soon as the call returns)
+        if (get_high_precision_tick() - g_last_timebase_time >= TIMEBASE_FRAME_PERIOD_TICKS &&
+            uart_async_tx_free() > 0)
+        {
+            uint8_t frame[TIMEBASE_FRAME_LEN];
+            uint64_t now = timebase_now64();
+            
+            timebase_frame_build(frame, now);
+            if (uart_async_send(frame, TIMEBASE_FRAME_LEN) == 0)
+            {
+                g_last_timebase_time = (uint32_t)now;
+            }
         }
     }
 }
@@ -214,6 +287,47 @@ static void lcd_display_stats(void)
     
     // Title (white, large font 24)
     lcd_show_string(30, y, 750, 35, 24, "FreeRTOS Monitor");
+    
+    // Sampling job on the title row: missed deadlines, interval error min/max/mean (ticks),
+    // timer-service dispatch cost avg/max (CPU cycles, without the callbacks)
+    timebase_interval_t *timer = &g_sensor_job.stats;
+    timer_service_stats_t *svc = timer_service_get_stats();
+    if (timer->err_count > 0 && svc->irqs > 0) {
+        sprintf(line_buffer, "Timer miss:%u err:%d/%d/%d disp:%u/%ucyc",
+                timer->missed, timer->err_min, timer->err_max,
+                timer->err_sum / (int32_t)timer->err_count,
+                svc->dispatch_total / svc->irqs, svc->dispatch_max);
+        lcd_show_string(300, y + 2, 480, 18, 16, line_buffer);
+    }
+    
+    // Tickless idle over the last refresh: share of time in WFI, tick interrupts
+    // taken vs. ticks stepped over while asleep, early wake-ups (other IRQs)
+    static uint64_t last_now;
+    static tickless_stats_t last_idle;
+    tickless_stats_t *idle = tickless_get_stats();
+    uint64_t now = timebase_now64();
+    uint32_t elapsed = (uint32_t)(now - last_now);
+    uint32_t slept = (uint32_t)(idle->sleep_counts - last_idle.sleep_counts);
+    if (last_now != 0 && elapsed > 0) {
+        // 32-bit divide only (a 64-bit one pulls in __aeabi_uldivmod): scale both
+        // down until slept * 1000 fits, the ratio keeps about 22 bits
+        if (slept > elapsed) {
+            slept = elapsed;
+        }
+        while (elapsed >= (1u << 22)) {
+            elapsed >>= 1;
+            slept >>= 1;
+        }
+        uint32_t permille = slept * 1000 / elapsed;
+        sprintf(line_buffer, "Idle sleep:%u.%u%% tickIRQ:%u skip:%u early:%u",
+                permille / 10, permille % 10,
+                idle->tick_interrupts - last_idle.tick_interrupts,
+                idle->ticks_suppressed - last_idle.ticks_suppressed,
+                idle->early_wakeups - last_idle.early_wakeups);
+        lcd_show_string(300, y + 20, 480, 18, 16, line_buffer);
+    }
+    last_now = now;
+    last_idle = *idle;
     y += 40;
     
     // Get task list
@@ -343,12 +457,7 @@ void stats_task2()
 {
     printf("[Stats Task] Started (LCD Display Mode)\r\n");
     
-    // Start GPT2 timer (for runtime statistics counter only)
-    // Note: No need to start interrupt, just need counter running
-    if((GPT2->CR & 0x01) == 0) {  // Check if already started
-        GPT2->CR |= (1 << 0);  // Start GPT2
-        printf("[Stats Task] GPT2 timer started for runtime statistics\r\n");
-    }
+    // Runtime statistics count on GPT1 (timebase_now64), running since the tick started
     
     while(1) {
         vTaskDelay(pdMS_TO_TICKS(2000));  // Update LCD every 2 seconds
@@ -16,10 +16,21 @@
 
 // baseline header (for sensor_packet_t and calculate_checksum)
 #include "baseline.h"
+#include "packet_crc.h"  // packet_seal(): checksum / CRC-16
+#include "ring_spsc.h"   // 传感器任务 → UART 任务的零拷贝环形缓冲区
+
+// 采样触发源：0 = GPT1 定时器服务的采样任务（50ms），1 = ICM20608 DRDY 引脚中断
+// DRDY 模式下采样与传感器转换同步，时间戳是中断边沿锁存的 GPT 计数
+#ifndef SENSOR_DRDY_MODE
+#define SENSOR_DRDY_MODE    0
+#endif
+#define SENSOR_DRDY_ODR_HZ  20
 
 // FreeRTOS Stage 2: 信号驱动 + 异步UART
-// 架构：3个任务 + 1个信号量 + 1个队列 + 异步UART中断
+// 架构：3个任务 + 1个信号量 + 1个环形缓冲区 + 异步UART中断
 // 改进：UART 任务使用异步发送，不阻塞 CPU
+//       包在环形缓冲区槽内构造，UART 中断直接从槽里发送（零拷贝），
+//       发完在中断回调里归还槽并用任务通知唤醒 UART 任务（不再轮询）
 void freertos_test2_loop(void);
 void sensor_task2(void *param);
 void uart_task2(void *param);
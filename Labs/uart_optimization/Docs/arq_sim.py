@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+"""
+可靠模式（选择重传）有损信道仿真
+
+板子侧是编译到主机上的固件（fw_host.py）：link_arq.c 的窗口 / 发送顺序号判丢 / 自适应 RTO / 重传上限，
+link_control.c 解析上位机的控制帧（ARQ 打开、ACK、PING），bsp_uart_channel.c + bsp_uart_async.c 把帧发到
+host/sim_uart.c 的 UART1 模型上。主循环按 Stage 3 irq_dma.c 的可靠模式分支：link_control_poll()、
+uart_channel_poll()、Ring（16 槽，满时丢最新）里的包 link_arq_send() 进窗口、link_arq_poll() 发出。
+上位机侧直接用 generic_receiver.py 的 ArqReceiver，中间是有损线路：
+- 上行（板子 → 上位机）：UART1 发出的字节加随机比特错误 + 突发噪声（一段字节被打乱，COBS 帧 CRC 失败或被切断）
+- 下行（上位机 → 板子）：ARQ 打开命令、ACK、保活 PING 编成 link_frame() 送进 UART1 的 RX，ACK 有整帧丢失概率；
+  两个方向都有固定的 USB 延迟
+上位机每 1ms 处理一次收到的数据（与接收循环的 time.sleep(0.001) 相同）
+
+默认跑两遍：--baud 下的有损线路，以及 3M 波特、发出的帧超过 65536 个的一遍（--wrap-duration），
+后者让固件的 16 位线上序号回绕，经过 arq_unwrap() 和按发送顺序号判丢
+
+使用方法：
+python arq_sim.py [--baud 115200] [--rate 200] [--duration 30] [--ber 1e-5]
+                  [--burst-rate 0.5] [--burst-len 20] [--ack-loss 0.01] [--latency-ms 4]
+                  [--wrap-duration 30] [--wrap-rate 2500] [--seed 1]
+
+输出：交付的样本是否按序无重复、丢失 / 重复 / 重传数量（link_arq_get_stats()）、线路利用率，
+以及同样的线路上尽力而为模式会丢多少帧（第一次发送就损坏的帧数）
+"""
+
+import argparse
+import random
+import struct
+import sys
+from collections import deque
+
+import fw_host
+import generic_receiver as rx
+
+# ==================== 固件参数（与 link_arq.h / bsp_uart_channel.h / irq_dma.c 一致）====================
+FRAMING_COBS = 1                # UART_ASYNC_FRAMING_COBS
+RING_SIZE = 16                  # RING_BUFFER_SIZE
+LOOP_S = 0.001                  # 主循环 / 上位机接收循环周期
+WRAP_BAUD = 3000000
+
+# ==================== 线路 ====================
+class Line:
+    """上行噪声：每比特 ber 的随机错误 + 每秒 burst_rate 次、每次 burst_len 字节的突发（字节被换成随机值）"""
+    def __init__(self, args, rng, char_s):
+        self.rng = rng
+        self.p_err = args.ber * 8                   # 每字节出错概率（近似）
+        self.p_burst = args.burst_rate * char_s     # 每字节开始突发的概率
+        self.burst_len = args.burst_len
+        self.burst_left = 0
+        self.next_err = self._gap(self.p_err)
+        self.next_burst = self._gap(self.p_burst)
+
+    def _gap(self, p):
+        return int(self.rng.expovariate(p)) if p > 0 else float('inf')
+
+    def byte(self, b):
+        """返回线路上收到的字节"""
+        self.next_burst -= 1
+        if self.next_burst < 0 and not self.burst_left:
+            self.burst_left = self.burst_len
+            self.next_burst = self._gap(self.p_burst)
+        if self.burst_left:
+            self.burst_left -= 1
+            return self.rng.randrange(256)
+        self.next_err -= 1
+        if self.next_err < 0:
+            self.next_err = self._gap(self.p_err)
+            return b ^ (1 << self.rng.randrange(8))
+        return b
+
+# ==================== 仿真 ====================
+def make_packet(seq, timestamp):
+    """单包（sum8 校验，与 verify_packet() 默认模式一致）"""
+    body = struct.pack(rx.PACKET_FORMAT, b'\xAA\x55', seq & 0xFFFF, timestamp & 0xFFFFFFFF,
+                       0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+    return body[:-2] + bytes([sum(body[:-2]) & 0xFF, 0])
+
+class Host:
+    """上位机：串口收到的字节按 0x00 分帧，ARQ 帧交给 ArqReceiver；控制帧经 UART1 RX 发给板子"""
+    def __init__(self, uart, args, rng):
+        self.uart = uart
+        self.args = args
+        self.rng = rng
+        self.latency = args.latency_ms / 1000.0
+        self.arq = rx.ArqReceiver(rx.ARQ_WINDOW)
+        self.buffer = bytearray()
+        self.enabled = False        # 收到 ARQ 应答
+        self.line_free = 0.0        # 下行线路空闲的时刻（上一个控制帧发完）
+        self.delivered = []         # 交付的样本 seq
+        self.acks_lost = 0
+
+    def send(self, now, cmd, arg):
+        t = max(now + self.latency, self.line_free)
+        self.line_free = self.uart.rx_bytes(t, rx.link_frame(cmd, arg))
+
+    def receive(self, data, now):
+        self.buffer += data
+        while True:
+            end = self.buffer.find(b'\x00')
+            if end == -1:
+                break
+            chunk = bytes(self.buffer[:end])
+            del self.buffer[:end + 1]
+            frame = rx.cobs_decode(chunk) if chunk else None
+            if not frame or frame[0] not in rx.CHANNEL_TAGS:
+                continue
+            tag, frame = frame[0], frame[1:]
+            if tag == rx.CHANNEL_CONTROL and frame == rx.link_frame(rx.LINK_CMD_ARQ | rx.LINK_CMD_REPLY, rx.ARQ_WINDOW):
+                self.enabled = True
+            elif tag == rx.CHANNEL_TELEMETRY and frame[:2] == rx.ARQ_HEADER:
+                for payload in self.arq.receive(frame, now) or []:
+                    self.delivered.append(struct.unpack_from('<H', payload, 2)[0])
+
+    def poll(self, now):
+        for payload in self.arq.poll(now):
+            self.delivered.append(struct.unpack_from('<H', payload, 2)[0])
+        ack = self.arq.ack(now)
+        if ack is not None:
+            # ACK 帧丢了就丢了（固件靠 RTO 兜底）
+            if self.rng.random() >= self.args.ack_loss:
+                self.send(now, rx.LINK_CMD_ACK, ack)
+            else:
+                self.acks_lost += 1
+
+def simulate(args, baud, rate, duration):
+    rng = random.Random(args.seed)
+    fw = fw_host.Firmware()
+    lib = fw.lib
+    uart = fw.uart(1)
+
+    # 固件启动（irq_dma.c 的可靠模式配置），波特率直接设好（协商见 baud_sim.py），上位机按时发 PING 保活
+    lib.packet_crc_init()
+    lib.uart_async_init()
+    lib.uart_async_set_clock_hz(fw.gpt_hz)
+    if lib.uart_async_set_baud(baud) != 0:
+        raise SystemExit(f'uart_async_set_baud({baud}) 失败')
+    lib.uart_async_set_framing(FRAMING_COBS)
+    lib.uart_channel_init()
+    lib.uart_async_rx_enable(None, None)
+    lib.link_control_init()
+    lib.link_arq_init()
+
+    host = Host(uart, args, rng)
+    line = Line(args, rng, uart.char_time())
+    ring = deque()
+    ring_overflow = []                          # Ring 满丢掉的样本 seq
+    uplink = deque()                            # (上位机收到的时刻, 原字节, 线路上的字节)
+    clean = bytearray()                         # 上位机收到的原字节（统计尽力而为的损坏帧）
+    damaged = False
+    last_new = -1                               # 最近一个第一次发送的 ARQ 序号
+    first_tx_frames = first_tx_corrupt = 0
+    wire_bytes = 0
+    samples = 0
+    next_sample = next_ping = next_enable = 0.0
+
+    now = 0.0
+    steps = int(duration / LOOP_S)
+    for _ in range(steps):
+        now += LOOP_S
+        fw.run(now)
+
+        # 1. 采样（GPT1 中断）：Ring 满时丢最新
+        while next_sample <= now:
+            if len(ring) < RING_SIZE:
+                ring.append(make_packet(samples, int(next_sample * fw.gpt_hz)))
+            else:
+                ring_overflow.append(samples & 0xFFFF)
+            samples += 1
+            next_sample += 1.0 / rate
+
+        # 2. 板子主循环
+        lib.link_control_poll()
+        if lib.link_control_tx_allowed():
+            lib.uart_channel_poll()
+        if lib.link_arq_enabled():
+            n = min(lib.link_arq_window_free(), len(ring))
+            for _ in range(n):
+                if lib.link_arq_send(ring.popleft(), rx.PACKET_SIZE) != 0:
+                    raise SystemExit('link_arq_send() 在 window_free 之内失败')
+        if lib.link_control_tx_allowed():
+            lib.link_arq_poll()
+
+        # 3. 上行线路：加噪声和 USB 延迟
+        for b, _, t_end in uart.take():
+            got = line.byte(b)
+            uplink.append((t_end + host.latency, b, got))
+            wire_bytes += 1
+
+        # 4. 上位机：读串口、回 ACK；打开可靠模式（没应答就重发）、保活
+        data = bytearray()
+        while uplink and uplink[0][0] <= now:
+            _, b, got = uplink.popleft()
+            data.append(got)
+            damaged |= got != b
+            if b != 0:
+                clean.append(b)
+                continue
+            frame = rx.cobs_decode(bytes(clean)) if clean else None
+            if frame and frame[0] == rx.CHANNEL_TELEMETRY and frame[1:3] == rx.ARQ_HEADER:
+                seq = frame[3] | (frame[4] << 8)
+                if last_new < 0 or 0 < ((seq - last_new) & 0xFFFF) < 0x8000:
+                    last_new = seq                  # 新帧按序号递增发出，重传的帧序号在后面
+                    first_tx_frames += 1
+                    first_tx_corrupt += damaged
+            clean.clear()
+            damaged = False
+        host.receive(data, now)
+        if host.enabled:
+            host.poll(now)
+        elif now >= next_enable:
+            host.send(now, rx.LINK_CMD_ARQ, 1)
+            next_enable = now + 0.2
+        if baud != lib.uart_async_get_baud() or (baud != 115200 and now >= next_ping):
+            host.send(now, rx.LINK_CMD_PING, 0)
+            next_ping = now + rx.LINK_PING_INTERVAL_S
+
+    return {
+        'fw': fw,
+        'arq': fw.stats('arq', lib.link_arq_get_stats()),
+        'enabled': lib.link_arq_enabled(),
+        'host': host,
+        'samples': samples,
+        'ring_overflow': ring_overflow,
+        'first_tx_corrupt': first_tx_corrupt,
+        'first_tx_frames': first_tx_frames,
+        'wire_bytes': wire_bytes,
+        'line_bytes': duration / uart.char_time(),
+    }
+
+def check_order(delivered, overflow):
+    """交付的样本 seq 必须严格递增（16 位回绕），返回 (逆序 / 重复次数, 链路上缺失的样本数)
+    Ring 溢出丢掉的样本不算链路缺失"""
+    overflow = set(overflow)
+    disorder = missing = 0
+    for prev, cur in zip(delivered, delivered[1:]):
+        step = (cur - prev) & 0xFFFF
+        if step == 0 or step >= 0x8000:
+            disorder += 1
+            continue
+        for k in range(1, step):
+            if (prev + k) & 0xFFFF not in overflow:
+                missing += 1
+    return disorder, missing
+
+def report(result, min_frames=0):
+    arq, host = result['arq'], result['host']
+    delivered = host.delivered
+    disorder, missing = check_order(delivered, result['ring_overflow'])
+    print(f"样本:       生成 {result['samples']}，Ring 溢出 {len(result['ring_overflow'])}，交付 {len(delivered)}")
+    print(f"顺序:       逆序 / 重复 {disorder}，链路上缺失 {missing} 个样本")
+    print(f"ARQ 帧:     进窗口 {arq['frames']}，重传 {arq['retransmits']}（超时 {arq['timeouts']}），"
+          f"放弃 {arq['abandoned']}，回退 {arq['fallbacks']}，ACK {arq['acks']}，"
+          f"RTO {arq['rto'] * 1000 / result['fw'].gpt_hz:.0f}ms，窗口满 {arq['window_full']} 次")
+    print(f"上位机:     重复 {host.arq.duplicates}，跳过 {host.arq.skipped}，坏帧 {host.arq.bad_frames}，"
+          f"ACK {host.arq.acks_sent}（丢 {host.acks_lost}）")
+    print(f"线路:       利用率 {result['wire_bytes'] / result['line_bytes'] * 100:.1f}%")
+    print(f"尽力而为:   同样的线路会丢 {result['first_tx_corrupt']} 帧"
+          f"（{result['first_tx_corrupt'] / max(result['first_tx_frames'], 1) * 100:.2f}%）")
+    ok = (disorder == 0 and missing == host.arq.skipped and result['enabled'] and arq['fallbacks'] == 0 and
+          arq['frames'] >= min_frames)
+    if not result['enabled'] or arq['fallbacks']:
+        print("  可靠模式没有打开或中途回退了")
+    if arq['frames'] < min_frames:
+        print(f"  进窗口的帧不到 {min_frames}，序号没有回绕")
+    return ok
+
+def main():
+    parser = argparse.ArgumentParser(description='可靠模式有损信道仿真')
+    parser.add_argument('--baud', type=int, default=115200, help='波特率，默认 115200')
+    parser.add_argument('--rate', type=float, default=200, help='采样率（单包/s），默认 200')
+    parser.add_argument('--duration', type=float, default=30, help='仿真时长（秒），默认 30')
+    parser.add_argument('--ber', type=float, default=1e-5, help='上行误码率，默认 1e-5')
+    parser.add_argument('--burst-rate', type=float, default=0.5, help='上行突发噪声（次/秒），默认 0.5')
+    parser.add_argument('--burst-len', type=int, default=20, help='每次突发打乱的字节数，默认 20')
+    parser.add_argument('--ack-loss', type=float, default=0.01, help='ACK 丢失概率，默认 0.01')
+    parser.add_argument('--latency-ms', type=float, default=4, help='单向 USB 延迟（ms），默认 4')
+    parser.add_argument('--wrap-duration', type=float, default=30, help='序号回绕那一遍的时长（秒），0=不跑，默认 30')
+    parser.add_argument('--wrap-rate', type=float, default=2500, help='序号回绕那一遍的采样率（单包/s），默认 2500')
+    parser.add_argument('--seed', type=int, default=1, help='随机种子，默认 1')
+    args = parser.parse_args()
+
+    print(f"{args.baud} 波特，{args.rate:g} 包/s，{args.duration:g} 秒，误码率 {args.ber:g}，"
+          f"突发 {args.burst_rate:g} 次/s x {args.burst_len} 字节，ACK 丢失 {args.ack_loss:g}\n")
+    ok = report(simulate(args, args.baud, args.rate, args.duration))
+    if args.wrap_duration > 0:
+        print(f"\n序号回绕:   {WRAP_BAUD} 波特，{args.wrap_rate:g} 包/s，{args.wrap_duration:g} 秒\n")
+        ok = report(simulate(args, WRAP_BAUD, args.wrap_rate, args.wrap_duration), 0x10000) and ok
+    print("\n✅ 按序、无重复" if ok else "\n❌ 交付顺序或丢失计数不一致")
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""
+批量帧 / 压缩批量帧编解码往返测试
+
+板子侧按固件 batch_frame.c 建模（帧内 seq 连续、dt 放得进 16 位、压缩帧按最坏情况预留空间），
+上位机侧直接用 generic_receiver.py 的 decode_frame()（长度 + CRC 校验后 decode_batch / decode_delta_batch）
+样本流覆盖：安静信号、运动信号、满量程随机值（压缩最坏情况）、seq 和时间戳的 16 / 32 位回绕、
+中间丢样本（seq 缺口）、长间隔（dt 超过 16 位）
+
+使用方法：
+python batch_sim.py [--samples 20000] [--batch 16] [--seed 1]
+
+输出：每种信号 x 原始 / 压缩两种帧的帧数、每样本字节数，解码结果是否与输入逐个相同
+"""
+
+import argparse
+import math
+import random
+import struct
+import sys
+
+import generic_receiver as rx
+
+# ==================== 固件参数（与 batch_frame.h 一致）====================
+HEAD_LEN = 9                    # BATCH_FRAME_HEAD_LEN
+DELTA_HEAD_LEN = 11             # BATCH_FRAME_DELTA_HEAD_LEN
+DELTA_MAX_SAMPLE = 21           # BATCH_FRAME_DELTA_MAX_SAMPLE
+SAMPLE_LEN = 14                 # BATCH_FRAME_SAMPLE_LEN
+CRC_LEN = 2                     # BATCH_FRAME_CRC_LEN
+MAX_SAMPLES = 32                # BATCH_FRAME_MAX_SAMPLES
+MAX_LEN = HEAD_LEN + MAX_SAMPLES * SAMPLE_LEN + CRC_LEN   # BATCH_FRAME_MAX_LEN
+PERIOD_TICKS = rx.GPT1_FREQ_HZ // 1000                    # 1kHz FIFO 模式的样本间隔
+
+# ==================== 板子侧模型 ====================
+def put_varint(v):
+    out = bytearray()
+    while v >= 0x80:
+        out.append((v & 0x7F) | 0x80)
+        v >>= 7
+    out.append(v)
+    return out
+
+def zigzag32(v):
+    return ((v << 1) ^ (v >> 31)) & 0xFFFFFFFF
+
+def to_int16(v):
+    v &= 0xFFFF
+    return v - 0x10000 if v & 0x8000 else v
+
+class BatchFrame:
+    """batch_frame.c 的 Python 版本"""
+    def __init__(self, max_count, compress):
+        self.max_count = min(max(max_count, 1), MAX_SAMPLES)
+        self.compress = compress
+        self.buf = bytearray(DELTA_HEAD_LEN if compress else HEAD_LEN)
+        self.count = 0
+        self.next_seq = 0
+        self.last_ts = 0
+        self.last_dt = 0
+        self.last_axis = [0] * 6
+
+    def add(self, sample):
+        """sample = (seq, timestamp, ax, ay, az, gx, gy, gz)，0=已加入，-1=另起一帧"""
+        seq, ts, axis = sample[0], sample[1], sample[2:]
+        dt = 0
+        if self.count >= self.max_count:
+            return -1
+        if self.compress and len(self.buf) + DELTA_MAX_SAMPLE + CRC_LEN > MAX_LEN:
+            return -1
+        if self.count == 0:
+            struct.pack_into('<HI', self.buf, 3, seq, ts)
+        else:
+            dt = (ts - self.last_ts) & 0xFFFFFFFF
+            if seq != self.next_seq or dt > 0xFFFF:
+                return -1
+        if self.compress:
+            self.buf += put_varint(zigzag32(dt - self.last_dt))
+            for i in range(6):
+                self.buf += put_varint(zigzag32(to_int16(axis[i] - self.last_axis[i])))
+                self.last_axis[i] = axis[i]
+            self.last_dt = dt
+        else:
+            self.buf += struct.pack('<H6h', dt, *axis)
+        self.count += 1
+        self.next_seq = (seq + 1) & 0xFFFF
+        self.last_ts = ts
+        return 0
+
+    def finish(self):
+        if self.count == 0:
+            return b''
+        self.buf[0:3] = bytes([0xAA, 0x57 if self.compress else 0x56, self.count])
+        if self.compress:
+            struct.pack_into('<H', self.buf, 9, len(self.buf) - DELTA_HEAD_LEN)
+        crc = rx.crc16_ccitt(self.buf)
+        return bytes(self.buf) + bytes([crc >> 8, crc & 0xFF])
+
+def encode(samples, batch, compress):
+    """与 irq_dma.c 的发送循环相同：加不进去就先发出当前帧，再从这个样本开始新帧"""
+    frames = []
+    frame = BatchFrame(batch, compress)
+    for sample in samples:
+        if frame.add(sample) != 0:
+            frames.append(frame.finish())
+            frame = BatchFrame(batch, compress)
+            if frame.add(sample) != 0:
+                raise AssertionError(f'空帧拒绝样本 {sample}')
+    frames.append(frame.finish())
+    return [f for f in frames if f]
+
+# ==================== 样本流 ====================
+def make_samples(kind, n, rng):
+    seq = 0xFFFF - n // 3               # 中途 16 位回绕
+    ts = 0xFFFFFFFF - n // 2 * PERIOD_TICKS   # 中途 32 位回绕
+    samples = []
+    for i in range(n):
+        if kind == 'quiet':
+            axis = [rng.randint(-3, 3), rng.randint(-3, 3), 2048 + rng.randint(-3, 3),
+                    rng.randint(-2, 2), rng.randint(-2, 2), rng.randint(-2, 2)]
+        elif kind == 'motion':
+            a = 2 * math.pi * i / 400
+            axis = [int(12000 * math.sin(a + k)) + rng.randint(-40, 40) for k in range(6)]
+        else:
+            axis = [rng.randint(-32768, 32767) for _ in range(6)]
+        samples.append((seq, ts, *axis))
+        seq = (seq + 1) & 0xFFFF
+        ts = (ts + PERIOD_TICKS + rng.randint(-20, 20)) & 0xFFFFFFFF   # 中断延迟抖动
+        r = rng.random()
+        if r < 0.005:
+            seq = (seq + rng.randint(1, 5)) & 0xFFFF                   # 丢样本：seq 缺口
+            ts = (ts + PERIOD_TICKS) & 0xFFFFFFFF
+        elif r < 0.007:
+            ts = (ts + 0x10000 + rng.randint(0, 1000)) & 0xFFFFFFFF    # 长间隔：dt 放不进 16 位
+    return samples
+
+# ==================== 仿真 ====================
+def run(kind, samples, batch, compress):
+    frames = encode(samples, batch, compress)
+    decoded = []
+    bad = 0
+    for frame in frames:
+        if len(frame) > MAX_LEN:
+            bad += 1
+        data, single = rx.decode_frame(frame)
+        if data is None or single:
+            bad += 1
+            continue
+        decoded.extend(data)
+    ok = bad == 0 and decoded == samples
+    wire = sum(len(f) for f in frames)
+    mode = '压缩' if compress else '原始'
+    print(f"{kind:<7} {mode}: {len(frames):5d} 帧，{wire / len(samples):5.2f} 字节/样本，"
+          f"{'一致' if ok else f'不一致（坏帧 {bad}，解码 {len(decoded)} / {len(samples)}）'}")
+    return ok
+
+def main():
+    parser = argparse.ArgumentParser(description='批量帧编解码往返测试')
+    parser.add_argument('--samples', type=int, default=20000, help='每种信号的样本数，默认 20000')
+    parser.add_argument('--batch', type=int, default=16, help='每帧样本数上限（SENSOR_BATCH_DEFAULT），默认 16')
+    parser.add_argument('--seed', type=int, default=1, help='随机种子，默认 1')
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    print(f"{args.samples} 样本 / 信号，每帧最多 {args.batch} 个，单包 {rx.PACKET_SIZE} 字节/样本\n")
+    ok = True
+    for kind in ('quiet', 'motion', 'random'):
+        samples = make_samples(kind, args.samples, rng)
+        for compress in (False, True):
+            ok &= run(kind, samples, args.batch, compress)
+    print("\n✅ 往返无损" if ok else "\n❌ 解码结果与输入不一致")
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,471 @@
+#!/usr/bin/env python3
+"""
+波特率协商 / 回退仿真
+
+板子侧是编译到主机上的固件（fw_host.py）：link_control.c 的控制帧解析、SWITCHING / CONFIRM / RUNNING 状态机、
+确认超时、保活超时、RX 错误计数回退，bsp_uart_async.c 的分频计算和中断收发，UART1 接 host/sim_uart.c 的
+寄存器模型（按 UBIR / UBMR 算出的波特率发送）。主循环按 Stage 3 irq_dma.c：每 1ms link_control_poll()、
+uart_channel_poll()，200Hz 遥测（切换期间不发）。回退原因从固件的日志里取（raw：printf，COBS：日志通道）。
+上位机侧直接调用 generic_receiver.py 的 negotiate_baud()（串口和 time 换成仿真对象），
+保活 / 回退按接收循环的写法建模。两端波特率不一致时收到的是帧错误或乱码字节，噪声窗口内的字节也一样
+
+场景（raw 和 COBS 两种分帧各跑一遍）：
+- 切换到 460800 / 921600 / 3000000 并确认，之后保活、遥测正常
+- 上位机退出不再 PING：板子保活超时回退
+- 上位机的确认 PING 全部丢失：板子确认超时回退，上位机收不到有效包后也回退
+- 请求不支持的波特率：应答参数 0，不切换
+- 请求帧损坏：板子记一次 CRC 错误，上位机重试后切换成功
+- 高波特率下噪声突发：板子 RX 错误超限回退，上位机随后回退，遥测在 115200 恢复
+
+使用方法：
+python baud_sim.py [--seed 1]
+
+输出：固件写出的分频值是否与预期相同，每个场景是否通过及关键时间点
+"""
+
+import argparse
+import random
+import re
+import struct
+import sys
+from collections import deque
+
+import fw_host
+import generic_receiver as rx
+
+# ==================== 固件参数（与 link_control.h / bsp_uart_async.h / irq_dma.c 一致）====================
+REF_CLK_HZ = 80000000           # UART_ASYNC_REF_CLK_HZ
+BAUD_DEFAULT = 115200           # UART_ASYNC_BAUD_DEFAULT
+LINK_BAUDS = (115200, 460800, 921600, 3000000)
+CONFIRM_MS = 1000               # LINK_CONFIRM_MS
+KEEPALIVE_MS = 3000             # LINK_KEEPALIVE_MS
+FRAMING_COBS = 1                # UART_ASYNC_FRAMING_COBS
+CHANNEL_TELEMETRY = 1           # UART_CHANNEL_TELEMETRY
+POLL_S = 0.001                  # 主循环周期（link_control_poll）
+SAMPLE_S = 0.005                # 遥测 200Hz
+STEP_S = 0.0001                 # 仿真步长
+
+# 分频预期值（UBIR, UBMR）
+EXPECTED_DIVIDERS = {115200: (71, 3124), 460800: (287, 3124), 921600: (575, 3124), 3000000: (2, 4)}
+
+# ==================== 分频 ====================
+def check_dividers():
+    """固件 uart_async_set_baud() 写进 UBIR / UBMR 的值"""
+    fw = fw_host.Firmware()
+    lib = fw.lib
+    uart = fw.uart(1)
+    lib.uart_async_init()
+    ok = True
+    for baud in LINK_BAUDS:
+        ret = lib.uart_async_set_baud(baud)
+        ubir, ubmr = uart.reg('UBIR'), uart.reg('UBMR')
+        actual = REF_CLK_HZ * (ubir + 1) / (16 * (ubmr + 1))
+        good = ret == 0 and (ubir, ubmr) == EXPECTED_DIVIDERS[baud] and abs(actual - baud) / baud < 1e-4
+        ok &= good
+        print(f"分频 {baud:>7}: UBIR {ubir:4d} UBMR {ubmr:4d}，实际 {actual:.0f}"
+              f"{'' if good else f'（预期 {EXPECTED_DIVIDERS[baud]}）'}")
+    ok &= lib.uart_async_set_baud(REF_CLK_HZ // 16 + 1) == -2
+    return ok
+
+# ==================== 板子侧 ====================
+class Device:
+    """编译好的固件：启动到 Stage 3 主循环，记录波特率切换 / 确认 / 回退的时刻"""
+    def __init__(self, world):
+        self.world = world
+        self.fw = fw_host.Firmware()
+        self.lib = lib = self.fw.lib
+        self.uart = self.fw.uart(1)
+        self.cobs = rx.FRAMING == 'cobs'
+        lib.packet_crc_init()
+        lib.uart_async_init()
+        lib.uart_async_set_clock_hz(self.fw.gpt_hz)
+        if self.cobs:
+            lib.uart_async_set_framing(FRAMING_COBS)
+            lib.uart_channel_init()
+        lib.uart_async_rx_enable(None, None)
+        lib.link_control_init()
+        self.seq = 0
+        self.baud = BAUD_DEFAULT
+        self.stats = self.fw.stats('link', lib.link_control_get_stats())
+        self.events = []                # (时刻, 事件)
+        self.fallback_times = []
+        self.log = ''                   # 固件日志（回退原因）
+        self.log_frame = bytearray()    # COBS：线路上还没收完的一帧（发出的原样字节）
+
+    def now(self):
+        return self.fw.now()
+
+    def tx_allowed(self):
+        return bool(self.lib.link_control_tx_allowed())
+
+    def sample(self):
+        if not self.tx_allowed():
+            return
+        body = struct.pack(rx.PACKET_FORMAT, b'\xAA\x55', self.seq & 0xFFFF,
+                           self.fw.ticks(), *([0] * 6), 0, 0, 0, 0)
+        crc = rx.crc16_ccitt(body[:-2])
+        packet = body[:-2] + bytes([crc >> 8, crc & 0xFF])
+        if self.cobs:
+            ret = self.lib.uart_channel_send(CHANNEL_TELEMETRY, packet, len(packet))
+        else:
+            ret = self.lib.uart_async_send(packet, len(packet))
+        if ret == 0:
+            self.seq += 1
+
+    def poll(self):
+        self.lib.link_control_poll()
+        if self.tx_allowed():
+            self.lib.uart_channel_poll()
+
+    def take(self):
+        """线路上发出的字节 [(byte, 发送时的波特率, 发完时刻)]；COBS 下顺便收日志通道"""
+        out = []
+        for b, t_start, t_end in self.uart.take():
+            out.append((b, round(10.0 / (t_end - t_start)), t_end))
+            if not self.cobs:
+                continue
+            if b != 0:
+                self.log_frame.append(b)
+                continue
+            frame = rx.cobs_decode(bytes(self.log_frame)) if self.log_frame else None
+            if frame and frame[0] == rx.CHANNEL_LOG:
+                self.log += frame[1:].decode(errors='replace')
+            self.log_frame.clear()
+        return out
+
+    def observe(self):
+        """切换 / 确认 / 回退发生在这一步：按状态变化记时刻"""
+        now = self.now()
+        baud = self.lib.uart_async_get_baud()
+        if baud != self.baud:
+            self.baud = baud
+            self.events.append((now, f'baud {baud}'))
+        stats = self.fw.stats('link', self.lib.link_control_get_stats())
+        if stats['switches'] > self.stats['switches']:
+            self.events.append((now, 'confirm'))
+        if stats['fallbacks'] > self.stats['fallbacks']:
+            self.fallback_times.append(now)
+        self.stats = stats
+        self.log += self.fw.console()
+
+    def all_events(self):
+        """按时刻排好的事件，回退按日志里的原因命名"""
+        reasons = re.findall(r'\[LINK\] fallback to \d+ \(([^)]*)\)', self.log)
+        reasons += ['fallback'] * (len(self.fallback_times) - len(reasons))
+        return sorted(self.events + list(zip(self.fallback_times, reasons)))
+
+# ==================== 上位机侧：仿真串口 + 时钟 ====================
+class SimSerial:
+    """negotiate_baud() 用到的 serial.Serial 接口，read() 阻塞时推进仿真时间"""
+    def __init__(self, world):
+        self.world = world
+        self.baudrate = BAUD_DEFAULT
+        self.timeout = 1.0
+        self.buf = bytearray()
+        self.free_at = 0.0              # 发送线路空闲的时刻
+        self.drop = None                # 过滤器：返回 True 的写入在线路上丢失
+        self.corrupt_next = 0           # 接下来几次写入各翻转一位
+
+    @property
+    def in_waiting(self):
+        return len(self.buf)
+
+    def write(self, data):
+        data = bytearray(data)
+        if self.drop is not None and self.drop(bytes(data), self.baudrate):
+            return len(data)
+        if self.corrupt_next:
+            self.corrupt_next -= 1
+            data[3] ^= 0x10
+        t = max(self.free_at, self.world.now)
+        for b in data:
+            t += 10.0 / self.baudrate
+            self.world.to_device.append((t, b, self.baudrate))
+        self.free_at = t
+        if bytes(data) == rx.link_frame(rx.LINK_CMD_PING, 0):
+            self.world.last_ping_at = t
+        return len(data)
+
+    def read(self, size=1):
+        deadline = self.world.now + self.timeout
+        while len(self.buf) < size and self.world.now < deadline:
+            self.world.advance(STEP_S)
+        out = bytes(self.buf[:size])
+        del self.buf[:size]
+        return out
+
+    def reset_input_buffer(self):
+        self.buf.clear()
+
+class SimTime:
+    """替换 generic_receiver 里的 time 模块"""
+    def __init__(self, world):
+        self.world = world
+
+    def time(self):
+        return self.world.now
+
+    def sleep(self, seconds):
+        self.world.advance(seconds)
+
+class World:
+    def __init__(self, seed):
+        self.rng = random.Random(seed)
+        self.noise = []                 # [(起, 止)]
+        self.device = Device(self)
+        self.now = self.device.now()
+        self.ser = SimSerial(self)
+        self.to_device = deque()        # 上位机发出的字节：(收完时刻, 字节, 发送时的波特率)
+        self.last_ping_at = None        # 最后一个 PING 到达板子的时刻
+        self.next_poll = self.next_sample = self.now
+        rx.time = SimTime(self)
+
+    def noisy(self, now):
+        return any(t0 <= now < t1 for t0, t1 in self.noise)
+
+    def garble(self, byte, ok):
+        """线路两端波特率不一致 / 噪声：一半成帧错误（None），一半乱码"""
+        if ok:
+            return byte
+        if self.rng.random() < 0.5:
+            return None
+        return self.rng.randrange(256)
+
+    def advance(self, seconds):
+        dev = self.device
+        uart = dev.uart
+        end = self.now + seconds
+        while self.now < end:
+            target = min(self.now + STEP_S, end)
+            # 上位机 → 板子：到时间的字节进 UART1 的 RX
+            while self.to_device and self.to_device[0][0] <= target:
+                t, b, baud = self.to_device.popleft()
+                got = self.garble(b, baud == uart.baud() and not self.noisy(t))
+                if got is None:
+                    uart.rx(t, self.rng.randrange(256), err=True)
+                else:
+                    uart.rx(t, got)
+            if self.noisy(target) and self.rng.random() < 0.02:
+                uart.rx(target, self.rng.randrange(256), err=True)     # 空闲线路上的噪声也会产生帧错误
+            dev.fw.run(target)
+            # 板子 → 上位机
+            for b, baud, t in dev.take():
+                got = self.garble(b, baud == self.ser.baudrate and not self.noisy(t))
+                if got is not None:
+                    self.ser.buf.append(got)
+            # 板子主循环
+            self.now = dev.now()
+            if self.now >= self.next_sample:
+                dev.sample()
+                self.next_sample += SAMPLE_S
+            if self.now >= self.next_poll:
+                dev.poll()
+                self.next_poll += POLL_S
+            dev.observe()
+            self.now = dev.now()
+
+class HostLoop:
+    """接收循环里的保活 / 回退和遥测计数（generic_receiver.receive_data 的对应部分）"""
+    def __init__(self, world, negotiated, ping=True):
+        self.world = world
+        self.negotiated = negotiated
+        self.ping = ping
+        self.valid = self.errors = 0
+        self.buffer = bytearray()
+        now = world.now
+        self.last_ping = self.last_check = self.last_valid_time = now
+        self.last_valid = self.last_errors = 0
+        self.fallback_at = None
+
+    def parse(self):
+        buf = self.buffer
+        if rx.FRAMING == 'cobs':
+            while True:
+                end = buf.find(b'\x00')
+                if end == -1:
+                    break
+                chunk = bytes(buf[:end])
+                del buf[:end + 1]
+                frame = rx.cobs_decode(chunk) if chunk else None
+                if frame and frame[0] in rx.CHANNEL_TAGS:
+                    if frame[0] != rx.CHANNEL_TELEMETRY:
+                        continue            # 控制应答 / 日志
+                    frame = frame[1:]
+                if frame is not None and frame[:2] == rx.LINK_HEADER:
+                    continue
+                if frame is not None and rx.decode_frame(frame)[0] is not None:
+                    self.valid += 1
+                elif chunk:
+                    self.errors += 1
+            return
+        while len(buf) >= rx.PACKET_SIZE:
+            idx = buf.find(b'\xAA\x55')
+            if idx == -1:
+                del buf[:-1]
+                break
+            del buf[:idx]
+            if len(buf) < rx.PACKET_SIZE:
+                break
+            if rx.decode_frame(bytes(buf[:rx.PACKET_SIZE]))[0] is not None:
+                self.valid += 1
+                del buf[:rx.PACKET_SIZE]
+            else:
+                self.errors += 1
+                del buf[:1]
+
+    def run(self, seconds):
+        world, ser = self.world, self.world.ser
+        end = world.now + seconds
+        while world.now < end:
+            now = world.now
+            if self.negotiated:
+                if self.ping and now - self.last_ping >= rx.LINK_PING_INTERVAL_S:
+                    ser.write(rx.link_frame(rx.LINK_CMD_PING, 0))
+                    self.last_ping = now
+                if self.valid != self.last_valid:
+                    self.last_valid = self.valid
+                    self.last_valid_time = now
+                if now - self.last_check >= 1.0:
+                    too_many_errors = self.errors - self.last_errors > rx.LINK_FALLBACK_ERRORS
+                    self.last_errors = self.errors
+                    self.last_check = now
+                    if too_many_errors or now - self.last_valid_time > rx.LINK_FALLBACK_SILENCE_S:
+                        ser.baudrate = BAUD_DEFAULT
+                        self.buffer.clear()
+                        self.negotiated = False
+                        self.fallback_at = now
+            if ser.in_waiting:
+                self.buffer.extend(ser.read(ser.in_waiting))
+            self.parse()
+            world.advance(POLL_S)
+
+# ==================== 场景 ====================
+def first_event(device, name, after=0.0):
+    for t, event in device.all_events():
+        if event == name and t >= after:
+            return t
+    return None
+
+def settle(world):
+    """上电后先跑一会儿，遥测在 115200 下正常"""
+    HostLoop(world, False).run(0.2)
+
+def baud_of(dev):
+    return dev.lib.uart_async_get_baud()
+
+def case_switch(seed, target):
+    world = World(seed)
+    settle(world)
+    t0 = world.now
+    ok = rx.negotiate_baud(world.ser, target)
+    host = HostLoop(world, ok)
+    host.run(5.0)
+    dev = world.device
+    confirmed = first_event(dev, 'confirm')
+    passed = (ok and baud_of(dev) == target and dev.tx_allowed() and world.ser.baudrate == target and
+              dev.stats['switches'] == 1 and dev.stats['fallbacks'] == 0 and host.valid > 900 and
+              host.fallback_at is None)
+    detail = f"确认 {(confirmed - t0) * 1000:.0f}ms，有效包 {host.valid}" if confirmed else "未确认"
+    return passed, detail
+
+def case_keepalive(seed):
+    world = World(seed)
+    settle(world)
+    rx.negotiate_baud(world.ser, 921600)
+    HostLoop(world, True).run(2.0)
+    HostLoop(world, True, ping=False).run(4.0)      # 上位机退出：不再 PING
+    dev = world.device
+    t = first_event(dev, 'keepalive timeout')
+    last = world.last_ping_at
+    passed = (t is not None and baud_of(dev) == BAUD_DEFAULT and dev.stats['fallbacks'] == 1 and
+              KEEPALIVE_MS / 1000 < t - last < KEEPALIVE_MS / 1000 + 0.01)
+    return passed, f"最后一次 PING 后 {t - last:.3f}s 回退" if t else "没有回退"
+
+def case_no_confirm(seed):
+    world = World(seed)
+    settle(world)
+    world.ser.drop = lambda data, baud: baud != BAUD_DEFAULT     # 新波特率下的 PING 全部丢失
+    ok = rx.negotiate_baud(world.ser, 921600)
+    host = HostLoop(world, ok)
+    host.run(1.5)
+    world.ser.drop = None
+    host.run(3.5)
+    dev = world.device
+    switched = first_event(dev, 'baud 921600')
+    t = first_event(dev, 'no confirm')
+    # 固件在 link_control_poll() 开头取 now，等 ACK 发完才换分频，所以计时起点比观察到的切换早一点
+    passed = (t is not None and switched is not None and
+              CONFIRM_MS / 1000 - POLL_S < t - switched < CONFIRM_MS / 1000 + 0.01 and
+              dev.stats['switches'] == 0 and baud_of(dev) == BAUD_DEFAULT and
+              world.ser.baudrate == BAUD_DEFAULT and host.fallback_at is not None)
+    valid = host.valid
+    host.run(1.0)
+    passed &= host.valid > valid + 150
+    detail = (f"切换后 {t - switched:.3f}s 回退，上位机 {host.fallback_at - switched:.2f}s 回退"
+              if t and host.fallback_at else "没有回退")
+    return passed, detail
+
+def case_unsupported(seed):
+    world = World(seed)
+    settle(world)
+    ok = rx.negotiate_baud(world.ser, 230400)
+    HostLoop(world, ok).run(1.0)
+    dev = world.device
+    passed = (not ok and dev.stats['rejects'] == 1 and baud_of(dev) == BAUD_DEFAULT and
+              world.ser.baudrate == BAUD_DEFAULT and dev.tx_allowed())
+    return passed, f"应答 0，rejects {dev.stats['rejects']}"
+
+def case_corrupt(seed):
+    world = World(seed)
+    settle(world)
+    world.ser.corrupt_next = 1
+    ok = rx.negotiate_baud(world.ser, 921600)
+    HostLoop(world, ok).run(2.0)
+    dev = world.device
+    passed = (ok and dev.stats['bad_frames'] == 1 and dev.stats['switches'] == 1 and
+              baud_of(dev) == 921600 and dev.stats['fallbacks'] == 0)
+    return passed, f"bad_frames {dev.stats['bad_frames']}，重试后切换"
+
+def case_noise(seed):
+    world = World(seed)
+    settle(world)
+    ok = rx.negotiate_baud(world.ser, 921600)
+    host = HostLoop(world, ok)
+    host.run(2.0)
+    t0 = world.now
+    world.noise.append((t0, t0 + 1.5))
+    host.run(6.0)
+    dev = world.device
+    t = first_event(dev, 'rx errors', t0)
+    passed = (t is not None and baud_of(dev) == BAUD_DEFAULT and world.ser.baudrate == BAUD_DEFAULT and
+              host.fallback_at is not None)
+    valid = host.valid
+    host.run(1.0)
+    passed &= host.valid > valid + 150
+    detail = (f"噪声后 {t - t0:.2f}s 板子回退，{host.fallback_at - t0:.2f}s 上位机回退"
+              if t and host.fallback_at else "没有回退")
+    return passed, detail
+
+def main():
+    parser = argparse.ArgumentParser(description='波特率协商 / 回退仿真')
+    parser.add_argument('--seed', type=int, default=1, help='随机种子，默认 1')
+    args = parser.parse_args()
+
+    rx.CHECK_MODE = 'crc16'
+    rx.print = lambda *a, **k: None     # negotiate_baud() 的提示信息不打印
+    ok = check_dividers()
+    cases = [(f'切换 {b}', lambda s, b=b: case_switch(s, b)) for b in LINK_BAUDS[1:]]
+    cases += [('保活超时', case_keepalive), ('确认超时', case_no_confirm),
+              ('不支持的波特率', case_unsupported), ('请求帧损坏', case_corrupt), ('噪声突发', case_noise)]
+    for framing in ('raw', 'cobs'):
+        rx.FRAMING = framing
+        print(f"\n{framing}:")
+        for name, case in cases:
+            passed, detail = case(args.seed)
+            ok &= passed
+            print(f"  {name:<12} {'通过' if passed else '失败'}  {detail}")
+    print("\n✅ 切换、确认和各种回退路径都符合预期" if ok else "\n❌ 协商或回退行为不符合预期")
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+"""
+COBS 分帧损坏 / 重同步测试
+
+编码端是编译到主机上的固件（fw_host.py）：bsp_uart_async.c 的 cobs_encode() 经 uart_async_send()
+（COBS 帧格式）和 uart_channel_send()（带通道标签）编码，从 host/sim_uart.c 的 UART1 模型取回线路上的字节
+1. 编解码：随机负载（含连续 0x00、254 / 255 字节无零长段、装满一个描述符）由固件编码，
+   generic_receiver.py 的 cobs_decode 必须还原（带标签的还原成标签 + 负载），且与 Python cobs_encode 逐字节相同
+2. 损坏：一串单包 + 批量帧由固件编码成字节流，随机翻转比特、丢字节、插入字节，
+   再按 generic_receiver.py 接收循环的方式以 0x00 分帧、cobs_decode + decode_frame 校验
+   - 没有被波及的帧（自身字节和前一个分隔符都完好）必须全部收到：损坏只影响到下一个 0x00
+   - 收到的帧必须都是原样发出的帧（CRC-16 把关，不会把坏帧当成好帧交付）
+
+使用方法：
+python cobs_sim.py [--frames 20000] [--flip 2e-4] [--drop 1e-4] [--insert 1e-4] [--seed 1]
+
+输出：编解码往返失败数，注入的损坏次数、丢失的帧数（每次损坏平均波及几帧）、误收的帧数
+"""
+
+import argparse
+import random
+import struct
+import sys
+
+import fw_host
+import generic_receiver as rx
+
+PERIOD_TICKS = rx.GPT1_FREQ_HZ // 20        # 50ms 采样周期
+
+# ==================== 固件参数（与 bsp_uart_async.h / bsp_uart_channel.h 一致）====================
+FRAMING_COBS = 1                # UART_ASYNC_FRAMING_COBS
+TX_BUFFER_SIZE = 512            # UART_ASYNC_TX_BUFFER_SIZE
+PAYLOAD_MAX = max(n for n in range(TX_BUFFER_SIZE) if n + n // 254 + 2 <= TX_BUFFER_SIZE)  # UART_ASYNC_COBS_LEN(n) 装得进一个描述符
+CHANNELS = (0, 1, 2)            # UART_CHANNEL_CONTROL / TELEMETRY / LOG
+BAUD = 3000000                  # 编码和波特率无关，用最高的波特率让仿真时钟走得少
+
+# ==================== 固件编码 ====================
+class Encoder:
+    """固件的 cobs_encode()：uart_async_send() / uart_channel_send() 入队，从 UART1 取回线路上的字节"""
+    def __init__(self):
+        self.fw = fw_host.Firmware()
+        self.lib = self.fw.lib
+        self.uart = self.fw.uart(1)
+        self.lib.uart_async_init()
+        self.lib.uart_async_set_clock_hz(self.fw.gpt_hz)
+        self.lib.uart_async_set_baud(BAUD)
+        self.lib.uart_async_set_framing(FRAMING_COBS)
+        self.lib.uart_channel_init()
+        self.uart.take()                    # 丢掉启动日志
+
+    def _send(self, fn):
+        while True:
+            ret = fn()
+            if ret == 0:
+                return
+            if ret != -1:
+                raise SystemExit(f'固件发送失败，ret={ret}')
+            self.fw.run(self.fw.now() + 0.0005)     # 描述符都在用：等发出去
+
+    def flush(self):
+        """等队列和 FIFO 发空，返回线路上的字节"""
+        while self.lib.uart_async_is_busy() or self.uart.tx_pending():
+            self.fw.run(self.fw.now() + 0.0005)
+        return bytes(b for b, _, _ in self.uart.take())
+
+    def send(self, data):
+        self._send(lambda: self.lib.uart_async_send(data, len(data)))
+
+    def send_channel(self, ch, data):
+        self._send(lambda: self.lib.uart_channel_send(ch, data, len(data)))
+
+# ==================== 帧 ====================
+def make_packet(seq, rng):
+    """单包，CRC-16 模式（PACKET_CHECK_MODE=1）"""
+    axis = [rng.choice((0, 0x55AA, rng.randint(-32768, 32767))) for _ in range(6)]  # 0x55AA：假包头
+    body = struct.pack(rx.PACKET_FORMAT, b'\xAA\x55', seq & 0xFFFF, (seq * PERIOD_TICKS) & 0xFFFFFFFF,
+                       *axis, 0, 0, 0, 0)
+    crc = rx.crc16_ccitt(body[:-2])
+    return body[:-2] + bytes([crc >> 8, crc & 0xFF])
+
+def make_batch(seq, count):
+    """批量帧（0xAA 0x56），样本全零：大量 0x00 让 COBS 块最短"""
+    head = struct.pack(rx.BATCH_HEAD_FORMAT, rx.BATCH_HEADER, count, seq & 0xFFFF,
+                       (seq * PERIOD_TICKS) & 0xFFFFFFFF)
+    body = head + bytes(count * rx.BATCH_SAMPLE_LEN)
+    crc = rx.crc16_ccitt(body)
+    return body + bytes([crc >> 8, crc & 0xFF])
+
+# ==================== 测试 ====================
+def check_codec(enc, rng):
+    """编解码往返，返回 (失败次数, 与 Python 编码不同的次数)"""
+    fails = differs = 0
+    payloads = [b'\x00', b'\x00\x00', bytes(range(1, 255)), bytes(range(1, 256)),
+                bytes([1]) * 254 + b'\x00', bytes([1]) * PAYLOAD_MAX, bytes(PAYLOAD_MAX)]
+    for _ in range(2000):
+        n = rng.randint(1, PAYLOAD_MAX)
+        payloads.append(bytes(rng.choice((0, rng.randint(1, 255))) for _ in range(n)))
+    for k, data in enumerate(payloads):
+        if k % 2 and len(data) < PAYLOAD_MAX:
+            ch = rng.choice(CHANNELS)
+            enc.send_channel(ch, data)
+            expect = bytes([rx.CHANNEL_TAGS[ch]]) + data
+        else:
+            enc.send(data)
+            expect = data
+        encoded = enc.flush()
+        if 0 in encoded[:-1] or encoded[-1:] != b'\x00' or rx.cobs_decode(encoded[:-1]) != expect:
+            fails += 1
+        elif encoded != rx.cobs_encode(expect):
+            differs += 1
+    return fails, differs
+
+def corrupt(stream, args, rng):
+    """逐字节注入错误，返回 (损坏后的字节流, 每个原始字节是否被波及, 损坏次数)"""
+    out = bytearray()
+    hit = [False] * len(stream)
+    events = 0
+    for i, b in enumerate(stream):
+        r = rng.random()
+        if r < args.flip:
+            out.append(b ^ (1 << rng.randrange(8)))
+        elif r < args.flip + args.drop:
+            pass
+        elif r < args.flip + args.drop + args.insert:
+            out.append(b)
+            out.append(rng.randrange(256))
+        else:
+            out.append(b)
+            continue
+        hit[i] = True
+        events += 1
+    return bytes(out), hit, events
+
+def simulate(enc, args):
+    rng = random.Random(args.seed)
+    rx.CHECK_MODE = 'crc16'
+
+    frames = []
+    seq = 0
+    while len(frames) < args.frames:
+        if rng.random() < 0.2:
+            count = rng.randint(1, 32)
+            frames.append(make_batch(seq, count))
+            seq += count
+        else:
+            frames.append(make_packet(seq, rng))
+            seq += 1
+
+    # 固件编码的字节流和每帧在流中的范围（含结尾 0x00）：每帧恰好一个 0x00
+    for frame in frames:
+        enc.send(frame)
+    stream = enc.flush()
+    spans = []
+    start = 0
+    for end, b in enumerate(stream):
+        if b == 0:
+            spans.append((start, end + 1))
+            start = end + 1
+    if len(spans) != len(frames):
+        raise SystemExit(f'固件编码的字节流有 {len(spans)} 个分隔符，发出 {len(frames)} 帧')
+
+    damaged, hit, events = corrupt(bytes(stream), args, rng)
+
+    # 上位机：与接收循环相同，按 0x00 分帧，每帧独立校验
+    received = []
+    buf = bytearray(damaged)
+    while True:
+        end = buf.find(b'\x00')
+        if end == -1:
+            break
+        chunk = bytes(buf[:end])
+        del buf[:end + 1]
+        frame = rx.cobs_decode(chunk) if chunk else None
+        if frame is not None and rx.decode_frame(frame)[0] is not None:
+            received.append(frame)
+
+    # 没被波及的帧：自身字节完好，且前一帧的分隔符完好（否则两帧粘在一起）
+    clean = []
+    for k, (start, end) in enumerate(spans):
+        if any(hit[start:end]) or (start > 0 and hit[start - 1]):
+            continue
+        clean.append(frames[k])
+
+    sent = set(frames)
+    got = set(received) & sent
+    false_accepts = sum(1 for f in received if f not in sent)
+    missing_clean = sum(1 for f in clean if f not in got)
+    return {
+        'frames': len(frames),
+        'bytes': len(stream),
+        'events': events,
+        'received': len(received),
+        'lost': len(frames) - len(got),
+        'missing_clean': missing_clean,
+        'false_accepts': false_accepts,
+    }
+
+def main():
+    parser = argparse.ArgumentParser(description='COBS 分帧损坏 / 重同步测试')
+    parser.add_argument('--frames', type=int, default=20000, help='帧数，默认 20000')
+    parser.add_argument('--flip', type=float, default=2e-4, help='每字节翻转一位的概率，默认 2e-4')
+    parser.add_argument('--drop', type=float, default=1e-4, help='每字节丢失的概率，默认 1e-4')
+    parser.add_argument('--insert', type=float, default=1e-4, help='每字节后插入一个随机字节的概率，默认 1e-4')
+    parser.add_argument('--seed', type=int, default=1, help='随机种子，默认 1')
+    args = parser.parse_args()
+
+    enc = Encoder()
+    codec_fails, codec_differs = check_codec(enc, random.Random(args.seed))
+    print(f"编解码:     固件编码 → cobs_decode 往返失败 {codec_fails}，与 Python cobs_encode 不同 {codec_differs}")
+
+    r = simulate(enc, args)
+    print(f"字节流:     {r['frames']} 帧，{r['bytes']} 字节，注入损坏 {r['events']} 次")
+    print(f"接收:       收到 {r['received']}，丢失 {r['lost']}"
+          f"（每次损坏 {r['lost'] / max(r['events'], 1):.2f} 帧）")
+    print(f"重同步:     未被波及却没收到的帧 {r['missing_clean']}，误收 {r['false_accepts']}")
+    ok = codec_fails == 0 and codec_differs == 0 and r['missing_clean'] == 0 and r['false_accepts'] == 0
+    print("\n✅ 损坏只影响到下一个分隔符" if ok else "\n❌ 编解码或重同步失败")
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
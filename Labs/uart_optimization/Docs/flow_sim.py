@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""
+RTS/CTS 硬件流控仿真
+
+板子侧是编译到主机上的固件（fw_host.py）：bsp_uart_async.c 的 uart_async_set_flow_control()、
+RTS 变化中断里的暂停 / 恢复、描述符发送、uart_async_get_stats() 的暂停时间、uart_async_wait_complete() 的超时，
+UART1 接 host/sim_uart.c 的寄存器模型（UCR2.IRTS = 0 时 RTS_B 无效发送器停在字符边界）。
+主循环按 Stage 3 irq_dma.c：采样中断进 16 槽 Ring（满时丢最新，记 overflow），每 1ms 把 Ring 里的包
+批量交给空闲描述符
+上位机是带 256 字节缓冲区的 USB 串口：按随机间隔读走数据，偶尔长时间不读，
+缓冲区到高水位撤销 RTS、降到低水位重新给出 RTS，收到的字节按 generic_receiver.py 的 decode_frame() 校验
+
+使用方法：
+python flow_sim.py [--duration 3] [--baud 921600] [--rate 2000] [--stall-rate 5] [--stall-ms 30] [--seed 1]
+
+输出：包是否全部完整按序（丢的只有 Ring 溢出计数的那些）、暂停次数和时间（固件统计值与 RTS 实际无效时间对比，
+随时读取都包含正在进行的暂停）、暂停期间的 UART 中断次数、wait_complete() 在暂停 / 正常时的结果
+"""
+
+import argparse
+import random
+import struct
+import sys
+from collections import deque
+
+import fw_host
+import generic_receiver as rx
+
+# ==================== 固件参数（与 bsp_uart_async.h / irq_ringbuffer.h 一致）====================
+TX_QUEUE_DEPTH = 4              # UART_ASYNC_TX_QUEUE_DEPTH
+TX_BUFFER_SIZE = 512            # UART_ASYNC_TX_BUFFER_SIZE
+WAIT_TIMEOUT_MS = 500           # UART_ASYNC_WAIT_TIMEOUT_MS
+RING_SIZE = 16                  # RING_BUFFER_SIZE
+LOOP_S = 0.001                  # 主循环周期
+STATS_S = 0.007                 # 主循环读统计的间隔（和暂停错开）
+
+# 上位机 USB 串口
+HOST_BUFFER = 256
+HOST_HIGH = 192                 # 到这里撤销 RTS
+HOST_LOW = 64                   # 降到这里重新给出 RTS
+STEP_CHARS = 2                  # 仿真步长（字符时间）：上位机按这个粒度看缓冲区
+
+# ==================== 仿真 ====================
+def make_packet(seq, ticks):
+    body = struct.pack(rx.PACKET_FORMAT, b'\xAA\x55', seq & 0xFFFF, ticks & 0xFFFFFFFF,
+                       *([seq & 0x7FFF] * 6), 0, 0, 0, 0)
+    crc = rx.crc16_ccitt(body[:-2])
+    return body[:-2] + bytes([crc >> 8, crc & 0xFF])
+
+class Board:
+    """固件 + Stage 3 主循环里的采样 Ring"""
+    def __init__(self, baud):
+        self.fw = fw_host.Firmware()
+        self.lib = lib = self.fw.lib
+        self.uart = self.fw.uart(1)
+        lib.uart_async_init()
+        lib.uart_async_set_clock_hz(self.fw.gpt_hz)
+        lib.uart_async_set_baud(baud)
+        self.uart.set_rts(True)
+        lib.uart_async_set_flow_control(1)
+        self.ring = deque()
+        self.generated = self.overflow = 0
+        self.dropped = set()
+
+    def sample(self):
+        """采样中断：进 Ring，满了丢最新"""
+        if len(self.ring) < RING_SIZE:
+            self.ring.append(self.generated)
+        else:
+            self.overflow += 1
+            self.dropped.add(self.generated)
+        self.generated += 1
+
+    def loop(self):
+        """主循环：有空闲描述符就把 Ring 里的包一次交出去"""
+        while self.ring and self.lib.uart_async_tx_free() > 0:
+            n = min(len(self.ring), TX_BUFFER_SIZE // rx.PACKET_SIZE)
+            data = b''.join(make_packet(self.ring.popleft(), self.fw.ticks()) for _ in range(n))
+            if self.lib.uart_async_send(data, len(data)) != 0:
+                raise AssertionError('tx_free() > 0 但 uart_async_send() 失败')
+
+    def stats(self):
+        return self.fw.stats('uart', self.lib.uart_async_get_stats())
+
+    def idle(self):
+        return not self.lib.uart_async_is_busy() and self.uart.tx_pending() == 0
+
+def simulate(args):
+    rng = random.Random(args.seed)
+    board = Board(args.baud)
+    fw, uart = board.fw, board.uart
+    gpt_hz = fw.gpt_hz
+    step = STEP_CHARS * uart.char_time()
+
+    host_buf = 0
+    host_bytes = bytearray()
+    rts = True
+    rts_low_s = 0.0                 # RTS 实际无效的时间（已结束的暂停）
+    low_since = 0.0
+    irqs_at_pause = 0
+    irqs_paused = 0                 # 暂停期间进 UART 中断的次数（RTS 变化中断本身不算）
+    start = fw.now()
+    next_sample = next_loop = next_stats = next_read = start
+    end = start + args.duration
+
+    stat_checks = stat_bad = 0
+    mid_pause_checks = 0
+    last_reported = 0
+    max_err = 0
+
+    while fw.now() < end:
+        fw.run(fw.now() + step)
+        now = fw.now()
+
+        while now >= next_sample:
+            board.sample()
+            next_sample += 1.0 / args.rate
+        if now >= next_loop:
+            board.loop()
+            next_loop += LOOP_S
+        if now >= next_stats:
+            # 随时读统计：和 RTS 实际无效时间比，误差不超过每次暂停两端各几个 tick（中断里读时钟）
+            stats = board.stats()
+            now = fw.now()
+            reported = stats['tx_throttled_ticks']
+            truth = (rts_low_s + (0 if rts else now - low_since)) * gpt_hz
+            err = abs(reported - truth)
+            max_err = max(max_err, err)
+            stat_checks += 1
+            if stats['tx_throttled']:
+                mid_pause_checks += 1
+            if (err > (stats['tx_throttle_events'] + 1) * 4 or reported < last_reported or
+                    bool(stats['tx_throttled']) == rts):
+                stat_bad += 1
+            last_reported = reported
+            next_stats += STATS_S
+
+        # 发送器移出的字节进上位机缓冲区
+        got = uart.take()
+        host_bytes.extend(b for b, _, _ in got)
+        host_buf += len(got)
+        if host_buf > HOST_BUFFER:
+            raise AssertionError('上位机缓冲区溢出：RTS 撤销后发送器没有停下')
+
+        # 上位机：随机间隔读走缓冲区，偶尔长时间不读
+        if now >= next_read:
+            host_buf = 0
+            gap_s = rng.uniform(0.001, 0.004)
+            if rng.random() < args.stall_rate * 0.0025:
+                gap_s = args.stall_ms / 1000 * rng.uniform(0.5, 1.5)
+            next_read = now + gap_s
+        if rts and host_buf >= HOST_HIGH:
+            rts = False
+            low_since = fw.now()
+            uart.set_rts(False)         # 自动模式：RTS 变化中断立刻进入
+            irqs_at_pause = uart.irq_count()
+        elif not rts and host_buf <= HOST_LOW:
+            irqs_paused += uart.irq_count() - irqs_at_pause
+            rts = True
+            rts_low_s += fw.now() - low_since
+            uart.set_rts(True)
+
+    # 收尾：RTS 给出，把剩下的发完
+    if not rts:
+        irqs_paused += uart.irq_count() - irqs_at_pause
+        rts_low_s += fw.now() - low_since
+        uart.set_rts(True)
+    while board.ring or not board.idle():
+        board.loop()
+        fw.run(fw.now() + LOOP_S)
+        host_bytes.extend(b for b, _, _ in uart.take())
+    stats = board.stats()
+
+    return {
+        'board': board,
+        'stats': stats,
+        'host_bytes': bytes(host_bytes),
+        'rts_low_s': rts_low_s,
+        'irqs_paused': irqs_paused,
+        'stat_checks': stat_checks,
+        'stat_bad': stat_bad,
+        'mid_pause_checks': mid_pause_checks,
+        'max_err_us': max_err * 1e6 / gpt_hz,
+        'wait_paused': check_wait_paused(board),
+        'wait_full': check_wait_full(board),
+    }
+
+def check_wait_paused(board):
+    """RTS 无效时 wait_complete() 在 UART_ASYNC_WAIT_TIMEOUT_MS 后放弃：返回 (结果, 等了多少秒)"""
+    fw, lib, uart = board.fw, board.lib, board.uart
+    uart.set_rts(False)
+    data = make_packet(0, 0)
+    lib.uart_async_send(data, len(data))
+    t0 = fw.now()
+    ret = lib.uart_async_wait_complete()
+    waited = fw.now() - t0
+    uart.set_rts(True)
+    while not board.idle():
+        fw.run(fw.now() + LOOP_S)
+    uart.take()
+    return ret, waited
+
+def check_wait_full(board):
+    """115200 下 4 个满描述符 + FIFO 能在超时前发完：返回 (结果, 等了多少秒)"""
+    fw, lib, uart = board.fw, board.lib, board.uart
+    lib.uart_async_set_baud(115200)
+    data = bytes(TX_BUFFER_SIZE)
+    for _ in range(TX_QUEUE_DEPTH):
+        lib.uart_async_send(data, len(data))
+    t0 = fw.now()
+    ret = lib.uart_async_wait_complete()
+    waited = fw.now() - t0
+    uart.take()
+    return ret, waited
+
+def report(r):
+    rx.CHECK_MODE = 'crc16'
+    board, stats = r['board'], r['stats']
+    gpt_hz = board.fw.gpt_hz
+    data = r['host_bytes']
+    seqs = []
+    torn = 0
+    for i in range(0, len(data) - len(data) % rx.PACKET_SIZE, rx.PACKET_SIZE):
+        packet, _ = rx.decode_frame(data[i:i + rx.PACKET_SIZE])
+        if packet is None:
+            torn += 1
+        else:
+            seqs.append(packet[1])
+    expected = [s & 0xFFFF for s in range(board.generated) if s not in board.dropped]
+    events = stats['tx_throttle_events']
+    print(f"包:         生成 {board.generated}，收到 {len(seqs)}，Ring 溢出 {board.overflow}，"
+          f"损坏 {torn}，多余字节 {len(data) % rx.PACKET_SIZE}")
+    print(f"暂停:       {events} 次，统计 {stats['tx_throttled_ticks'] / gpt_hz * 1000:.1f}ms / "
+          f"RTS 实际无效 {r['rts_low_s'] * 1000:.1f}ms，暂停期间 UART 中断 {r['irqs_paused']} 次")
+    print(f"随时读统计: {r['stat_checks']} 次（其中暂停中 {r['mid_pause_checks']} 次），"
+          f"最大偏差 {r['max_err_us']:.1f}us，超出误差、倒退或暂停状态不对 {r['stat_bad']} 次")
+    wp, wf = r['wait_paused'], r['wait_full']
+    print(f"wait_complete: 暂停中 → {wp[0]}（{wp[1] * 1000:.0f}ms 后返回），"
+          f"115200 下 {TX_QUEUE_DEPTH} 个满描述符 → {wf[0]}（{wf[1] * 1000:.0f}ms），超时 {WAIT_TIMEOUT_MS}ms")
+
+    ok = (torn == 0 and len(data) % rx.PACKET_SIZE == 0 and seqs == expected and
+          r['stat_bad'] == 0 and r['mid_pause_checks'] > 0 and
+          r['irqs_paused'] <= events and
+          wp[0] == -1 and abs(wp[1] - WAIT_TIMEOUT_MS / 1000) < 0.002 and
+          wf[0] == 0 and wf[1] < WAIT_TIMEOUT_MS / 1000)
+    if seqs != expected:
+        print("  收到的序号与生成减去 Ring 溢出不一致")
+    if events == 0:
+        print("  没有发生暂停，调大 --rate 或 --stall-rate")
+        ok = False
+    return ok
+
+def main():
+    parser = argparse.ArgumentParser(description='RTS/CTS 硬件流控仿真')
+    parser.add_argument('--duration', type=float, default=3, help='仿真时长（秒），默认 3')
+    parser.add_argument('--baud', type=int, default=921600, help='波特率，默认 921600')
+    parser.add_argument('--rate', type=int, default=2000, help='采样率（包/秒），默认 2000')
+    parser.add_argument('--stall-rate', type=float, default=5, help='上位机长时间不读的次数/秒（约），默认 5')
+    parser.add_argument('--stall-ms', type=float, default=30, help='长时间不读的平均时长（ms），默认 30')
+    parser.add_argument('--seed', type=int, default=1, help='随机种子，默认 1')
+    args = parser.parse_args()
+
+    print(f"{args.baud} 波特，{args.rate} 包/秒，{args.duration:g} 秒，上位机缓冲区 {HOST_BUFFER} 字节"
+          f"（{HOST_HIGH} 撤销 RTS / {HOST_LOW} 恢复）\n")
+    ok = report(simulate(args))
+    print("\n✅ 流控下无撕裂、无线路丢包，暂停时间随时准确" if ok else "\n❌ 流控行为不符合预期")
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,297 @@
+#!/usr/bin/env python3
+"""
+固件主机仿真：把 Stage 3 的链路代码原样编译成共享库，用 ctypes 驱动
+
+编译的固件源码：bsp_uart_async.c、bsp_uart_channel.c、link_control.c、link_arq.c、link_stripe.c、
+packet_crc.c（Stage 1），加上 host/ 下的 UART 寄存器模型 sim_uart.c 和固件侧替身 sim_fw.c（baseline.c 的函数、统计字段表）。
+板子上的外设头文件换成 host/ 下的替身（imx6ul/、stdio/include/、bsp/int/、bsp/uart/bsp_uart.h），
+baseline.h 引用、链路代码用不到的 BSP 头文件生成空文件。固件只通过 bsp_uart_async.h / link_control.h
+里的钩子（UART_ASYNC_NOW / UART_ASYNC_READ_RXD / ...）接到模型上，见 host/sim_uart.h。
+
+    import fw_host
+    fw = fw_host.Firmware()             # 编译（约 1 秒）+ 加载，sim_reset()
+    fw.lib.uart_async_init()
+    uart1 = fw.uart(1)
+    uart1.rx_bytes(fw.now(), b'...')    # 上位机发来的字节
+    fw.run(fw.now() + 0.01)             # 推进仿真时钟，期间的中断自动进入
+    data = uart1.take()                 # 板子发出的字节 [(byte, t_start, t_end), ...]
+    fw.stats('uart', fw.lib.uart_async_get_stats())
+
+需要 gcc；各仿真脚本（rx_sim.py / stripe_sim.py / ...）都用它
+"""
+
+import ctypes
+import os
+import shutil
+import subprocess
+import tempfile
+from ctypes import POINTER, c_char_p, c_double, c_int, c_uint8, c_uint16, c_uint32, c_void_p
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(HERE)
+STAGE1 = os.path.join(ROOT, 'Stage1 Polling Baseline')
+STAGE3 = os.path.join(ROOT, 'Stage3 Async DMA UART')
+
+# 构建目录里的位置 → 源文件，保持固件里的相对 include 路径
+SOURCES = {
+    'project': [os.path.join(STAGE1, f) for f in ('baseline.h', 'packet_crc.h', 'packet_crc.c')] +
+               [os.path.join(STAGE3, f) for f in ('batch_frame.h', 'link_control.h', 'link_control.c',
+                                                  'link_arq.h', 'link_arq.c', 'link_stripe.h', 'link_stripe.c')],
+    'bsp/uart': [os.path.join(STAGE3, 'bsp-uart', f) for f in ('bsp_uart_async.h', 'bsp_uart_async.c',
+                                                               'bsp_uart_channel.h', 'bsp_uart_channel.c')],
+    'bsp/timebase': [os.path.join(STAGE3, 'bsp-timebase', 'bsp_timebase.h')],
+}
+SHIMS = ('imx6ul', 'stdio', 'bsp')
+SIM_SOURCES = ('sim_uart.h', 'sim_uart.c', 'sim_fw.c')
+
+# baseline.h 引用、仿真用不到的 BSP 头文件
+EMPTY_HEADERS = ('led/bsp_led.h', 'delay/bsp_delay.h', 'clk/bsp_clk.h', 'beep/bsp_beep.h', 'key/bsp_key.h',
+                 'exit/bsp_exit.h', 'epittimer/bsp_epittimer.h', 'key_filter/bsp_keyfilter.h',
+                 'lcd/bsp_lcd.h', 'lcd/bsp_lcdapi.h', 'rtc/bsp_rtc.h', 'ap3216c/bsp_ap3216c.h',
+                 'icm20608/bsp_icm20608.h')
+
+CFLAGS = ['-std=gnu99', '-O2', '-fPIC', '-shared', '-fno-toplevel-reorder', '-Wl,-z,defs']
+
+GPT1_HZ = 645000                # 仿真里 GPT1 的频率（固件按 uart_async_set_clock_hz() / timebase_rate_hz() 换算）
+DONE_FUNC = ctypes.CFUNCTYPE(None, c_void_p, c_uint32)     # uart_async_done_t（调用者保留引用直到传输完成）
+URXD_ERR = (1 << 14) | (1 << 12)
+# UART_Type 里 UCR1 之后的寄存器（偏移 0x80 起，每个 4 字节）
+UART_REGS = ('UCR1', 'UCR2', 'UCR3', 'UCR4', 'UFCR', 'USR1', 'USR2', 'UESC', 'UTIM', 'UBIR', 'UBMR',
+             'UBRC', 'ONEMS', 'UTS', 'UMCR')
+
+# ==================== 函数原型 ====================
+# 名字 → (返回类型, 参数类型)；固件函数按 .h 声明
+PROTOTYPES = {
+    # 模型
+    'sim_reset': (None, [c_uint32, c_uint32]),
+    'sim_set_verbose': (None, [c_int]),
+    'sim_console_take': (c_uint32, [c_char_p, c_uint32]),
+    'sim_now': (c_double, []),
+    'sim_ticks': (c_uint32, []),
+    'sim_run': (None, [c_double]),
+    'sim_uart_rx': (None, [c_int, c_double, c_uint32]),
+    'sim_uart_tx_take': (c_uint32, [c_int, POINTER(c_uint8), POINTER(c_double), POINTER(c_double), c_uint32]),
+    'sim_uart_set_rts': (None, [c_int, c_int]),
+    'sim_uart_set_auto_irq': (None, [c_int, c_int]),
+    'sim_uart_hold_reset': (None, [c_int, c_int]),
+    'sim_uart_irq_pending': (c_int, [c_int]),
+    'sim_uart_irq_since': (c_double, [c_int]),
+    'sim_uart_irq': (None, [c_int]),
+    'sim_uart_baud': (c_uint32, [c_int]),
+    'sim_uart_char_time': (c_double, [c_int]),
+    'sim_uart_tx_pending': (c_uint32, [c_int]),
+    'sim_uart_hw_lost': (c_uint32, [c_int]),
+    'sim_uart_ore_events': (c_uint32, [c_int]),
+    'sim_uart_irq_count': (c_uint32, [c_int]),
+    'sim_field': (c_char_p, [c_uint32, POINTER(c_char_p), POINTER(c_uint32)]),
+    # bsp_uart_async.h
+    'uart_async_init': (None, []),
+    'uart_async_send': (c_int, [c_char_p, c_uint32]),
+    'uart_async_send_ref': (c_int, [c_char_p, c_uint32, c_uint32, c_uint32, c_void_p, c_void_p]),
+    'uart_async_set_framing': (None, [c_uint32]),
+    'uart_async_set_baud': (c_int, [c_uint32]),
+    'uart_async_get_baud': (c_uint32, []),
+    'uart_async_set_flow_control': (None, [c_int]),
+    'uart_async_is_busy': (c_int, []),
+    'uart_async_tx_free': (c_uint32, []),
+    'uart_async_wait_complete': (c_int, []),
+    'uart_async_is_throttled': (c_int, []),
+    'uart_async_rx_enable': (None, [c_void_p, c_void_p]),
+    'uart_async_rx_available': (c_uint32, []),
+    'uart_async_read': (c_uint32, [POINTER(c_uint8), c_uint32]),
+    'uart_async_get_stats': (c_void_p, []),
+    'uart_async_reset_latency': (None, []),
+    'uart_async_set_clock_hz': (None, [c_uint32]),
+    'uart_async_port_get_stats': (c_void_p, [c_void_p]),
+    'uart_async_port_get_baud': (c_uint32, [c_void_p]),
+    # bsp_uart_channel.h
+    'uart_channel_init': (None, []),
+    'uart_channel_tx_ready': (c_int, [c_int]),
+    'uart_channel_wire_len': (c_uint32, [c_uint32]),
+    'uart_channel_send': (c_int, [c_int, c_char_p, c_uint32]),
+    'uart_channel_send_ref': (c_int, [c_int, c_char_p, c_uint32, c_uint32, c_uint32, c_void_p, c_void_p]),
+    'uart_channel_poll': (None, []),
+    'uart_channel_get_stats': (c_void_p, []),
+    # link_control.h / link_arq.h / link_stripe.h / packet_crc.h
+    'packet_crc_init': (None, []),
+    'link_control_init': (None, []),
+    'link_control_poll': (None, []),
+    'link_control_tx_allowed': (c_int, []),
+    'link_control_baud': (c_uint32, []),
+    'link_control_get_stats': (c_void_p, []),
+    'link_arq_init': (None, []),
+    'link_arq_enabled': (c_int, []),
+    'link_arq_window_free': (c_uint32, []),
+    'link_arq_send': (c_int, [c_char_p, c_uint32]),
+    'link_arq_poll': (None, []),
+    'link_arq_get_stats': (c_void_p, []),
+    'link_stripe_init': (None, []),
+    'link_stripe_enable': (c_uint32, [c_uint32]),
+    'link_stripe_enabled': (c_int, []),
+    'link_stripe_tx_room': (c_uint32, [c_uint32]),
+    'link_stripe_send': (c_int, [c_char_p, c_uint32, c_uint32, c_uint32]),
+    'link_stripe_is_busy': (c_int, []),
+    'link_stripe_port': (c_void_p, [c_uint32]),
+    'link_stripe_get_stats': (c_void_p, []),
+}
+
+# ==================== 编译 ====================
+def build(out_dir):
+    """在 out_dir 里按固件的目录结构摆好源码和替身，编译成 fw.so，返回路径"""
+    for d in SHIMS:
+        shutil.copytree(os.path.join(HERE, 'host', d), os.path.join(out_dir, d), dirs_exist_ok=True)
+    for h in EMPTY_HEADERS:
+        path = os.path.join(out_dir, 'bsp', h)
+        os.makedirs(os.path.dirname(path), exist_ok=True)
+        open(path, 'w').close()
+    c_files = []
+    for d, files in SOURCES.items():
+        os.makedirs(os.path.join(out_dir, d), exist_ok=True)
+        for f in files:
+            dst = os.path.join(out_dir, d, os.path.basename(f))
+            shutil.copy(f, dst)
+            if dst.endswith('.c'):
+                c_files.append(dst)
+    os.makedirs(os.path.join(out_dir, 'sim'), exist_ok=True)
+    for f in SIM_SOURCES:
+        dst = os.path.join(out_dir, 'sim', f)
+        shutil.copy(os.path.join(HERE, 'host', f), dst)
+        if dst.endswith('.c'):
+            c_files.append(dst)
+
+    lib = os.path.join(out_dir, 'fw.so')
+    cmd = ['gcc'] + CFLAGS + ['-include', os.path.join(out_dir, 'sim', 'sim_uart.h'), '-o', lib] + c_files + ['-lm']
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        raise RuntimeError('固件主机编译失败:\n' + result.stderr)
+    return lib
+
+# ==================== 加载 ====================
+class Uart:
+    """一个 UART 的寄存器模型（n = 1 ~ 5）"""
+    def __init__(self, fw, n):
+        self.fw = fw
+        self.lib = fw.lib
+        self.n = n
+
+    def rx(self, t, value, err=False):
+        """上位机发来的一个字节在 t 时刻收完（t 不递减），err=帧错误"""
+        self.lib.sim_uart_rx(self.n, t, value | (URXD_ERR if err else 0))
+
+    def rx_bytes(self, t, data, baud=None):
+        """从 t 开始按 baud（默认模型当前的波特率）连续发出 data，返回最后一个字节收完的时刻"""
+        char = 10.0 / baud if baud else self.char_time()
+        for b in data:
+            t += char
+            self.rx(t, b)
+        return t
+
+    def take(self):
+        """取走已发完的字节：[(byte, t_start, t_end), ...]"""
+        out = []
+        while True:
+            n = 4096
+            data = (c_uint8 * n)()
+            start = (c_double * n)()
+            end = (c_double * n)()
+            got = self.lib.sim_uart_tx_take(self.n, data, start, end, n)
+            out.extend(zip(data[:got], start[:got], end[:got]))
+            if got < n:
+                return out
+
+    def reg(self, name):
+        """读寄存器（UART_REGS 里的名字）"""
+        base = c_void_p.in_dll(self.lib, f'UART{self.n}').value
+        return c_uint32.from_address(base + 0x80 + 4 * UART_REGS.index(name)).value
+
+    def set_rts(self, asserted):
+        self.lib.sim_uart_set_rts(self.n, 1 if asserted else 0)
+
+    def auto_irq(self, on):
+        self.lib.sim_uart_set_auto_irq(self.n, 1 if on else 0)
+
+    def hold_reset(self, on):
+        self.lib.sim_uart_hold_reset(self.n, 1 if on else 0)
+
+    def irq_pending(self):
+        return bool(self.lib.sim_uart_irq_pending(self.n))
+
+    def irq_since(self):
+        return self.lib.sim_uart_irq_since(self.n)
+
+    def irq(self):
+        self.lib.sim_uart_irq(self.n)
+
+    def baud(self):
+        return self.lib.sim_uart_baud(self.n)
+
+    def char_time(self):
+        return self.lib.sim_uart_char_time(self.n)
+
+    def tx_pending(self):
+        return self.lib.sim_uart_tx_pending(self.n)
+
+    def hw_lost(self):
+        return self.lib.sim_uart_hw_lost(self.n)
+
+    def ore_events(self):
+        return self.lib.sim_uart_ore_events(self.n)
+
+    def irq_count(self):
+        return self.lib.sim_uart_irq_count(self.n)
+
+class Firmware:
+    """编译并加载固件，sim_reset()；每个实例一份独立的共享库（固件的静态变量互不影响）"""
+    def __init__(self, gpt_hz=GPT1_HZ, tick_offset=0, verbose=False):
+        self.dir = tempfile.mkdtemp(prefix='fw_host_')
+        path = build(self.dir)
+        self.lib = ctypes.CDLL(path)
+        for name, (restype, argtypes) in PROTOTYPES.items():
+            fn = getattr(self.lib, name)
+            fn.restype = restype
+            fn.argtypes = argtypes
+        self.fields = {}
+        i = 0
+        while True:
+            group, offset = c_char_p(), c_uint32()
+            name = self.lib.sim_field(i, ctypes.byref(group), ctypes.byref(offset))
+            if name is None:
+                break
+            self.fields.setdefault(group.value.decode(), []).append((name.decode(), offset.value))
+            i += 1
+        self.gpt_hz = gpt_hz
+        self.lib.sim_reset(gpt_hz, tick_offset)
+        self.lib.sim_set_verbose(1 if verbose else 0)
+
+    def __del__(self):
+        shutil.rmtree(getattr(self, 'dir', ''), ignore_errors=True)
+
+    def uart(self, n):
+        return Uart(self, n)
+
+    def now(self):
+        return self.lib.sim_now()
+
+    def ticks(self):
+        return self.lib.sim_ticks()
+
+    def run(self, until):
+        self.lib.sim_run(until)
+
+    def console(self):
+        """取走固件 printf 的输出"""
+        out = ''
+        while True:
+            buf = ctypes.create_string_buffer(4096)
+            n = self.lib.sim_console_take(buf, 4096)
+            out += buf.raw[:n].decode(errors='replace')
+            if n < 4096:
+                return out
+
+    def stats(self, group, ptr):
+        """读固件统计结构体（ptr 是 xxx_get_stats() 的返回值），返回 {字段名: 值}"""
+        return {name: c_uint32.from_address(ptr + offset).value for name, offset in self.fields[group]}
+
+    def address(self, symbol):
+        """固件全局变量的地址（例如 g_uart_async_default）"""
+        return ctypes.addressof(c_uint8.in_dll(self.lib, symbol))
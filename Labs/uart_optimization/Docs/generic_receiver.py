@@ -10,7 +10,12 @@ get data for all stage（Baseline, IRQ, DMA)
 4. 打印统计摘要
 
 使用方法：
-python generic_receiver.py [--duration 30] [--output result.json]
+python generic_receiver.py [--duration 30] [--output result.json] [--check sum8|crc16]
+                           [--min-interval 10] [--framing raw|cobs] [--reliable] [--stripe PORT2]
+单包（0xAA 0x55）、批量帧（0xAA 0x56）和压缩批量帧（0xAA 0x57）自动识别
+COBS 模式下带通道标签的帧（固件 SENSOR_UART_CHANNELS=1）自动分流：遥测照常统计，日志打印并存进 JSON
+--reliable（固件 SENSOR_UART_RELIABLE=1）：打开选择重传，按 ARQ 序号重排去重，经 RX 回 ACK
+--stripe PORT2（固件 SENSOR_UART_STRIPE=1）：遥测轮流走 UART1 和 UART3，两个串口按链路序号合并
 """
 
 import serial
@@ -28,8 +33,15 @@ SERIAL_PORT = 'COM5'  #port
 BAUD_RATE = 115200
 PACKET_SIZE = 30
 
-# GPT1 实测频率
+# GPT1 标称频率：固件启动时用 32.768kHz RTC 标定（timebase_calibrate），实测值在时间基准帧里，
+# 收到第一个基准帧后 tick 换算都改用它（基准帧开机马上发一个，之前的几个包按标称值换算）
 GPT1_FREQ_HZ = 645000  # 约 645 kHz
+gpt1_freq_hz = GPT1_FREQ_HZ
+
+# 校验方式（与固件 PACKET_CHECK_MODE 一致）
+# sum8 : 8 位累加和在 checksum，padding = 0
+# crc16: CRC-16/CCITT-FALSE 占 checksum + padding（大端）
+CHECK_MODE = 'sum8'
 
 # ==================== data format ====================
 # typedef struct {
@@ -38,23 +50,575 @@ GPT1_FREQ_HZ = 645000  # 约 645 kHz
 #     uint32_t timestamp;        // GPT1 ticks
 #     int16_t accel_x, y, z;     // 加速度
 #     int16_t gyro_x, y, z;      // 陀螺仪
-#     uint32_t process_time_us;  // 处理时间
-#     uint32_t send_time_us;     // 发送时间
-#     uint8_t checksum;          // 校验和
-#     uint8_t padding;           // 填充字节
+#     uint32_t process_ticks;    // 处理时间（GPT1 ticks）
+#     uint32_t send_ticks;       // 发送时间（GPT1 ticks）
+#     uint8_t checksum;          // 校验和（crc16 模式：CRC 高字节）
+#     uint8_t padding;           // 填充字节（crc16 模式：CRC 低字节）
 # } __attribute__((packed)) sensor_packet_t;
 
 PACKET_FORMAT = '<2sHI6h2I2B'
 
+# 批量帧（固件 SENSOR_BATCH_MODE=1，见 batch_frame.h）
+# 0xAA 0x56 | N(u8) | seq(u16) | base_ts(u32) | N x [dt(u16) + 6 x i16] | CRC-16（大端）
+BATCH_HEADER = b'\xAA\x56'
+BATCH_HEAD_FORMAT = '<2sBHI'
+BATCH_HEAD_LEN = 9
+BATCH_SAMPLE_FORMAT = '<H6h'
+BATCH_SAMPLE_LEN = 14
+
+# 压缩批量帧（SENSOR_BATCH_COMPRESS=1）
+# 0xAA 0x57 | N(u8) | seq(u16) | base_ts(u32) | L(u16) | L 字节 varint 负载 | CRC-16（大端）
+# 每个样本：zigzag(dt - 上一个 dt) + 6 x zigzag(轴差分)，每帧第一个样本相对 0（关键帧）
+DELTA_HEADER = b'\xAA\x57'
+DELTA_HEAD_FORMAT = '<2sBHIH'
+DELTA_HEAD_LEN = 11
+DELTA_MAX_PAYLOAD = 512
+
+# 时间基准帧（Stage 3 / FreeRTOS Stage 3，见 timebase_frame.h），每秒一个
+# 0xAA 0x58 | 64 位 GPT 计数(u64) | GPT 频率 Hz(u32) | 标志(u8) | CRC-16（大端）
+# 包里的时间戳是它的低 32 位，以最近的基准帧为参考还原高位
+# 标志 bit 0：频率是对 RTC 标定出来的（0 = 固件标定失败，用的标称值）
+TIMEBASE_HEADER = b'\xAA\x58'
+TIMEBASE_FORMAT = '<2sQIB'
+TIMEBASE_FRAME_LEN = 17
+TIMEBASE_FLAG_CALIBRATED = 0x01
+
+# 帧格式（与固件 SENSOR_COBS_FRAMING 一致）
+# raw : 字节流中搜索 0xAA 0x55 / 0x56 / 0x57 包头
+# cobs: 以 0x00 分帧，每帧 COBS 解码后按包头和长度精确匹配，出错只丢当前帧
+FRAMING = 'raw'
+
+# 逻辑通道（固件 bsp_uart_channel.h，SENSOR_UART_CHANNELS=1，需要 --framing cobs）
+# COBS 解码后第一个字节是通道标签，其余是负载；没有标签的帧（0xAA / 0xA5 开头）按遥测 / 控制处理
+CHANNEL_CONTROL = 0xC0
+CHANNEL_TELEMETRY = 0xC1
+CHANNEL_LOG = 0xC2
+CHANNEL_TAGS = (CHANNEL_CONTROL, CHANNEL_TELEMETRY, CHANNEL_LOG)
+
+# 波特率协商（固件 link_control.c）：115200 起步，--baud 请求更高波特率
+# 控制帧：0xA5 0x5A | cmd(u8) | arg(u32) | CRC-16（大端），应答 cmd | 0x80
+LINK_HEADER = b'\xA5\x5A'
+LINK_FRAME_LEN = 9
+LINK_CMD_BAUD = 0x01
+LINK_CMD_PING = 0x02
+LINK_CMD_REPLY = 0x80
+LINK_BAUDS = (115200, 460800, 921600, 3000000)
+LINK_PING_INTERVAL_S = 1.0      # 保活间隔（固件 LINK_KEEPALIVE_MS = 3 s）
+LINK_FALLBACK_SILENCE_S = 2.0   # 高波特率下这么久没有有效包就回退
+LINK_FALLBACK_ERRORS = 20       # 一秒内校验错误超过这个数就回退
+TARGET_BAUD = None              # None：不协商，保持 115200
+
+# 可靠模式（固件 link_arq.h，SENSOR_UART_RELIABLE=1，需要 --framing cobs）
+# 数据帧：0xAA 0x52 | ARQ 序号(u16) | 负载（单包 / 批量帧）| CRC-16（大端）
+# ACK 是控制帧 LINK_CMD_ACK，参数 = next | sack << 16（sack bit i：next+1+i 已收到）
+ARQ_HEADER = b'\xAA\x52'
+ARQ_HEAD_LEN = 4
+LINK_CMD_ARQ = 0x03
+LINK_CMD_ACK = 0x04
+ARQ_WINDOW = 64                 # 固件 LINK_ARQ_WINDOW（以 ARQ 应答里的窗口为准）
+ARQ_ACK_INTERVAL_S = 0.01       # 有新帧时最多每 10ms 回一次 ACK
+ARQ_ACK_GAP_S = 0.002           # 发现空洞时尽快回 ACK，让固件快速重传
+ARQ_GIVEUP_S = 2.0              # 空洞等这么久还没补上就跳过（固件 200ms x 8 次重传后放弃）
+RELIABLE = False
+
+# 条带化（固件 link_stripe.h，SENSOR_UART_STRIPE=1，需要 --framing cobs）
+# 帧：0xAA 0x53 | 链路号(u8) | 链路序号(u16) | 头校验和(前 5 字节之和) | 负载（单包 / 批量帧）
+# 全局第 g 帧走链路 g % 链路数、链路序号 g // 链路数，按 g 合并
+STRIPE_HEADER = b'\xAA\x53'
+STRIPE_HEAD_LEN = 6
+LINK_CMD_STRIPE = 0x05
+STRIPE_GIVEUP_S = 0.5           # 轮到的链路这么久没有帧、而别的链路有帧时跳过（该链路丢了最后几帧）
+STRIPE_MAX_LAG = 128            # 别的链路领先这么多帧时不再等（固件每条链路最多排队约 4 x 13 帧）
+STRIPE_PORT = None              # 第二个串口（UART3），None：不打开条带化
+
+# RTS/CTS 硬件流控（固件 SENSOR_UART_FLOW_CONTROL=1）：上位机缓冲区满时由驱动拉高 RTS 让固件暂停
+RTSCTS = False
+
+# 采样间隔过滤范围（ms），高采样率（FIFO / 批量帧）时用 --min-interval 调小
+MIN_INTERVAL_MS = 10
+MAX_INTERVAL_MS = 200
+
 # ==================== 辅助函数 ====================
 def ticks_to_ms(ticks):
-    """GPT1 ticks → 毫秒"""
-    return (ticks * 1000.0) / GPT1_FREQ_HZ
+    """GPT1 ticks → 毫秒（按固件报告的频率）"""
+    return (ticks * 1000.0) / gpt1_freq_hz
 
 def calculate_checksum(data):
     """计算校验和（不包括最后2个字节）"""
     return sum(data[:-2]) & 0xFF
 
+def _make_crc16_table():
+    table = []
+    for i in range(256):
+        crc = i << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+        table.append(crc & 0xFFFF)
+    return table
+
+CRC16_TABLE = _make_crc16_table()
+
+def crc16_ccitt(data):
+    """CRC-16/CCITT-FALSE（poly 0x1021, init 0xFFFF），与固件 crc16_ccitt() 相同"""
+    crc = 0xFFFF
+    for b in data:
+        crc = ((crc << 8) & 0xFFFF) ^ CRC16_TABLE[((crc >> 8) ^ b) & 0xFF]
+    return crc
+
+def verify_packet(data):
+    """按 CHECK_MODE 校验一个完整数据包"""
+    if CHECK_MODE == 'crc16':
+        return crc16_ccitt(data[:-2]) == ((data[-2] << 8) | data[-1])
+    return calculate_checksum(data) == data[-2]
+
+def decode_batch(frame):
+    """解析一个完整批量帧（已校验），返回 [(seq, timestamp, ax, ay, az, gx, gy, gz), ...]"""
+    _, count, seq, timestamp = struct.unpack_from(BATCH_HEAD_FORMAT, frame, 0)
+    samples = []
+    for i in range(count):
+        dt, ax, ay, az, gx, gy, gz = struct.unpack_from(
+            BATCH_SAMPLE_FORMAT, frame, BATCH_HEAD_LEN + i * BATCH_SAMPLE_LEN)
+        timestamp = (timestamp + dt) & 0xFFFFFFFF
+        samples.append(((seq + i) & 0xFFFF, timestamp, ax, ay, az, gx, gy, gz))
+    return samples
+
+def batch_frame_len(count):
+    return BATCH_HEAD_LEN + count * BATCH_SAMPLE_LEN + 2
+
+def cobs_decode(data):
+    """COBS 解码（不含 0x00 分隔符），格式错误返回 None"""
+    out = bytearray()
+    i = 0
+    n = len(data)
+    while i < n:
+        code = data[i]
+        if code == 0 or i + code > n:
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < n:
+            out.append(0)
+    return bytes(out)
+
+def cobs_encode(data):
+    """COBS 编码（含结尾 0x00），与固件 cobs_encode() 相同，用于测试"""
+    out = bytearray([0])
+    code_idx = 0
+    code = 1
+    for b in data:
+        if b == 0:
+            out[code_idx] = code
+            code_idx = len(out)
+            out.append(0)
+            code = 1
+        else:
+            out.append(b)
+            code += 1
+            if code == 0xFF:
+                out[code_idx] = code
+                code_idx = len(out)
+                out.append(0)
+                code = 1
+    out[code_idx] = code
+    out.append(0)
+    return bytes(out)
+
+def link_frame(cmd, arg):
+    """控制帧（与固件 link_send_reply() 格式相同）"""
+    body = LINK_HEADER + struct.pack('<BI', cmd, arg)
+    return body + struct.pack('>H', crc16_ccitt(body))
+
+def find_link_reply(data, cmd):
+    """在收到的字节里找 cmd 的应答，返回参数；没有找到返回 None
+    COBS 模式下固件的应答也编码成一个 COBS 帧"""
+    if FRAMING == 'cobs':
+        chunks = [cobs_decode(c) or b'' for c in bytes(data).split(b'\x00') if c]
+    else:
+        chunks = [bytes(data)]
+    for chunk in chunks:
+        idx = chunk.find(LINK_HEADER)
+        while idx != -1 and idx + LINK_FRAME_LEN <= len(chunk):
+            frame = chunk[idx:idx + LINK_FRAME_LEN]
+            if (frame[2] == (cmd | LINK_CMD_REPLY) and
+                    crc16_ccitt(frame[:7]) == ((frame[7] << 8) | frame[8])):
+                return struct.unpack_from('<I', frame, 3)[0]
+            idx = chunk.find(LINK_HEADER, idx + 1)
+    return None
+
+def negotiate_baud(ser, target, retries=3, timeout=1.0):
+    """以当前波特率请求 target，收到应答后本端切换并发 PING 确认，失败返回 False"""
+    for attempt in range(retries):
+        ser.write(link_frame(LINK_CMD_BAUD, target))
+        data = bytearray()
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            data.extend(ser.read(ser.in_waiting or 1))
+            arg = find_link_reply(data, LINK_CMD_BAUD)
+            if arg is None:
+                continue
+            if arg != target:
+                print(f"固件不支持 {target} 波特率")
+                return False
+            # 固件在应答发完后立即切换；PING 多发几次，防止第一个落在切换瞬间
+            ser.baudrate = target
+            ser.reset_input_buffer()
+            for _ in range(3):
+                time.sleep(0.02)
+                ser.write(link_frame(LINK_CMD_PING, 0))
+            return True
+        print(f"协商超时，重试 {attempt + 1}/{retries}")
+    return False
+
+def enable_reliable(ser, retries=3, timeout=1.0):
+    """请求打开可靠模式，返回固件的窗口大小；固件不支持或没有应答时返回 0
+    协商期间收到的数据帧被丢弃，打开后由固件按 ACK 重传"""
+    for attempt in range(retries):
+        ser.write(link_frame(LINK_CMD_ARQ, 1))
+        data = bytearray()
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            data.extend(ser.read(ser.in_waiting or 1))
+            arg = find_link_reply(data, LINK_CMD_ARQ)
+            if arg is not None:
+                return arg
+        print(f"可靠模式请求超时，重试 {attempt + 1}/{retries}")
+    return 0
+
+def read_link_reply(ser, cmd, timeout):
+    """逐个 COBS 帧找 cmd 的应答，返回 (参数, 应答之后已收到的字节)；超时返回 (None, b'')"""
+    data = bytearray()
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        data.extend(ser.read(ser.in_waiting or 1))
+        end = data.find(b'\x00')
+        while end != -1:
+            arg = find_link_reply(data[:end + 1], cmd)
+            del data[:end + 1]
+            if arg is not None:
+                return arg, bytes(data)
+            end = data.find(b'\x00')
+    return None, b''
+
+def enable_stripe(ser, ser2, retries=3, timeout=1.0):
+    """打开条带化，返回 (链路数, 应答之后 UART1 上已收到的字节)；固件不支持或没有应答时链路数为 0
+    先关再开：上次会话没有关掉时固件会接着编号，重新打开后全局帧号从 0 开始
+    应答之前 UART1 上的数据丢弃，之后的都是条带帧，交给主循环"""
+    for attempt in range(retries):
+        ser.write(link_frame(LINK_CMD_STRIPE, 0))
+        if read_link_reply(ser, LINK_CMD_STRIPE, timeout)[0] is not None:
+            time.sleep(0.05)                # UART3 上已排队的旧帧发完后清掉
+            ser2.reset_input_buffer()
+            ser.write(link_frame(LINK_CMD_STRIPE, 1))
+            links, rest = read_link_reply(ser, LINK_CMD_STRIPE, timeout)
+            if links is not None:
+                return links, rest
+        print(f"条带化请求超时，重试 {attempt + 1}/{retries}")
+    return 0, b''
+
+def decode_frame(frame):
+    """解析一个已分好界的完整帧（COBS 模式），返回样本列表和是否为单包，无效返回 (None, None)"""
+    if len(frame) == PACKET_SIZE and frame[:2] == b'\xAA\x55':
+        if verify_packet(frame):
+            return struct.unpack(PACKET_FORMAT, frame), True
+    elif len(frame) >= BATCH_HEAD_LEN + 2 and frame[:2] == BATCH_HEADER:
+        if (len(frame) == batch_frame_len(frame[2]) and frame[2] > 0 and
+                crc16_ccitt(frame[:-2]) == ((frame[-2] << 8) | frame[-1])):
+            return decode_batch(frame), False
+    elif len(frame) >= DELTA_HEAD_LEN + 2 and frame[:2] == DELTA_HEADER:
+        payload_len = struct.unpack_from('<H', frame, 9)[0]
+        if (len(frame) == DELTA_HEAD_LEN + payload_len + 2 and
+                crc16_ccitt(frame[:-2]) == ((frame[-2] << 8) | frame[-1])):
+            try:
+                return decode_delta_batch(frame), False
+            except (IndexError, ValueError):
+                pass
+    return None, None
+
+def handle_cobs_frame(collector, chunk):
+    """处理一个 COBS 帧（不含 0x00）：按通道标签分流，遥测进统计，日志按行打印"""
+    frame = cobs_decode(chunk)
+    if frame and frame[0] in CHANNEL_TAGS:
+        channel, frame = frame[0], frame[1:]
+        collector.channel_frames[channel] += 1
+    elif frame is not None and frame[:2] == LINK_HEADER:
+        channel = CHANNEL_CONTROL
+    else:
+        channel = CHANNEL_TELEMETRY     # 不带标签的遥测帧
+    
+    if channel == CHANNEL_LOG:
+        for line in collector.update_log(frame):
+            print(f"\r[FW] {line}".ljust(100))
+        return
+    if channel == CHANNEL_CONTROL:
+        return                          # 控制应答由 negotiate_baud() 在协商时处理
+    
+    if frame is not None and frame[:2] == ARQ_HEADER:
+        if collector.arq is not None:
+            payloads = collector.arq.receive(frame, time.time())
+        elif len(frame) > ARQ_HEAD_LEN + 2 and crc16_ccitt(frame[:-2]) == ((frame[-2] << 8) | frame[-1]):
+            payloads = [frame[ARQ_HEAD_LEN:-2]]   # 没开 --reliable：只拆掉序号头，不回 ACK
+        else:
+            payloads = None
+        if payloads is None:
+            collector.checksum_errors += 1
+        for payload in payloads or []:
+            handle_telemetry(collector, payload, len(payload))
+        return
+    if frame is not None and frame[:2] == STRIPE_HEADER:
+        if collector.stripe is not None:
+            payloads = collector.stripe.receive(frame, time.time())
+        elif len(frame) > STRIPE_HEAD_LEN and sum(frame[:5]) & 0xFF == frame[5]:
+            payloads = [frame[STRIPE_HEAD_LEN:]]  # 没开 --stripe：只拆掉条带头（只收到 UART1 上的一半）
+        else:
+            payloads = None
+        if payloads is None:
+            collector.checksum_errors += 1
+        for payload in payloads or []:
+            handle_telemetry(collector, payload, len(payload))
+        return
+    handle_telemetry(collector, frame, len(chunk) + 1)
+
+def parse_timebase(frame):
+    """时间基准帧，返回 (64 位计数, GPT 频率 Hz, 标志)，无效返回 None"""
+    if (len(frame) == TIMEBASE_FRAME_LEN and frame[:2] == TIMEBASE_HEADER and
+            crc16_ccitt(frame[:-2]) == ((frame[-2] << 8) | frame[-1])):
+        return struct.unpack_from(TIMEBASE_FORMAT, frame)[1:]
+    return None
+
+def handle_telemetry(collector, frame, wire_len):
+    """一个遥测负载（单包 / 批量帧 / 时间基准帧）进统计，frame 为 None 时计一次校验错误"""
+    if frame is not None and frame[:2] == TIMEBASE_HEADER:
+        timebase = parse_timebase(frame)
+        if timebase is None:
+            collector.checksum_errors += 1
+        else:
+            collector.update_timebase(*timebase)
+        return
+    data, single = decode_frame(frame) if frame is not None else (None, None)
+    if data is None:
+        collector.checksum_errors += 1
+    elif single:
+        collector.update(data)
+        collector.print_realtime()
+    else:
+        collector.update_batch(wire_len, data)
+        collector.print_realtime()
+
+def read_varint(data, pos):
+    """返回 (值, 新位置)"""
+    value = 0
+    shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return value, pos
+        shift += 7
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+def to_int16(v):
+    v &= 0xFFFF
+    return v - 0x10000 if v & 0x8000 else v
+
+def decode_delta_batch(frame):
+    """解析一个完整压缩帧（已校验），返回格式同 decode_batch()"""
+    _, count, seq, timestamp, payload_len = struct.unpack_from(DELTA_HEAD_FORMAT, frame, 0)
+    pos = DELTA_HEAD_LEN
+    dt = 0
+    axis = [0] * 6
+    samples = []
+    for i in range(count):
+        v, pos = read_varint(frame, pos)
+        dt += unzigzag(v)
+        for k in range(6):
+            v, pos = read_varint(frame, pos)
+            axis[k] = to_int16(axis[k] + unzigzag(v))   # 16 位回绕
+        timestamp = (timestamp + dt) & 0xFFFFFFFF
+        samples.append(((seq + i) & 0xFFFF, timestamp, *axis))
+    if pos != DELTA_HEAD_LEN + payload_len:
+        raise ValueError('payload length mismatch')
+    return samples
+
+# ==================== 可靠模式 ====================
+class ArqReceiver:
+    """可靠模式接收端（固件 link_arq.c）：校验、去重、按 ARQ 序号重排后交付，生成 ACK"""
+    def __init__(self, window=ARQ_WINDOW):
+        self.window = window
+        self.expected = 0           # 下一个按序交付的序号（16 位）
+        self.pending = {}           # 先到的帧：序号 → 负载
+        self.hole_since = None      # expected 开始缺失的时间
+        self.ack_due = False        # 收到帧后还没回 ACK
+        self.gap_seen = False       # 出现新空洞，尽快回 ACK
+        self.last_ack = 0.0
+        
+        self.delivered = 0
+        self.duplicates = 0         # 重复收到（ACK 丢了或来晚，固件多重传了一次）
+        self.skipped = 0            # 放弃的空洞（真正丢失的帧）
+        self.bad_frames = 0
+        self.acks_sent = 0
+    
+    def _drain(self):
+        ready = []
+        while self.expected in self.pending:
+            ready.append(self.pending.pop(self.expected))
+            self.expected = (self.expected + 1) & 0xFFFF
+        self.delivered += len(ready)
+        return ready
+    
+    def _skip(self):
+        self.skipped += 1
+        self.expected = (self.expected + 1) & 0xFFFF
+        return self._drain()
+    
+    def _update_hole(self, ready, now):
+        if not self.pending:
+            self.hole_since = None
+        elif ready or self.hole_since is None:
+            self.hole_since = now       # 新的空洞重新计时
+    
+    def receive(self, frame, now):
+        """一个 0xAA 0x52 帧，返回按序可交付的负载列表；校验失败返回 None"""
+        if len(frame) <= ARQ_HEAD_LEN + 2 or crc16_ccitt(frame[:-2]) != ((frame[-2] << 8) | frame[-1]):
+            self.bad_frames += 1
+            return None
+        seq = frame[2] | (frame[3] << 8)
+        self.ack_due = True
+        offset = (seq - self.expected) & 0xFFFF
+        if offset >= 0x8000 or seq in self.pending:
+            self.duplicates += 1
+            return []
+        
+        # 固件最多有 window 帧未确认：超出窗口说明前面的空洞已被固件放弃
+        ready = []
+        while offset >= self.window:
+            ready.extend(self._skip())
+            offset = (seq - self.expected) & 0xFFFF
+        if offset > 0:
+            self.gap_seen = True
+        self.pending[seq] = bytes(frame[ARQ_HEAD_LEN:-2])
+        ready.extend(self._drain())
+        self._update_hole(ready, now)
+        return ready
+    
+    def poll(self, now):
+        """空洞等待超时就跳过，返回因此可交付的负载"""
+        ready = []
+        if self.hole_since is not None and now - self.hole_since > ARQ_GIVEUP_S:
+            ready = self._skip()
+            self.hole_since = now if self.pending else None   # 下一个空洞重新计时
+        return ready
+    
+    def ack(self, now):
+        """该回 ACK 时返回控制帧参数，否则返回 None"""
+        if not self.ack_due:
+            return None
+        interval = ARQ_ACK_GAP_S if self.gap_seen else ARQ_ACK_INTERVAL_S
+        if now - self.last_ack < interval:
+            return None
+        sack = 0
+        for i in range(16):
+            if ((self.expected + 1 + i) & 0xFFFF) in self.pending:
+                sack |= 1 << i
+        self.ack_due = self.gap_seen = False
+        self.last_ack = now
+        self.acks_sent += 1
+        return self.expected | (sack << 16)
+    
+    def get_statistics(self):
+        return {
+            'window': self.window,
+            'delivered_frames': self.delivered,
+            'duplicates': self.duplicates,
+            'skipped_frames': self.skipped,
+            'bad_frames': self.bad_frames,
+            'acks_sent': self.acks_sent,
+        }
+
+# ==================== 条带化 ====================
+class StripeReassembler:
+    """条带化接收端（固件 link_stripe.c）：各链路的帧按全局帧号合并，链路序号断档计为丢失"""
+    def __init__(self, links=2):
+        self.links = links
+        self.expected = 0               # 下一个按序交付的全局帧号（enable_stripe() 后从 0 开始）
+        self.queues = [deque() for _ in range(links)]   # 各链路先到的帧：(全局帧号, 负载)
+        self.last = [None] * links      # 各链路最近一帧的链路序号（已展开，不回绕）
+        self.wait_since = None          # 开始等轮到的链路的时间
+        
+        self.delivered = 0
+        self.lost = 0                   # 跳过的帧（链路序号断档 / 等待超时）
+        self.late = 0                   # 已经跳过之后才到的帧
+        self.bad_frames = 0
+        self.link_frames = [0] * links
+    
+    def _unwrap(self, link, seq):
+        last = self.last[link]
+        if last is None:
+            return seq
+        d = (seq - last) & 0xFFFF
+        return last + (d - 0x10000 if d >= 0x8000 else d)
+    
+    def _drain(self, now):
+        ready = []
+        while True:
+            queue = self.queues[self.expected % self.links]
+            if queue and queue[0][0] == self.expected:
+                ready.append(queue.popleft()[1])
+                self.delivered += 1
+            elif queue and queue[0][0] > self.expected:
+                self.lost += 1          # 该链路的序号跳过了这一帧：线路上丢了
+            else:
+                break
+            self.expected += 1
+            self.wait_since = None
+        if self.wait_since is None and any(self.queues):
+            self.wait_since = now
+        return ready
+    
+    def receive(self, frame, now):
+        """一个 0xAA 0x53 帧，返回按序可交付的负载列表；无效返回 None"""
+        if len(frame) <= STRIPE_HEAD_LEN or frame[2] >= self.links or sum(frame[:5]) & 0xFF != frame[5]:
+            self.bad_frames += 1            # 条带头坏了：不能信它的链路序号，整帧丢掉
+            return None
+        link = frame[2]
+        seq = self._unwrap(link, frame[3] | (frame[4] << 8))
+        self.link_frames[link] += 1
+        if self.last[link] is not None and seq <= self.last[link]:
+            self.late += 1              # UART 不会乱序，只可能是固件重新编号后的旧帧
+            return []
+        self.last[link] = seq
+        g = seq * self.links + link
+        if g < self.expected:
+            self.late += 1
+            return []
+        self.queues[link].append((g, bytes(frame[STRIPE_HEAD_LEN:])))
+        return self._drain(now)
+    
+    def poll(self, now):
+        """轮到的链路迟迟没有帧（丢了最后几帧 / 链路断了）时跳过，返回因此可交付的负载"""
+        ready = []
+        while self.wait_since is not None:
+            newest = max((q[-1][0] for q in self.queues if q), default=self.expected)
+            if now - self.wait_since <= STRIPE_GIVEUP_S and newest - self.expected < STRIPE_MAX_LAG:
+                break
+            self.lost += 1
+            self.expected += 1
+            self.wait_since = None
+            ready.extend(self._drain(now))
+        return ready
+    
+    def get_statistics(self):
+        return {
+            'links': self.links,
+            'delivered_frames': self.delivered,
+            'lost_frames': self.lost,
+            'late_frames': self.late,
+            'bad_frames': self.bad_frames,
+            'link_frames': list(self.link_frames),
+        }
+
 # ==================== 统计类 ====================
 class DataCollector:
     def __init__(self):
@@ -71,9 +635,26 @@ class DataCollector:
         self.raw_process_times = []  # 处理时间 (ms)
         self.raw_send_times = []     # 发送时间 (ms)
         
-        # 最后一个时间戳
+        # 最后一个时间戳（已扩展到 64 位）
         self.last_timestamp = None
         
+        # 时间基准帧：最近一次的 64 位计数（None：固件不发，按相邻时间戳推算回绕）
+        self.timebase = None
+        self.timebase_frames = 0
+        self.gpt_hz = None               # 基准帧里的 GPT 频率
+        self.gpt_calibrated = False
+        
+        # 日志通道：文本按行切分（固件按帧长切分，一行可能跨两帧）
+        self.log_pending = bytearray()
+        self.log_lines = []
+        self.channel_frames = {CHANNEL_CONTROL: 0, CHANNEL_TELEMETRY: 0, CHANNEL_LOG: 0}
+        
+        # 可靠模式接收端（--reliable 且固件应答后创建）
+        self.arq = None
+        
+        # 条带化接收端（--stripe 且固件应答后创建）
+        self.stripe = None
+        
     def update(self, packet_data):
         """更新统计信息"""
         self.valid_packets += 1
@@ -82,33 +663,75 @@ class DataCollector:
         # 解析数据包
         header, seq_num, timestamp, ax, ay, az, gx, gy, gz, proc_time, send_time, checksum, padding = packet_data
         
-        # 保存时间戳
+        self.record_timestamp(timestamp)
+        
+        # 性能时间统计
+        proc_ms = ticks_to_ms(proc_time)
+        send_ms = ticks_to_ms(send_time)
+        
+        if proc_ms < 100:  # 过滤异常值
+            self.raw_process_times.append(proc_ms)
+        if send_ms < 100:
+            self.raw_send_times.append(send_ms)
+    
+    def update_batch(self, frame_len, samples):
+        """批量帧：samples 为 [(seq, timestamp, ax, ay, az, gx, gy, gz), ...]"""
+        self.valid_packets += len(samples)
+        self.total_bytes += frame_len
+        for sample in samples:
+            self.record_timestamp(sample[1])
+    
+    def update_timebase(self, ticks, gpt_hz, flags):
+        """时间基准帧：之后的时间戳以它为参考扩展，tick 按帧里的频率换算"""
+        global gpt1_freq_hz
+        self.timebase = ticks
+        self.timebase_frames += 1
+        if gpt_hz > 0:
+            self.gpt_hz = gpt_hz
+            self.gpt_calibrated = bool(flags & TIMEBASE_FLAG_CALIBRATED)
+            gpt1_freq_hz = gpt_hz
+    
+    def extend_timestamp(self, timestamp):
+        """32 位时间戳扩展到 64 位：取离参考（最近的基准帧，没有时用上一个时间戳）最近的那一圈"""
+        ref = self.timebase if self.timebase is not None else self.last_timestamp
+        if ref is None:
+            return timestamp
+        delta = (timestamp - ref) & 0xFFFFFFFF
+        if delta >= 0x80000000:
+            delta -= 0x100000000        # 参考之前的时间戳（批量帧里的旧样本、基准帧之前发出的包）
+        return ref + delta
+    
+    def record_timestamp(self, timestamp):
+        """保存时间戳（扩展到 64 位）并计算采样间隔"""
+        timestamp = self.extend_timestamp(timestamp)
         self.raw_timestamps.append(timestamp)
         
-        # 计算采样间隔
+        # 计算采样间隔（64 位时间戳直接相减，不用再处理回绕）
         if self.last_timestamp is not None:
-            # 处理 32-bit 计数器溢出
-            if timestamp > self.last_timestamp:
-                delta_ticks = timestamp - self.last_timestamp
-            else:
-                delta_ticks = (0xFFFFFFFF - self.last_timestamp) + timestamp
+            delta_ticks = timestamp - self.last_timestamp
             
             interval_ms = ticks_to_ms(delta_ticks)
             
             # 过滤异常值（保留合理范围）
-            if 10 < interval_ms < 200:
+            if MIN_INTERVAL_MS < interval_ms < MAX_INTERVAL_MS:
                 self.raw_intervals.append(interval_ms)
         
         self.last_timestamp = timestamp
-        
-        # 性能时间统计
-        proc_ms = ticks_to_ms(proc_time)
-        send_ms = ticks_to_ms(send_time)
-        
-        if proc_ms < 100:  # 过滤异常值
-            self.raw_process_times.append(proc_ms)
-        if send_ms < 100:
-            self.raw_send_times.append(send_ms)
+    
+    def update_log(self, text):
+        """日志通道负载：拼接后按行输出，返回新完成的行"""
+        self.log_pending.extend(text)
+        lines = []
+        while True:
+            end = self.log_pending.find(b'\n')
+            if end == -1:
+                break
+            line = bytes(self.log_pending[:end]).decode('utf-8', 'replace').rstrip('\r')
+            self.log_pending = self.log_pending[end + 1:]
+            if line:
+                lines.append(line)
+        self.log_lines.extend(lines)
+        return lines
     
     def get_statistics(self):
         """计算统计信息"""
@@ -131,8 +754,26 @@ class DataCollector:
                 'timestamps_ticks': self.raw_timestamps,
                 'process_times_ms': self.raw_process_times,
                 'send_times_ms': self.raw_send_times
-            }
+            },
+            'channels': {
+                'control_frames': self.channel_frames[CHANNEL_CONTROL],
+                'telemetry_frames': self.channel_frames[CHANNEL_TELEMETRY],
+                'log_frames': self.channel_frames[CHANNEL_LOG],
+            },
+            'firmware_log': self.log_lines
         }
+        if self.arq is not None:
+            stats['reliable'] = self.arq.get_statistics()
+        if self.stripe is not None:
+            stats['stripe'] = self.stripe.get_statistics()
+        if self.timebase is not None:
+            stats['timebase'] = {
+                'frames': self.timebase_frames,
+                'last_ticks': self.timebase,
+                'wraps': self.timebase >> 32,
+                'gpt_hz': self.gpt_hz,
+                'calibrated': self.gpt_calibrated,
+            }
         
         # 定时精度统计
         if len(self.raw_intervals) > 0:
@@ -190,8 +831,12 @@ def receive_data(duration_seconds=30, output_file='result.json'):
     print("\n" + "="*60)
     print("  通用数据接收器")
     print("="*60)
-    print(f"串口: {SERIAL_PORT} @ {BAUD_RATE}")
+    print(f"串口: {SERIAL_PORT} @ {BAUD_RATE}" + (f"（协商 {TARGET_BAUD}）" if TARGET_BAUD else ""))
     print(f"包大小: {PACKET_SIZE} 字节")
+    print(f"校验方式: {CHECK_MODE}")
+    print(f"帧格式: {FRAMING}" + ("（可靠模式）" if RELIABLE else ""))
+    if STRIPE_PORT:
+        print(f"条带化: 第二串口 {STRIPE_PORT}")
     print(f"测试时长: {duration_seconds} 秒")
     print(f"输出文件: {output_file}")
     print("="*60 + "\n")
@@ -200,12 +845,39 @@ def receive_data(duration_seconds=30, output_file='result.json'):
     
     try:
         # 打开串口
-        ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=1)
+        ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=1, rtscts=RTSCTS)
         print(f"串口已打开: {ser.name}")
-        print("开始接收数据...\n")
+        ser2 = serial.Serial(STRIPE_PORT, BAUD_RATE, timeout=1) if STRIPE_PORT else None
         
+        # 波特率协商：失败时保持 115200 继续接收
+        negotiated = False
+        if TARGET_BAUD and TARGET_BAUD != BAUD_RATE:
+            negotiated = negotiate_baud(ser, TARGET_BAUD)
+            print(f"波特率: {ser.baudrate}" + ("" if negotiated else "（协商失败）"))
+            if ser2 is not None:
+                ser2.baudrate = ser.baudrate    # 固件所有链路一起切换
+        if RELIABLE:
+            window = enable_reliable(ser)
+            if window:
+                collector.arq = ArqReceiver(window)
+                print(f"可靠模式: 窗口 {window} 帧")
+            else:
+                print("可靠模式: 固件不支持（SENSOR_UART_RELIABLE=0），按尽力而为接收")
         buffer = bytearray()
+        buffer2 = bytearray()
+        if ser2 is not None:
+            links, rest = enable_stripe(ser, ser2)
+            if links:
+                collector.stripe = StripeReassembler(links)
+                buffer.extend(rest)
+                print(f"条带化: {links} 条链路")
+            else:
+                print("条带化: 固件不支持（SENSOR_UART_STRIPE=0），只收 UART1")
+        print("开始接收数据...\n")
+        
         test_start = time.time()
+        last_ping = last_check = last_valid_time = time.time()
+        last_valid = last_errors = 0
         
         while True:
             # 检查测试时长
@@ -213,14 +885,66 @@ def receive_data(duration_seconds=30, output_file='result.json'):
                 print("\n\n测试时间到，停止接收。")
                 break
             
+            # 高波特率下：定期保活；校验错误飙升或长时间没有有效包时回退到 115200
+            # 回退后不再发 PING，固件在保活超时后也回到 115200
+            now = time.time()
+            if negotiated:
+                if now - last_ping >= LINK_PING_INTERVAL_S:
+                    ser.write(link_frame(LINK_CMD_PING, 0))
+                    last_ping = now
+                if collector.valid_packets != last_valid:
+                    last_valid = collector.valid_packets
+                    last_valid_time = now
+                if now - last_check >= 1.0:
+                    too_many_errors = collector.checksum_errors - last_errors > LINK_FALLBACK_ERRORS
+                    last_errors = collector.checksum_errors
+                    last_check = now
+                    if too_many_errors or now - last_valid_time > LINK_FALLBACK_SILENCE_S:
+                        print(f"\n链路质量差，回退到 {BAUD_RATE} 波特率")
+                        ser.baudrate = BAUD_RATE
+                        buffer.clear()
+                        if ser2 is not None:
+                            ser2.baudrate = BAUD_RATE
+                            buffer2.clear()
+                        negotiated = False
+            
             # 读取串口数据
             if ser.in_waiting > 0:
                 buffer.extend(ser.read(ser.in_waiting))
+            if ser2 is not None and ser2.in_waiting > 0:
+                buffer2.extend(ser2.read(ser2.in_waiting))
+            
+            # COBS：按 0x00 分帧，每帧独立校验（条带化时两个串口的帧由 collector.stripe 合并）
+            for buf in (buffer, buffer2):
+                while FRAMING == 'cobs':
+                    end = buf.find(b'\x00')
+                    if end == -1:
+                        break
+                    chunk = bytes(buf[:end])
+                    del buf[:end + 1]
+                    if chunk:
+                        handle_cobs_frame(collector, chunk)
+            
+            # 条带化：轮到的链路等不到帧时跳过
+            if collector.stripe is not None:
+                for payload in collector.stripe.poll(time.time()):
+                    handle_telemetry(collector, payload, len(payload))
+            
+            # 可靠模式：放弃等不到的空洞，按时回 ACK
+            if collector.arq is not None:
+                now = time.time()
+                for payload in collector.arq.poll(now):
+                    handle_telemetry(collector, payload, len(payload))
+                ack = collector.arq.ack(now)
+                if ack is not None:
+                    ser.write(link_frame(LINK_CMD_ACK, ack))
             
             # 查找数据包
-            while len(buffer) >= PACKET_SIZE:
-                # 查找包头 0xAA 0x55
-                idx = buffer.find(b'\xAA\x55')
+            while FRAMING == 'raw' and len(buffer) >= PACKET_SIZE:
+                # 查找包头 0xAA 0x55（单包）/ 0xAA 0x56（批量帧）/ 0xAA 0x57（压缩批量帧）/ 0xAA 0x58（时间基准帧）
+                idx = buffer.find(b'\xAA')
+                while idx != -1 and idx + 1 < len(buffer) and buffer[idx + 1] not in (0x55, 0x56, 0x57, 0x58):
+                    idx = buffer.find(b'\xAA', idx + 1)
                 
                 if idx == -1:
                     buffer.clear()
@@ -230,6 +954,68 @@ def receive_data(duration_seconds=30, output_file='result.json'):
                 if idx > 0:
                     buffer = buffer[idx:]
                 
+                if len(buffer) < 3:
+                    break
+                
+                # 时间基准帧
+                if buffer[:2] == TIMEBASE_HEADER:
+                    if len(buffer) < TIMEBASE_FRAME_LEN:
+                        break
+                    timebase = parse_timebase(bytes(buffer[:TIMEBASE_FRAME_LEN]))
+                    if timebase is not None:
+                        buffer = buffer[TIMEBASE_FRAME_LEN:]
+                        collector.update_timebase(*timebase)
+                    else:
+                        buffer = buffer[1:]
+                        collector.checksum_errors += 1
+                    continue
+                
+                # 压缩批量帧
+                if buffer[:2] == DELTA_HEADER:
+                    if len(buffer) < DELTA_HEAD_LEN:
+                        break
+                    _, count, _, _, payload_len = struct.unpack_from(DELTA_HEAD_FORMAT, buffer, 0)
+                    if count == 0 or payload_len > DELTA_MAX_PAYLOAD:
+                        buffer = buffer[1:]
+                        continue
+                    frame_len = DELTA_HEAD_LEN + payload_len + 2
+                    if len(buffer) < frame_len:
+                        break
+                    frame = bytes(buffer[:frame_len])
+                    samples = None
+                    if crc16_ccitt(frame[:-2]) == ((frame[-2] << 8) | frame[-1]):
+                        try:
+                            samples = decode_delta_batch(frame)
+                        except (IndexError, ValueError):
+                            samples = None
+                    if samples is not None:
+                        buffer = buffer[frame_len:]
+                        collector.update_batch(frame_len, samples)
+                        collector.print_realtime()
+                    else:
+                        buffer = buffer[1:]
+                        collector.checksum_errors += 1
+                    continue
+                
+                # 批量帧
+                if buffer[:2] == BATCH_HEADER:
+                    count = buffer[2]
+                    frame_len = batch_frame_len(count)
+                    if count == 0:
+                        buffer = buffer[1:]     # 不是有效帧头，跳过继续找
+                        continue
+                    if len(buffer) < frame_len:
+                        break
+                    frame = bytes(buffer[:frame_len])
+                    if crc16_ccitt(frame[:-2]) == ((frame[-2] << 8) | frame[-1]):
+                        buffer = buffer[frame_len:]
+                        collector.update_batch(frame_len, decode_batch(frame))
+                        collector.print_realtime()
+                    else:
+                        buffer = buffer[1:]     # 校验失败，从下一个字节重新同步
+                        collector.checksum_errors += 1
+                    continue
+                
                 # 检查是否有完整的包
                 if len(buffer) < PACKET_SIZE:
                     break
@@ -239,13 +1025,10 @@ def receive_data(duration_seconds=30, output_file='result.json'):
                 buffer = buffer[PACKET_SIZE:]
                 
                 # 校验和检查
-                expected_checksum = calculate_checksum(packet_bytes)
-                
                 try:
                     packet_data = struct.unpack(PACKET_FORMAT, packet_bytes)
-                    actual_checksum = packet_data[-2]
                     
-                    if actual_checksum == expected_checksum:
+                    if verify_packet(packet_bytes):
                         collector.update(packet_data)
                         collector.print_realtime()
                     else:
@@ -257,6 +1040,12 @@ def receive_data(duration_seconds=30, output_file='result.json'):
             
             time.sleep(0.001)
         
+        if collector.arq is not None:
+            ser.write(link_frame(LINK_CMD_ARQ, 0))  # 关掉可靠模式，固件不用等 ACK 超时
+        if collector.stripe is not None:
+            ser.write(link_frame(LINK_CMD_STRIPE, 0))   # 遥测回到只走 UART1
+        if ser2 is not None:
+            ser2.close()
         ser.close()
         
     except serial.SerialException as e:
@@ -316,11 +1105,39 @@ def print_summary(stats):
             cpu_usage = (p['process_time_ms']['mean'] + p['send_time_ms']['mean']) / stats['timing']['mean_interval_ms'] * 100
             print(f"  CPU 使用率: {cpu_usage:.1f}% (估算)")
     
+    # 可靠模式
+    if 'reliable' in stats:
+        r = stats['reliable']
+        print(f"\n【可靠模式】")
+        print(f"  交付帧数:   {r['delivered_frames']} (窗口 {r['window']})")
+        print(f"  重复 / 丢失: {r['duplicates']} / {r['skipped_frames']}")
+        print(f"  坏帧:       {r['bad_frames']}")
+        print(f"  ACK:        {r['acks_sent']}")
+    
+    # 时间基准
+    if 'timebase' in stats:
+        r = stats['timebase']
+        print(f"\n【时间基准】")
+        print(f"  基准帧:     {r['frames']}")
+        print(f"  64 位计数:  {r['last_ticks']} (回绕 {r['wraps']} 次，{ticks_to_ms(r['last_ticks']) / 3600000:.2f} 小时)")
+        if r['gpt_hz']:
+            source = '对 RTC 标定' if r['calibrated'] else '标称值，固件标定失败'
+            print(f"  GPT 频率:   {r['gpt_hz']} Hz（{source}）")
+    
+    # 条带化
+    if 'stripe' in stats:
+        r = stats['stripe']
+        print(f"\n【条带化】")
+        print(f"  合并帧数:   {r['delivered_frames']} ({r['links']} 条链路，各链路 "
+              f"{' / '.join(str(n) for n in r['link_frames'])})")
+        print(f"  丢失 / 迟到: {r['lost_frames']} / {r['late_frames']}")
+        print(f"  坏帧:       {r['bad_frames']}")
+    
     print("\n" + "="*60)
 
 # ==================== 命令行入口 ====================
 def main():
-    global SERIAL_PORT  # 声明全局变量
+    global SERIAL_PORT, CHECK_MODE, MIN_INTERVAL_MS, FRAMING, TARGET_BAUD, RTSCTS, RELIABLE, STRIPE_PORT  # 声明全局变量
     
     parser = argparse.ArgumentParser(description='通用数据接收器')
     parser.add_argument('--duration', type=int, default=30, 
@@ -329,11 +1146,36 @@ def main():
                         help='输出文件名，默认 result.json')
     parser.add_argument('--port', type=str, default=SERIAL_PORT, 
                         help=f'串口号，默认 {SERIAL_PORT}')
+    parser.add_argument('--check', type=str, default=CHECK_MODE, choices=['sum8', 'crc16'],
+                        help=f'校验方式（与固件 PACKET_CHECK_MODE 一致），默认 {CHECK_MODE}')
+    parser.add_argument('--min-interval', type=float, default=MIN_INTERVAL_MS,
+                        help=f'采样间隔过滤下限（ms），默认 {MIN_INTERVAL_MS}，高采样率时调小')
+    parser.add_argument('--framing', type=str, default=FRAMING, choices=['raw', 'cobs'],
+                        help=f'帧格式（与固件 SENSOR_COBS_FRAMING 一致），默认 {FRAMING}')
+    parser.add_argument('--baud', type=int, default=None, choices=LINK_BAUDS,
+                        help=f'与固件协商的波特率（从 {BAUD_RATE} 起步），默认不协商')
+    parser.add_argument('--rtscts', action='store_true',
+                        help='打开 RTS/CTS 硬件流控（与固件 SENSOR_UART_FLOW_CONTROL 一致）')
+    parser.add_argument('--reliable', action='store_true',
+                        help='打开选择重传（固件 SENSOR_UART_RELIABLE=1，需要 --framing cobs）')
+    parser.add_argument('--stripe', type=str, default=None, metavar='PORT2',
+                        help='第二个串口（接 UART3），遥测分两路发送后合并（固件 SENSOR_UART_STRIPE=1，需要 --framing cobs）')
     
     args = parser.parse_args()
+    if args.reliable and args.framing != 'cobs':
+        parser.error('--reliable 需要 --framing cobs')
+    if args.stripe and (args.framing != 'cobs' or args.reliable):
+        parser.error('--stripe 需要 --framing cobs，且不能和 --reliable 同时使用')
     
     # 更新全局串口配置
     SERIAL_PORT = args.port
+    CHECK_MODE = args.check
+    MIN_INTERVAL_MS = args.min_interval
+    FRAMING = args.framing
+    TARGET_BAUD = args.baud
+    RTSCTS = args.rtscts
+    RELIABLE = args.reliable
+    STRIPE_PORT = args.stripe
     
     # 接收数据
     stats = receive_data(args.duration, args.output)
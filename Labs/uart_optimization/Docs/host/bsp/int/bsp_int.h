@@ -0,0 +1,10 @@
+#ifndef _BSP_INT_H
+#define _BSP_INT_H
+
+#include "../../imx6ul/imx6ul.h"
+
+typedef void (*system_irq_handler_t)(unsigned int giccIar, void *param);
+
+void system_register_irqhandler(IRQn_Type irq, system_irq_handler_t handler, void *userParam);
+
+#endif // _BSP_INT_H
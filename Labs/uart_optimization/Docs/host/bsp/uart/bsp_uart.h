@@ -0,0 +1,7 @@
+#ifndef _BSP_UART_H
+#define _BSP_UART_H
+
+#include "../../imx6ul/imx6ul.h"
+// UART1 的初始化（115200 8N1）由 sim_reset() 代替
+
+#endif // _BSP_UART_H
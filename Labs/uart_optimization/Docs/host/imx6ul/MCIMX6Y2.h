@@ -0,0 +1,70 @@
+#ifndef _MCIMX6Y2_H
+#define _MCIMX6Y2_H
+
+#include <stdint.h>
+// ==================== 主机仿真：外设寄存器定义 ====================
+// 只保留 Stage 3 链路代码用到的部分；实例指向 sim_uart.c 里的寄存器块
+
+#define __I     volatile const
+#define __O     volatile
+#define __IO    volatile
+
+typedef struct {
+    __I  uint32_t URXD;
+    uint8_t RESERVED_0[60];
+    __IO uint32_t UTXD;
+    uint8_t RESERVED_1[60];
+    __IO uint32_t UCR1;
+    __IO uint32_t UCR2;
+    __IO uint32_t UCR3;
+    __IO uint32_t UCR4;
+    __IO uint32_t UFCR;
+    __IO uint32_t USR1;
+    __IO uint32_t USR2;
+    __IO uint32_t UESC;
+    __IO uint32_t UTIM;
+    __IO uint32_t UBIR;
+    __IO uint32_t UBMR;
+    __I  uint32_t UBRC;
+    __IO uint32_t ONEMS;
+    __IO uint32_t UTS;
+    __IO uint32_t UMCR;
+} UART_Type;
+
+typedef struct {
+    __IO uint32_t CR;
+    __IO uint32_t PR;
+    __IO uint32_t SR;
+    __IO uint32_t IR;
+    __IO uint32_t OCR[3];
+    __I  uint32_t ICR[2];
+    __IO uint32_t CNT;
+} GPT_Type;
+
+typedef enum {
+    UART1_IRQn = 58,
+    UART2_IRQn = 59,
+    UART3_IRQn = 60,
+    UART4_IRQn = 61,
+    UART5_IRQn = 62,
+    GPT1_IRQn = 87,
+    GPT2_IRQn = 88,
+} IRQn_Type;
+
+extern UART_Type *UART1, *UART2, *UART3, *UART4, *UART5;
+extern GPT_Type *GPT1, *GPT2;
+
+void GIC_EnableIRQ(IRQn_Type irq);
+void GIC_DisableIRQ(IRQn_Type irq);
+void GIC_SetPriority(IRQn_Type irq, uint32_t priority);
+
+// 引脚复用：参数个数与 fsl_iomuxc.h 相同，仿真里什么也不做
+#define IOMUXC_UART1_RTS_B_UART1_RTS_B      0, 0, 0, 0, 0
+#define IOMUXC_UART3_TX_DATA_UART3_TX       0, 0, 0, 0, 0
+
+void IOMUXC_SetPinMux(uint32_t muxRegister, uint32_t muxMode, uint32_t inputRegister,
+                      uint32_t inputDaisy, uint32_t configRegister, uint32_t inputOnfield);
+void IOMUXC_SetPinConfig(uint32_t muxRegister, uint32_t muxMode, uint32_t inputRegister,
+                         uint32_t inputDaisy, uint32_t configRegister, uint32_t configValue);
+
+#endif // _MCIMX6Y2_H
@@ -0,0 +1,7 @@
+#ifndef _IMX6UL_H
+#define _IMX6UL_H
+
+#include "../stdio/include/types.h"
+#include "MCIMX6Y2.h"
+
+#endif // _IMX6UL_H
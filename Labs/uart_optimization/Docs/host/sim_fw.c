@@ -0,0 +1,108 @@
+#include <stddef.h>
+#include "../bsp/uart/bsp_uart_async.h"
+#include "../bsp/uart/bsp_uart_channel.h"
+#include "../project/link_control.h"
+#include "../project/link_arq.h"
+#include "../project/link_stripe.h"
+#include "../project/baseline.h"
+
+// ==================== baseline.c 的替身 ====================
+// packet_crc.c 引用，Stage 1 的主循环不参与编译
+
+uint8_t calculate_checksum(sensor_packet_t *pkt)
+{
+    uint8_t sum = 0;
+    uint8_t *p = (uint8_t *)pkt;
+    uint32_t i;
+
+    for (i = 0; i < sizeof(sensor_packet_t) - 2; i++) {
+        sum += p[i];
+    }
+    return sum;
+}
+
+uint32_t get_system_tick(void)
+{
+    return UART_ASYNC_NOW();
+}
+
+// ==================== 统计结构体字段表 ====================
+// fw_host.py 按名字读固件的统计结构体（xxx_get_stats() 返回的指针 + 偏移），
+// 偏移由编译器算，结构体改了这里编译不过，不会读错位置
+
+typedef struct {
+    const char *group;
+    const char *name;
+    uint32_t offset;
+} sim_field_t;
+
+#define FIELD(group, type, member)  { group, #member, offsetof(type, member) }
+
+static const sim_field_t sim_fields[] = {
+    FIELD("uart", uart_async_stats_t, total_bytes),
+    FIELD("uart", uart_async_stats_t, total_packets),
+    FIELD("uart", uart_async_stats_t, total_interrupts),
+    FIELD("uart", uart_async_stats_t, errors),
+    FIELD("uart", uart_async_stats_t, irq_bytes),
+    FIELD("uart", uart_async_stats_t, max_bytes_per_irq),
+    FIELD("uart", uart_async_stats_t, queue_high_water),
+    FIELD("uart", uart_async_stats_t, tx_throttled),
+    FIELD("uart", uart_async_stats_t, tx_throttle_events),
+    FIELD("uart", uart_async_stats_t, tx_throttled_ticks),
+    FIELD("uart", uart_async_stats_t, tx_last_enqueue),
+    FIELD("uart", uart_async_stats_t, tx_last_first),
+    FIELD("uart", uart_async_stats_t, tx_last_done),
+    FIELD("uart", uart_async_stats_t, tx_queue_lat.count),
+    FIELD("uart", uart_async_stats_t, tx_queue_lat.max),
+    FIELD("uart", uart_async_stats_t, tx_wire_lat.count),
+    FIELD("uart", uart_async_stats_t, tx_wire_lat.max),
+    FIELD("uart", uart_async_stats_t, tx_total_lat.count),
+    FIELD("uart", uart_async_stats_t, tx_total_lat.max),
+    FIELD("uart", uart_async_stats_t, rx_bytes),
+    FIELD("uart", uart_async_stats_t, rx_interrupts),
+    FIELD("uart", uart_async_stats_t, rx_idle_events),
+    FIELD("uart", uart_async_stats_t, rx_overruns),
+    FIELD("uart", uart_async_stats_t, rx_dropped),
+    FIELD("uart", uart_async_stats_t, rx_errors),
+
+    FIELD("channel", uart_channel_stats_t, frames[UART_CHANNEL_CONTROL]),
+    FIELD("channel", uart_channel_stats_t, frames[UART_CHANNEL_TELEMETRY]),
+    FIELD("channel", uart_channel_stats_t, frames[UART_CHANNEL_LOG]),
+    FIELD("channel", uart_channel_stats_t, busy[UART_CHANNEL_TELEMETRY]),
+    FIELD("channel", uart_channel_stats_t, log_lines),
+    FIELD("channel", uart_channel_stats_t, log_dropped),
+
+    FIELD("link", link_control_stats_t, frames),
+    FIELD("link", link_control_stats_t, bad_frames),
+    FIELD("link", link_control_stats_t, switches),
+    FIELD("link", link_control_stats_t, rejects),
+    FIELD("link", link_control_stats_t, fallbacks),
+
+    FIELD("arq", link_arq_stats_t, frames),
+    FIELD("arq", link_arq_stats_t, retransmits),
+    FIELD("arq", link_arq_stats_t, timeouts),
+    FIELD("arq", link_arq_stats_t, abandoned),
+    FIELD("arq", link_arq_stats_t, acks),
+    FIELD("arq", link_arq_stats_t, window_full),
+    FIELD("arq", link_arq_stats_t, window_high_water),
+    FIELD("arq", link_arq_stats_t, fallbacks),
+    FIELD("arq", link_arq_stats_t, rto),
+
+    FIELD("stripe", link_stripe_stats_t, frames[0]),
+    FIELD("stripe", link_stripe_stats_t, frames[1]),
+    FIELD("stripe", link_stripe_stats_t, bytes[0]),
+    FIELD("stripe", link_stripe_stats_t, bytes[1]),
+    FIELD("stripe", link_stripe_stats_t, stalls),
+    FIELD("stripe", link_stripe_stats_t, enables),
+};
+
+// 第 i 个字段，超出范围返回 NULL
+const char *sim_field(uint32_t i, const char **group, uint32_t *offset)
+{
+    if (i >= sizeof(sim_fields) / sizeof(sim_fields[0])) {
+        return NULL;
+    }
+    *group = sim_fields[i].group;
+    *offset = sim_fields[i].offset;
+    return sim_fields[i].name;
+}
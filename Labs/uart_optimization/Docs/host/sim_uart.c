@@ -0,0 +1,707 @@
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../imx6ul/imx6ul.h"
+#include "../bsp/int/bsp_int.h"
+
+// ==================== Private Variables ====================
+
+typedef struct {
+    double t;
+    uint32_t value;
+} sim_rx_byte_t;
+
+typedef struct {
+    UART_Type *regs;
+
+    // TX：FIFO + 移位寄存器，发完的字节记进 log 等 sim_uart_tx_take() 取走
+    uint8_t tx_fifo[SIM_UART_FIFO_SIZE];
+    uint32_t tx_rd, tx_count;
+    int shifting;
+    uint8_t shift_byte;
+    double shift_start, shift_end;
+    uint8_t *log_data;
+    double *log_start, *log_end;
+    uint32_t log_len, log_cap;
+
+    // RX：上位机发来、还没到时间的字节排在 rx_queue 里
+    uint32_t rx_fifo[SIM_UART_FIFO_SIZE];
+    uint32_t rx_rd, rx_count;
+    sim_rx_byte_t *rx_queue;
+    uint32_t rx_q_head, rx_q_len, rx_q_cap;
+    double last_rx;                 // 最近收到字节的时刻（空闲检测起点）
+    double last_activity;           // 最近收到 / 读走字节的时刻（老化计时起点）
+    int idle_armed;                 // 收到过字节、还没报告空闲
+
+    // 锁存的状态位
+    int agtim, idle, ore, rtsd;
+    int rts;                        // 上位机 RTS 有效
+    int hold_reset;
+
+    // 中断
+    int auto_irq;
+    int pending;
+    double pending_since;
+
+    uint32_t hw_lost, ore_events, irq_count, tx_overflow;
+} sim_uart_t;
+
+static UART_Type sim_regs[SIM_UART_COUNT];
+static GPT_Type sim_gpt[2];
+static sim_uart_t sim_uarts[SIM_UART_COUNT];
+
+static struct {
+    system_irq_handler_t handler;
+    void *param;
+    int enabled;
+} sim_irqs[160];
+
+static double sim_t;
+static uint32_t sim_hz = 645000;
+static uint32_t sim_tick_offset;
+static int sim_in_irq;
+static int sim_in_run;
+static int sim_verbose;
+static char sim_console[SIM_CONSOLE_SIZE];     // 固件 printf 的输出，等 sim_console_take() 取走
+static uint32_t sim_console_len;
+
+UART_Type *UART1 = &sim_regs[0];
+UART_Type *UART2 = &sim_regs[1];
+UART_Type *UART3 = &sim_regs[2];
+UART_Type *UART4 = &sim_regs[3];
+UART_Type *UART5 = &sim_regs[4];
+GPT_Type *GPT1 = &sim_gpt[0];
+GPT_Type *GPT2 = &sim_gpt[1];
+
+// ==================== Private Functions ====================
+
+static sim_uart_t *uart_of(volatile void *regs)
+{
+    return &sim_uarts[(UART_Type *)regs - sim_regs];
+}
+
+static int uart_irq_number(sim_uart_t *u)
+{
+    return UART1_IRQn + (int)(u - sim_uarts);
+}
+
+// 按分频寄存器算波特率：ref / RFDIV x (UBIR + 1) / (16 x (UBMR + 1))
+static double uart_baud(sim_uart_t *u)
+{
+    static const uint32_t rfdiv[8] = { 6, 5, 4, 3, 2, 1, 7, 1 };
+    uint32_t div = rfdiv[(u->regs->UFCR >> 7) & 7];
+
+    return (double)SIM_UART_REF_CLK_HZ / div * (u->regs->UBIR + 1) / (16.0 * (u->regs->UBMR + 1));
+}
+
+// 一个字符的时间：起始位 + 7/8 数据位（UCR2.WS）+ 校验位（UCR2.PREN）+ 1/2 停止位（UCR2.STPB）
+static double uart_char_time(sim_uart_t *u)
+{
+    uint32_t ucr2 = u->regs->UCR2;
+    uint32_t bits = 1 + ((ucr2 & (1 << 5)) ? 8 : 7) + ((ucr2 & (1 << 8)) ? 1 : 0) + ((ucr2 & (1 << 6)) ? 2 : 1);
+
+    return bits / uart_baud(u);
+}
+
+static int uart_tx_on(sim_uart_t *u)
+{
+    return (u->regs->UCR1 & (1 << 0)) && (u->regs->UCR2 & (1 << 2)) && (u->regs->UCR2 & (1 << 0));
+}
+
+static int uart_rx_on(sim_uart_t *u)
+{
+    return (u->regs->UCR1 & (1 << 0)) && (u->regs->UCR2 & (1 << 1)) && (u->regs->UCR2 & (1 << 0));
+}
+
+// 老化：FIFO 非空、UCR2.ATEN，8 个字符时间没有收发
+static double uart_aging_deadline(sim_uart_t *u)
+{
+    if (u->agtim || u->rx_count == 0 || !(u->regs->UCR2 & (1 << 3))) {
+        return INFINITY;
+    }
+    return u->last_activity + 8 * uart_char_time(u);
+}
+
+// 空闲：UCR1.ICD = 00 / 01 / 10 / 11 对应 4 / 8 / 16 / 32 个字符时间
+static double uart_idle_deadline(sim_uart_t *u)
+{
+    if (!u->idle_armed) {
+        return INFINITY;
+    }
+    return u->last_rx + (4 << ((u->regs->UCR1 >> 10) & 3)) * uart_char_time(u);
+}
+
+static double uart_next_event(sim_uart_t *u)
+{
+    double t = u->shifting ? u->shift_end : INFINITY;
+    double d;
+
+    if (u->rx_q_head < u->rx_q_len && u->rx_queue[u->rx_q_head].t < t) {
+        t = u->rx_queue[u->rx_q_head].t;
+    }
+    d = uart_aging_deadline(u);
+    if (d < t) {
+        t = d;
+    }
+    d = uart_idle_deadline(u);
+    if (d < t) {
+        t = d;
+    }
+    return t;
+}
+
+static void uart_log_byte(sim_uart_t *u, uint8_t b, double start, double end)
+{
+    if (u->log_len == u->log_cap) {
+        u->log_cap = u->log_cap ? u->log_cap * 2 : 4096;
+        u->log_data = realloc(u->log_data, u->log_cap);
+        u->log_start = realloc(u->log_start, u->log_cap * sizeof(double));
+        u->log_end = realloc(u->log_end, u->log_cap * sizeof(double));
+    }
+    u->log_data[u->log_len] = b;
+    u->log_start[u->log_len] = start;
+    u->log_end[u->log_len] = end;
+    u->log_len++;
+}
+
+// 移位寄存器空闲、FIFO 有数据、RTS 允许（UCR2.IRTS = 1 时忽略 RTS）时开始发下一个字符
+static void uart_tx_start(sim_uart_t *u, double t)
+{
+    if (u->shifting || u->tx_count == 0 || !uart_tx_on(u)) {
+        return;
+    }
+    if (!(u->regs->UCR2 & (1 << 14)) && !u->rts) {
+        return;
+    }
+    u->shift_byte = u->tx_fifo[u->tx_rd];
+    u->tx_rd = (u->tx_rd + 1) % SIM_UART_FIFO_SIZE;
+    u->tx_count--;
+    u->shifting = 1;
+    u->shift_start = t;
+    u->shift_end = t + uart_char_time(u);
+}
+
+static void uart_rx_arrive(sim_uart_t *u)
+{
+    sim_rx_byte_t *b = &u->rx_queue[u->rx_q_head++];
+
+    if (!uart_rx_on(u)) {
+        u->hw_lost++;
+        return;
+    }
+    if (u->rx_count >= SIM_UART_FIFO_SIZE) {
+        u->hw_lost++;
+        if (!u->ore) {
+            u->ore = 1;
+            u->ore_events++;
+        }
+    } else {
+        u->rx_fifo[(u->rx_rd + u->rx_count) % SIM_UART_FIFO_SIZE] = b->value | (1 << 15);
+        u->rx_count++;
+    }
+    u->last_rx = b->t;
+    u->last_activity = b->t;
+    u->idle_armed = 1;
+}
+
+// UCR2.SRST 写 0：清空 FIFO 和状态，推进时间时完成（SRST 读回 1）
+static void uart_soft_reset(sim_uart_t *u)
+{
+    if ((u->regs->UCR2 & (1 << 0)) || u->hold_reset) {
+        return;
+    }
+    u->tx_count = 0;
+    u->shifting = 0;
+    u->rx_count = 0;
+    u->idle_armed = 0;
+    u->agtim = u->idle = u->ore = u->rtsd = 0;
+    u->regs->UCR2 |= (1 << 0);
+}
+
+// 处理 now 之前到期的事件（按时间顺序）
+static void uart_update(sim_uart_t *u, double now)
+{
+    for (;;) {
+        double t_tx = u->shifting ? u->shift_end : INFINITY;
+        double t_rx = (u->rx_q_head < u->rx_q_len) ? u->rx_queue[u->rx_q_head].t : INFINITY;
+        double t_age = uart_aging_deadline(u);
+        double t_idle = uart_idle_deadline(u);
+
+        if (t_tx <= now && t_tx <= t_rx && t_tx <= t_age && t_tx <= t_idle) {
+            uart_log_byte(u, u->shift_byte, u->shift_start, u->shift_end);
+            u->shifting = 0;
+            uart_tx_start(u, t_tx);
+        } else if (t_rx <= now && t_rx <= t_age && t_rx <= t_idle) {
+            uart_rx_arrive(u);
+        } else if (t_age <= now && t_age <= t_idle) {
+            u->agtim = 1;
+        } else if (t_idle <= now) {
+            u->idle = 1;
+            u->idle_armed = 0;
+        } else {
+            break;
+        }
+    }
+    uart_tx_start(u, now);
+}
+
+// 状态寄存器
+static void uart_publish(sim_uart_t *u)
+{
+    uint32_t txtl = (u->regs->UFCR >> 10) & 0x3F;
+    uint32_t rxtl = u->regs->UFCR & 0x3F;
+    uint32_t usr1 = 0, usr2 = 0, uts = 0;
+
+    if (u->rts) {
+        usr1 |= (1 << 14);                      // RTSS
+    }
+    if (u->tx_count <= txtl) {
+        usr1 |= (1 << 13);                      // TRDY
+    }
+    if (u->rtsd) {
+        usr1 |= (1 << 12);                      // RTSD
+    }
+    if (u->rx_count > 0 && u->rx_count >= rxtl) {
+        usr1 |= (1 << 9);                       // RRDY
+    }
+    if (u->agtim) {
+        usr1 |= (1 << 8);                       // AGTIM
+    }
+    if (u->tx_count == 0) {
+        usr2 |= (1 << 14);                      // TXFE
+    }
+    if (u->idle) {
+        usr2 |= (1 << 12);                      // IDLE
+    }
+    if (u->tx_count == 0 && !u->shifting) {
+        usr2 |= (1 << 3);                       // TXDC
+    }
+    if (u->ore) {
+        usr2 |= (1 << 1);                       // ORE
+    }
+    if (u->rx_count > 0) {
+        usr2 |= (1 << 0);                       // RDR
+    }
+    if (u->tx_count >= SIM_UART_FIFO_SIZE) {
+        uts |= (1 << 4);                        // TXFULL
+    }
+    if (u->rx_count == 0) {
+        uts |= (1 << 5);                        // RXEMPTY
+    }
+    if (u->tx_count == 0) {
+        uts |= (1 << 6);                        // TXEMPTY
+    }
+    u->regs->USR1 = usr1;
+    u->regs->USR2 = usr2;
+    u->regs->UTS = uts;
+}
+
+static int uart_irq_condition(sim_uart_t *u)
+{
+    uint32_t usr1 = u->regs->USR1, usr2 = u->regs->USR2;
+    uint32_t ucr1 = u->regs->UCR1, ucr2 = u->regs->UCR2, ucr4 = u->regs->UCR4;
+
+    return ((usr1 & (1 << 13)) && (ucr1 & (1 << 13))) ||   // TRDY / TRDYEN
+           ((usr1 & (1 << 9)) && (ucr1 & (1 << 9))) ||     // RRDY / RRDYEN
+           ((usr1 & (1 << 8)) && (ucr2 & (1 << 3))) ||     // AGTIM / ATEN
+           ((usr1 & (1 << 12)) && (ucr1 & (1 << 5))) ||    // RTSD / RTSDEN
+           ((usr2 & (1 << 12)) && (ucr1 & (1 << 12))) ||   // IDLE / IDEN
+           ((usr2 & (1 << 1)) && (ucr4 & (1 << 1))) ||     // ORE / OREN
+           ((usr2 & (1 << 3)) && (ucr4 & (1 << 3)));       // TXDC / TCEN
+}
+
+static int uart_irq_ready(sim_uart_t *u)
+{
+    int irq = uart_irq_number(u);
+    return sim_irqs[irq].handler != NULL && sim_irqs[irq].enabled && uart_irq_condition(u);
+}
+
+static void uart_track_pending(sim_uart_t *u)
+{
+    int p = uart_irq_ready(u);
+
+    if (p && !u->pending) {
+        u->pending_since = sim_t;
+    }
+    u->pending = p;
+}
+
+static void uart_enter_irq(sim_uart_t *u)
+{
+    int irq = uart_irq_number(u);
+
+    u->irq_count++;
+    sim_in_irq++;
+    sim_irqs[irq].handler((unsigned int)irq, sim_irqs[irq].param);
+    sim_in_irq--;
+    uart_update(u, sim_t);
+    uart_publish(u);
+    // 出中断时条件仍然成立（例如还有数据要发）：从现在起重新计延迟
+    u->pending = 0;
+    uart_track_pending(u);
+}
+
+// 处理当前时刻：更新状态，自动模式下进中断
+static void sim_service(void)
+{
+    int i, round;
+
+    for (i = 0; i < SIM_UART_COUNT; i++) {
+        uart_soft_reset(&sim_uarts[i]);
+        uart_update(&sim_uarts[i], sim_t);
+        uart_publish(&sim_uarts[i]);
+    }
+    // 处理函数没有清掉条件时最多重进几次，避免死循环
+    for (round = 0; round < 8; round++) {
+        int entered = 0;
+        for (i = 0; i < SIM_UART_COUNT; i++) {
+            sim_uart_t *u = &sim_uarts[i];
+            if (u->auto_irq && !sim_in_irq && uart_irq_ready(u)) {
+                uart_enter_irq(u);
+                entered = 1;
+            }
+        }
+        if (!entered) {
+            break;
+        }
+    }
+    for (i = 0; i < SIM_UART_COUNT; i++) {
+        uart_track_pending(&sim_uarts[i]);
+    }
+    GPT1->CNT = sim_ticks();
+}
+
+// ==================== Firmware Hooks ====================
+
+uint32_t sim_fw_ticks(void)
+{
+    if (!sim_in_irq && !sim_in_run) {
+        sim_run(sim_t + SIM_NOW_STEP);
+    }
+    return sim_ticks();
+}
+
+uint32_t sim_uart_read_rxd(volatile void *regs)
+{
+    sim_uart_t *u = uart_of(regs);
+    uint32_t value = 0;
+
+    if (u->rx_count > 0) {
+        value = u->rx_fifo[u->rx_rd];
+        u->rx_rd = (u->rx_rd + 1) % SIM_UART_FIFO_SIZE;
+        u->rx_count--;
+        u->last_activity = sim_t;
+    }
+    uart_publish(u);
+    return value;
+}
+
+void sim_uart_write_txd(volatile void *regs, uint32_t value)
+{
+    sim_uart_t *u = uart_of(regs);
+
+    if (!uart_tx_on(u)) {
+        return;
+    }
+    if (u->tx_count >= SIM_UART_FIFO_SIZE) {
+        u->tx_overflow++;
+    } else {
+        u->tx_fifo[(u->tx_rd + u->tx_count) % SIM_UART_FIFO_SIZE] = (uint8_t)value;
+        u->tx_count++;
+    }
+    uart_tx_start(u, sim_t);
+    uart_publish(u);
+}
+
+void sim_uart_clear(volatile void *regs, int reg, uint32_t bits)
+{
+    sim_uart_t *u = uart_of(regs);
+
+    if (reg == 1) {
+        if (bits & (1 << 8)) {
+            u->agtim = 0;
+            u->last_activity = sim_t;   // 老化重新计时
+        }
+        if (bits & (1 << 12)) {
+            u->rtsd = 0;
+        }
+    } else {
+        if (bits & (1 << 1)) {
+            u->ore = 0;
+        }
+        if (bits & (1 << 12)) {
+            u->idle = 0;
+        }
+    }
+    uart_publish(u);
+}
+
+// ==================== Platform Stubs ====================
+
+void system_register_irqhandler(IRQn_Type irq, system_irq_handler_t handler, void *userParam)
+{
+    sim_irqs[irq].handler = handler;
+    sim_irqs[irq].param = userParam;
+}
+
+void GIC_EnableIRQ(IRQn_Type irq)
+{
+    sim_irqs[irq].enabled = 1;
+}
+
+void GIC_DisableIRQ(IRQn_Type irq)
+{
+    sim_irqs[irq].enabled = 0;
+}
+
+void GIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+}
+
+void IOMUXC_SetPinMux(uint32_t muxRegister, uint32_t muxMode, uint32_t inputRegister,
+                      uint32_t inputDaisy, uint32_t configRegister, uint32_t inputOnfield)
+{
+}
+
+void IOMUXC_SetPinConfig(uint32_t muxRegister, uint32_t muxMode, uint32_t inputRegister,
+                         uint32_t inputDaisy, uint32_t configRegister, uint32_t configValue)
+{
+}
+
+uint32_t timebase_rate_hz(void)
+{
+    return sim_hz;
+}
+
+uint32_t timebase_cycles(void)
+{
+    return 0;                           // 主机上不跑周期微基准
+}
+
+int sim_printf(const char *fmt, ...)
+{
+    char line[512];
+    va_list args;
+    int n;
+    uint32_t len;
+
+    va_start(args, fmt);
+    n = vsnprintf(line, sizeof line, fmt, args);
+    va_end(args);
+    if (n < 0) {
+        return n;
+    }
+    len = ((uint32_t)n < sizeof line) ? (uint32_t)n : sizeof line - 1;
+    if (len > SIM_CONSOLE_SIZE - sim_console_len) {
+        len = SIM_CONSOLE_SIZE - sim_console_len;     // 满了丢掉多出来的部分
+    }
+    memcpy(&sim_console[sim_console_len], line, len);
+    sim_console_len += len;
+    if (sim_verbose) {
+        fputs(line, stdout);
+    }
+    return n;
+}
+
+// ==================== Simulator API ====================
+
+void sim_reset(uint32_t gpt_hz, uint32_t tick_offset)
+{
+    int i;
+
+    for (i = 0; i < SIM_UART_COUNT; i++) {
+        sim_uart_t *u = &sim_uarts[i];
+        free(u->log_data);
+        free(u->log_start);
+        free(u->log_end);
+        free(u->rx_queue);
+        memset(u, 0, sizeof(*u));
+        memset(&sim_regs[i], 0, sizeof(sim_regs[i]));
+        u->regs = &sim_regs[i];
+        u->auto_irq = 1;
+        // 复位值：SRST 读回 1，UFCR 的 RXTL = 1 / TXTL = 2 / RFDIV = /6
+        sim_regs[i].UCR2 = (1 << 0);
+        sim_regs[i].UFCR = (2 << 10) | 1;
+    }
+    memset(sim_irqs, 0, sizeof(sim_irqs));
+    memset(sim_gpt, 0, sizeof(sim_gpt));
+
+    // UART1：BSP uart_init() 之后的状态（115200 8N1，忽略 RTS，收发使能）
+    UART1->UCR1 = (1 << 0);
+    UART1->UCR2 |= (1 << 14) | (1 << 5) | (1 << 2) | (1 << 1);
+    UART1->UCR3 = (1 << 2);
+    UART1->UFCR = (2 << 10) | (5 << 7) | 1;
+    UART1->UBIR = 71;
+    UART1->UBMR = 3124;
+
+    sim_console_len = 0;
+    sim_t = 0;
+    sim_hz = gpt_hz;
+    sim_tick_offset = tick_offset;
+    sim_in_irq = 0;
+    sim_in_run = 0;
+    sim_service();
+}
+
+uint32_t sim_console_take(char *buf, uint32_t max)
+{
+    uint32_t n = (sim_console_len < max) ? sim_console_len : max;
+
+    memcpy(buf, sim_console, n);
+    memmove(sim_console, &sim_console[n], sim_console_len - n);
+    sim_console_len -= n;
+    return n;
+}
+
+void sim_set_verbose(int on)
+{
+    sim_verbose = on;
+}
+
+double sim_now(void)
+{
+    return sim_t;
+}
+
+uint32_t sim_ticks(void)
+{
+    return sim_tick_offset + (uint32_t)(uint64_t)floor(sim_t * sim_hz);
+}
+
+void sim_run(double until)
+{
+    int i;
+
+    sim_in_run++;
+    for (;;) {
+        double next = until;
+        sim_service();
+        if (sim_t >= until) {
+            break;
+        }
+        for (i = 0; i < SIM_UART_COUNT; i++) {
+            double t = uart_next_event(&sim_uarts[i]);
+            if (t < next) {
+                next = t;
+            }
+        }
+        sim_t = (next > sim_t) ? next : until;
+    }
+    sim_in_run--;
+}
+
+void sim_uart_rx(int n, double t, uint32_t value)
+{
+    sim_uart_t *u = &sim_uarts[n - 1];
+
+    if (u->rx_q_head > 0 && u->rx_q_head == u->rx_q_len) {
+        u->rx_q_head = u->rx_q_len = 0;
+    }
+    if (u->rx_q_len == u->rx_q_cap) {
+        if (u->rx_q_head > 0) {
+            memmove(u->rx_queue, &u->rx_queue[u->rx_q_head],
+                    (u->rx_q_len - u->rx_q_head) * sizeof(sim_rx_byte_t));
+            u->rx_q_len -= u->rx_q_head;
+            u->rx_q_head = 0;
+        } else {
+            u->rx_q_cap = u->rx_q_cap ? u->rx_q_cap * 2 : 1024;
+            u->rx_queue = realloc(u->rx_queue, u->rx_q_cap * sizeof(sim_rx_byte_t));
+        }
+    }
+    if (t < sim_t) {
+        t = sim_t;
+    }
+    if (u->rx_q_len > 0 && t < u->rx_queue[u->rx_q_len - 1].t) {
+        t = u->rx_queue[u->rx_q_len - 1].t;
+    }
+    u->rx_queue[u->rx_q_len].t = t;
+    u->rx_queue[u->rx_q_len].value = value;
+    u->rx_q_len++;
+}
+
+uint32_t sim_uart_tx_take(int n, uint8_t *data, double *t_start, double *t_end, uint32_t max)
+{
+    sim_uart_t *u = &sim_uarts[n - 1];
+    uint32_t count = (u->log_len < max) ? u->log_len : max;
+
+    memcpy(data, u->log_data, count);
+    memcpy(t_start, u->log_start, count * sizeof(double));
+    memcpy(t_end, u->log_end, count * sizeof(double));
+    memmove(u->log_data, u->log_data + count, u->log_len - count);
+    memmove(u->log_start, u->log_start + count, (u->log_len - count) * sizeof(double));
+    memmove(u->log_end, u->log_end + count, (u->log_len - count) * sizeof(double));
+    u->log_len -= count;
+    return count;
+}
+
+void sim_uart_set_rts(int n, int asserted)
+{
+    sim_uart_t *u = &sim_uarts[n - 1];
+
+    if (!asserted != !u->rts) {
+        u->rts = !!asserted;
+        u->rtsd = 1;
+    }
+    sim_run(sim_t);
+}
+
+void sim_uart_set_auto_irq(int n, int on)
+{
+    sim_uarts[n - 1].auto_irq = on;
+}
+
+void sim_uart_hold_reset(int n, int on)
+{
+    sim_uarts[n - 1].hold_reset = on;
+}
+
+int sim_uart_irq_pending(int n)
+{
+    return sim_uarts[n - 1].pending;
+}
+
+double sim_uart_irq_since(int n)
+{
+    return sim_uarts[n - 1].pending_since;
+}
+
+void sim_uart_irq(int n)
+{
+    sim_uart_t *u = &sim_uarts[n - 1];
+
+    if (uart_irq_ready(u)) {
+        uart_enter_irq(u);
+    }
+}
+
+uint32_t sim_uart_baud(int n)
+{
+    return (uint32_t)(uart_baud(&sim_uarts[n - 1]) + 0.5);
+}
+
+double sim_uart_char_time(int n)
+{
+    return uart_char_time(&sim_uarts[n - 1]);
+}
+
+uint32_t sim_uart_tx_pending(int n)
+{
+    return sim_uarts[n - 1].tx_count + sim_uarts[n - 1].shifting;
+}
+
+uint32_t sim_uart_hw_lost(int n)
+{
+    return sim_uarts[n - 1].hw_lost;
+}
+
+uint32_t sim_uart_ore_events(int n)
+{
+    return sim_uarts[n - 1].ore_events;
+}
+
+uint32_t sim_uart_irq_count(int n)
+{
+    return sim_uarts[n - 1].irq_count;
+}
@@ -0,0 +1,79 @@
+#ifndef _SIM_UART_H
+#define _SIM_UART_H
+
+#include <stdint.h>
+// ==================== 主机仿真：i.MX UART 寄存器模型 ====================
+// Stage 3 的固件源码原样在主机上编译（fw_host.py），UART1 ~ UART5 指向这里的寄存器块
+// fw_host.py 用 -include 把本文件放在每个源文件最前面，替换 bsp_uart_async.h / link_control.h 里的钩子：
+// - 时间源：UART_ASYNC_NOW() / LINK_CONTROL_NOW() 读仿真时钟（GPT1 tick）
+// - 有副作用的寄存器访问：读 URXD、写 UTXD、USR1 / USR2 写 1 清零，调用 UART 模型
+// 其余寄存器（UCRx / UFCR / UBIR / UBMR）是普通内存，模型在推进时间和每次上面的访问之后
+// 按控制寄存器和分频重新计算 USR1 / USR2 / UTS
+//
+// 模型：32 字节 TX FIFO + 移位寄存器（按 UBIR / UBMR / UFCR.RFDIV 和 UCR2 的帧格式算字符时间）、
+// UCR2.IRTS = 0 时 RTS_B 无效发送器停在字符边界、32 字节 RX FIFO（满了新字节丢失并置 ORE）、
+// 老化（FIFO 非空且 8 个字符时间没有收发）、空闲（收到数据后线路静默 UCR1.ICD 个字符时间）、
+// UCR2.SRST 软复位（清空 FIFO 和状态，下一次推进时间时完成）
+//
+// 时间：仿真时钟只由 sim_run() 推进；固件在主循环上下文读时钟时前进 SIM_NOW_STEP 秒（代码执行时间），
+// 期间到期的 UART 事件照常处理，自动模式下中断照常进入（中断抢占主循环），所以 wait_complete() 这类忙等能退出
+// 中断：自动模式下条件成立（且 GIC 已使能）就调用注册的处理函数；手动模式下由调用者查询
+// sim_uart_irq_pending() / sim_uart_irq_since()，自己决定什么时候 sim_uart_irq()（模拟中断延迟）
+
+// ==================== Configuration ====================
+
+#define SIM_UART_COUNT          5           // UART1 ~ UART5
+#define SIM_UART_FIFO_SIZE      32
+#define SIM_UART_REF_CLK_HZ     80000000    // 与 UART_ASYNC_REF_CLK_HZ 相同
+#define SIM_NOW_STEP            1e-6        // 主循环每读一次时钟前进的时间（秒）
+#define SIM_CONSOLE_SIZE        16384       // 固件 printf 输出的缓冲区
+
+// URXD 的状态位（sim_uart_rx() 的 value）
+#define SIM_URXD_ERR            (1 << 14)
+#define SIM_URXD_FRMERR         (1 << 12)
+
+// 固件里的 ARM 指令在 x86 上汇编成空操作（dmb 屏障、PMU 的 mrc / mcr）
+__asm__(".macro dmb\n.endm\n"
+        ".macro mrc a, b, c, d, e, f\n.endm\n"
+        ".macro mcr a, b, c, d, e, f\n.endm\n");
+
+// ==================== Firmware Hooks ====================
+
+#define UART_ASYNC_NOW()                    sim_fw_ticks()
+#define LINK_CONTROL_NOW()                  sim_fw_ticks()
+#define UART_ASYNC_READ_RXD(regs)           sim_uart_read_rxd(regs)
+#define UART_ASYNC_WRITE_TXD(regs, value)   sim_uart_write_txd(regs, value)
+#define UART_ASYNC_CLEAR_USR1(regs, bits)   sim_uart_clear(regs, 1, bits)
+#define UART_ASYNC_CLEAR_USR2(regs, bits)   sim_uart_clear(regs, 2, bits)
+
+uint32_t sim_fw_ticks(void);
+uint32_t sim_uart_read_rxd(volatile void *regs);
+void sim_uart_write_txd(volatile void *regs, uint32_t value);
+void sim_uart_clear(volatile void *regs, int reg, uint32_t bits);
+
+// ==================== Simulator API（fw_host.py 通过 ctypes 调用）====================
+
+void sim_reset(uint32_t gpt_hz, uint32_t tick_offset);     // 清空所有 UART，时钟回到 0；UART1 处于 uart_init() 之后的状态
+void sim_set_verbose(int on);           // 1=固件的 printf 同时打印到 stdout
+uint32_t sim_console_take(char *buf, uint32_t max);  // 取走固件 printf 的输出（满 SIM_CONSOLE_SIZE 后丢弃）
+double sim_now(void);                   // 仿真时钟（秒）
+uint32_t sim_ticks(void);               // GPT1 计数（tick_offset 起步，32 位回绕）
+void sim_run(double until);             // 推进到 until，处理期间的 UART 事件和（自动模式的）中断
+
+// UART n（1 ~ SIM_UART_COUNT）
+void sim_uart_rx(int n, double t, uint32_t value);         // 上位机发来的字节在 t 时刻收完（t 不递减），value 可带 SIM_URXD_*
+uint32_t sim_uart_tx_take(int n, uint8_t *data, double *t_start, double *t_end, uint32_t max);  // 取走已发完的字节
+void sim_uart_set_rts(int n, int asserted);                 // 上位机的 RTS（接 RTS_B），1=允许发送
+void sim_uart_set_auto_irq(int n, int on);                  // 默认 1
+void sim_uart_hold_reset(int n, int on);                    // 1=软复位一直不结束（模块没有时钟）
+int sim_uart_irq_pending(int n);
+double sim_uart_irq_since(int n);                          // 中断条件从什么时候开始成立
+void sim_uart_irq(int n);                                   // 进一次中断
+uint32_t sim_uart_baud(int n);                              // 按分频寄存器算出的波特率
+double sim_uart_char_time(int n);                           // 一个字符的时间（秒）
+uint32_t sim_uart_tx_pending(int n);                        // FIFO + 移位寄存器里还没发完的字节数
+uint32_t sim_uart_hw_lost(int n);                           // RX FIFO 满时丢失的字节数（固件只看到 ORE）
+uint32_t sim_uart_ore_events(int n);                        // ORE 从 0 变 1 的次数
+uint32_t sim_uart_irq_count(int n);                         // 进中断的次数
+
+#endif // _SIM_UART_H
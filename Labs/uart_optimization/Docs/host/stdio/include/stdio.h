@@ -0,0 +1,10 @@
+#ifndef _SIM_STDIO_H
+#define _SIM_STDIO_H
+
+#include <stdio.h>
+// 固件的 printf 在板子上轮询写 UART1；仿真里交给 sim_printf()（默认不输出，sim_set_verbose(1) 打印到 stdout）
+#define printf sim_printf
+
+int sim_printf(const char *fmt, ...);
+
+#endif // _SIM_STDIO_H
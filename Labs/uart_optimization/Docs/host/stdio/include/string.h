@@ -0,0 +1,6 @@
+#ifndef _SIM_STRING_H
+#define _SIM_STRING_H
+
+#include <string.h>
+
+#endif // _SIM_STRING_H
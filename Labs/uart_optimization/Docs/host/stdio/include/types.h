@@ -0,0 +1,14 @@
+#ifndef _TYPES_H
+#define _TYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int8_t      s8;
+typedef int16_t     s16;
+typedef int32_t     s32;
+typedef uint8_t     u8;
+typedef uint16_t    u16;
+typedef uint32_t    u32;
+
+#endif // _TYPES_H
@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""
+TX 延迟直方图估算误差仿真
+
+板子侧是编译到主机上的固件（fw_host.py）：bsp_uart_async.c 的 uart_tx_irq_handler() 在中断入口按 TXFE
+估算 FIFO 占用（空 = 0，不空 = TXTL），写进 FIFO 的每个字节把估算值加一，一次传输第一个字节的上线时刻
+= now + 前面字节数 x 字符时间（char_ticks_x256()），最后一个字节发完的时刻同理，记进 tx_last_first / tx_last_done
+和三组直方图。传输用 uart_async_send_ref() 发出，完成回调里读 uart_async_get_stats() 拿到这次传输的估算值
+线路侧是 host/sim_uart.c 的 32 字节 FIFO + 移位寄存器，取走的每个字节带实际开始 / 结束发送的时刻，
+和估算值比较。中断用手动模式：条件成立后随机延迟再进，偶尔很长（晚到的中断）
+
+使用方法：
+python latency_sim.py [--transfers 3000] [--load 0.7] [--irq-latency 5] [--late-latency 90]
+                      [--late-rate 0.01] [--seed 1]
+
+输出：115200 / 921600 / 3000000 波特下第一个字节和最后一个字节的估算误差（字符时间，正数 = 估算偏早），
+单包（30 字节）传输的线路时间落在哪个桶，以及时间源换成 24MHz / 66MHz 后（char_ticks_x256 要 64 位算）的结果
+"""
+
+import argparse
+import random
+import sys
+
+import fw_host
+import generic_receiver as rx
+
+# ==================== 固件参数（与 bsp_uart_async.h 一致）====================
+TXTL = 8                        # UART_ASYNC_TXTL
+LAT_BUCKETS = 20                # UART_ASYNC_LAT_BUCKETS
+BAUDS = (115200, 921600, 3000000)
+FAST_CLOCKS = (24000000, 66000000)  # 高频时间源：10 x hz x 256 超过 32 位
+
+def lat_bucket(ticks):
+    """lat_record() 的桶号"""
+    return min(ticks.bit_length(), LAT_BUCKETS - 1)
+
+# ==================== 仿真 ====================
+def simulate(baud, gpt_hz, transfers, args, rng):
+    fw = fw_host.Firmware(gpt_hz=gpt_hz)
+    lib = fw.lib
+    uart = fw.uart(1)
+    lib.uart_async_init()
+    lib.uart_async_set_clock_hz(gpt_hz)
+    lib.uart_async_set_baud(baud)
+    lib.uart_async_reset_latency()
+    uart.auto_irq(False)
+    char = uart.char_time()
+
+    def to_s(ticks):
+        """固件的 32 位 tick → 仿真时刻（相对当前时刻展开回绕）"""
+        delta = (ticks - fw.ticks() + (1 << 31)) % (1 << 32) - (1 << 31)
+        return fw.now() + delta / gpt_hz
+
+    # 传输：1 ~ 12 个包，到达间隔按负载折算
+    sizes = [rng.randint(1, 12) for _ in range(transfers)]
+    mean_gap = sum(sizes) * rx.PACKET_SIZE / len(sizes) * char / args.load
+    arrivals = []
+    t = fw.now()
+    for n in sizes:
+        t += rng.expovariate(1.0 / mean_gap)
+        arrivals.append((t, n))
+
+    # 完成回调（中断里）：tx_last_first / tx_last_done 就是这次传输的估算值
+    estimates = {}
+
+    def done(param, count):
+        stats = fw.stats('uart', lib.uart_async_get_stats())
+        estimates[param or 0] = (to_s(stats['tx_last_first']), to_s(stats['tx_last_done']),
+                                 stats['tx_last_done'] - stats['tx_last_first'])
+    done_cb = fw_host.DONE_FUNC(done)
+
+    buffers = []                    # send_ref 不复制，缓冲区留到结束
+    pos = 0
+    irq_at = None
+    max_latency = 0.0
+    while pos < len(arrivals) or lib.uart_async_is_busy() or uart.tx_pending():
+        now = fw.now()
+        if pos < len(arrivals) and arrivals[pos][0] <= now and lib.uart_async_tx_free() > 0:
+            n = arrivals[pos][1]
+            data = bytes(rx.PACKET_SIZE * n)
+            buffers.append(data)
+            if lib.uart_async_send_ref(data, rx.PACKET_SIZE, rx.PACKET_SIZE, n, done_cb, pos) != 0:
+                raise AssertionError('tx_free() > 0 但 uart_async_send_ref() 失败')
+            pos += 1
+            continue
+        if irq_at is None and uart.irq_pending():
+            latency = rng.uniform(0, args.irq_latency) * 1e-6
+            if rng.random() < args.late_rate:
+                latency = args.late_latency * 1e-6
+            irq_at = uart.irq_since() + latency
+        if irq_at is not None and irq_at <= now:
+            max_latency = max(max_latency, now - uart.irq_since())
+            uart.irq()
+            irq_at = None
+            continue
+        # 推进到下一个事件；中断条件还没成立时按 FIFO 里的字节数估计，最多越过 1/4 个字符
+        target = now + max(uart.tx_pending() - TXTL - 2, 0.25) * char
+        if irq_at is not None:
+            target = min(target, irq_at)
+        if pos < len(arrivals) and lib.uart_async_tx_free() > 0:
+            target = min(target, max(arrivals[pos][0], now))
+        fw.run(target)
+
+    wire = uart.take()
+    first_err, done_err, single_wire = [], [], []
+    offset = 0
+    for i, n in enumerate(sizes):
+        est_first, est_done, wire_ticks = estimates[i]
+        first_err.append((wire[offset][1] - est_first) / char)
+        offset += n * rx.PACKET_SIZE
+        done_err.append((wire[offset - 1][2] - est_done) / char)
+        if n == 1:
+            single_wire.append(wire_ticks)
+    stats = fw.stats('uart', lib.uart_async_get_stats())
+    return {
+        'first_err': first_err, 'done_err': done_err, 'single_wire': single_wire,
+        'char_ticks': char * gpt_hz, 'max_latency_chars': max_latency / char,
+        'complete': offset == len(wire) and len(estimates) == transfers and stats['tx_total_lat.count'] == transfers,
+    }
+
+def report(baud, gpt_hz, r):
+    # 中断入口 FIFO 不空就按 TXTL 估算：实际剩得更少（新传输入队时 FIFO 快发完、中断晚到）估算偏晚，
+    # 移位寄存器里还有一个字节没算估算偏早，两边各留一个字符的取整
+    bound_early = 2
+    bound_late = TXTL + 1 + r['max_latency_chars']
+    first_err, done_err = r['first_err'], r['done_err']
+    expected_bucket = lat_bucket(int(rx.PACKET_SIZE * r['char_ticks']))
+    buckets = {lat_bucket(w) for w in r['single_wire']}
+    mean_first = sum(first_err) / len(first_err)
+    mean_done = sum(done_err) / len(done_err)
+    clock = f"{gpt_hz / 1e6:g}MHz" if gpt_hz != fw_host.GPT1_HZ else "GPT1"
+    print(f"{baud:>7} 波特 @ {clock:<6}（字符 {r['char_ticks']:.2f} tick）: "
+          f"第一个字节 平均 {mean_first:+.2f} 最大 {max(first_err):+.2f} / 最小 {min(first_err):+.2f}，"
+          f"最后一个字节 平均 {mean_done:+.2f} 最大 {max(done_err):+.2f} / 最小 {min(done_err):+.2f}，"
+          f"单包线路时间桶 {sorted(buckets)}（预期 {expected_bucket}）")
+    ok = (r['complete'] and
+          all(-bound_late <= e <= bound_early for e in first_err + done_err) and
+          abs(mean_first) <= 1.5 and abs(mean_done) <= 1.5 and
+          buckets <= {expected_bucket - 1, expected_bucket, expected_bucket + 1})
+    if not r['complete']:
+        print("  传输没有全部完成或线路字节数不对")
+    return ok
+
+def main():
+    parser = argparse.ArgumentParser(description='TX 延迟直方图估算误差仿真')
+    parser.add_argument('--transfers', type=int, default=3000, help='每个波特率的传输次数，默认 3000')
+    parser.add_argument('--load', type=float, default=0.7, help='线路负载，默认 0.7')
+    parser.add_argument('--irq-latency', type=float, default=5, help='中断延迟上限（us），默认 5')
+    parser.add_argument('--late-latency', type=float, default=90, help='偶发长延迟（us），默认 90')
+    parser.add_argument('--late-rate', type=float, default=0.01, help='中断出现长延迟的概率，默认 0.01')
+    parser.add_argument('--seed', type=int, default=1, help='随机种子，默认 1')
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    print(f"{args.transfers} 次传输 / 波特率，1 ~ 12 包，负载 {args.load:g}，中断延迟 0~{args.irq_latency:g}us"
+          f"（{args.late_rate:g} 概率 {args.late_latency:g}us）\n")
+    ok = True
+    for baud in BAUDS:
+        ok &= report(baud, fw_host.GPT1_HZ, simulate(baud, fw_host.GPT1_HZ, args.transfers, args, rng))
+    print()
+    for hz in FAST_CLOCKS:
+        ok &= report(115200, hz, simulate(115200, hz, max(args.transfers // 10, 50), args, rng))
+    print("\n✅ 估算误差在 TXTL + 中断延迟以内，字符时间计算不溢出" if ok else "\n❌ 估算误差超出范围或字符时间计算错误")
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
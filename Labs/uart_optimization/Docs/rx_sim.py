@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""
+中断接收（RX FIFO + 软件环 + 老化 / 空闲检测）仿真
+
+板子侧是编译到主机上的固件 bsp_uart_async.c（fw_host.py），UART1 接 host/sim_uart.c 的寄存器模型：
+- 硬件：32 字节 RX FIFO，>= RXTL 置 RRDY，FIFO 非空且 8 个字符时间没有收发置 AGTIM，
+  线路空闲 4 个字符时间置 IDLE，FIFO 满时新字节丢失并置 ORE
+- 中断：UART1 用手动模式，中断条件成立后延迟随机时间（偶尔很长，制造硬件 FIFO 溢出）再进
+  uart_async_irq_handler()；主循环按固定周期 uart_async_read()
+上位机按 generic_receiver.py 的 link_frame() 发控制帧（参数递增），偶尔夹一段长突发，带少量帧错误字节
+
+使用方法：
+python rx_sim.py [--duration 20] [--baud 115200] [--gap 30] [--burst-rate 0.5] [--irq-latency 2]
+                 [--long-latency 40] [--long-rate 0.002] [--read-period-ms 5] [--err 1e-4] [--seed 1]
+
+输出：读到的字节是否是发送字节的按序子序列，uart_async_stats_t 的 rx_bytes + rx_dropped + rx_errors
+加模型记录的 FIFO 溢出丢失是否等于发送字节数，rx_overruns 是否等于 ORE 置位次数，
+以及一帧最后一个字节到进入软件环的延迟（9 字节控制帧不满 RXTL，帧尾靠空闲 / 老化取走）
+"""
+
+import argparse
+import ctypes
+import random
+import sys
+
+import fw_host
+import generic_receiver as rx
+
+# ==================== 固件参数（与 bsp_uart_async.h 一致）====================
+AGING_CHARS = 8                 # UCR2.ATEN：8 个字符时间
+IDLE_CHARS = 4                  # UCR1.ICD = 00：4 个字符时间
+READ_MAX = 64                   # 主循环每次 uart_async_read() 的缓冲区
+STEP = 0.25                     # 仿真步长（字符时间）
+
+# ==================== 上位机 ====================
+def make_traffic(args, rng):
+    """上位机发送的字节：返回 [(收完时刻（字符时间）, 字节, 是否帧错误)] 和每帧最后一个字节的序号"""
+    out = []
+    frame_ends = []
+    chars = args.duration * args.baud / 10
+    t = 1.0
+    seq = 0
+    while t < chars:
+        if rng.random() < args.burst_rate * args.gap / (args.baud / 10):
+            data = bytes(rng.randrange(256) for _ in range(rng.randint(100, 300)))     # 长突发
+        else:
+            data = rx.link_frame(rx.LINK_CMD_PING, seq)     # 控制帧（9 字节，不满 RXTL）
+            seq += 1
+        for b in data:
+            out.append((t, b, rng.random() < args.err))
+            t += 1.0
+        frame_ends.append(len(out) - 1)
+        t += rng.expovariate(1.0 / args.gap)
+    return out, frame_ends
+
+def match(sent, received):
+    """received 按序匹配到 sent 上，返回每个读到字节对应的发送序号；不是子序列返回 None"""
+    out = []
+    i = 0
+    for b in received:
+        while i < len(sent) and sent[i] != b:
+            i += 1
+        if i == len(sent):
+            return None
+        out.append(i)
+        i += 1
+    return out
+
+# ==================== 仿真 ====================
+def simulate(args):
+    rng = random.Random(args.seed)
+    fw = fw_host.Firmware()
+    lib = fw.lib
+    uart = fw.uart(1)
+    lib.uart_async_init()
+    lib.uart_async_set_clock_hz(fw.gpt_hz)
+    if args.baud != 115200 and lib.uart_async_set_baud(args.baud) != 0:
+        raise SystemExit(f'uart_async_set_baud({args.baud}) 失败')
+    lib.uart_async_rx_enable(None, None)
+    uart.auto_irq(False)
+    stats = lib.uart_async_get_stats()
+
+    char = uart.char_time()
+    traffic, frame_ends = make_traffic(args, rng)
+    for t, b, err in traffic:
+        uart.rx(t * char, b, err)
+
+    buf = (ctypes.c_uint8 * READ_MAX)()
+    received = []
+    entered = []                # (软件环里累计到第几个字节, 进入时刻)：每次中断之后记一次
+    irq_at = None
+    next_read = 0.0
+    read_period = args.read_period_ms / 1000
+    now = 0.0
+    end = (traffic[-1][0] + 4 * (AGING_CHARS + args.long_latency)) * char  # 发完后再跑一段，把尾巴取干净
+    while now < end or lib.uart_async_rx_available():
+        now += STEP * char
+        fw.run(now)
+        if irq_at is None and uart.irq_pending():
+            latency = rng.uniform(0, args.irq_latency)
+            if rng.random() < args.long_rate:
+                latency = args.long_latency
+            irq_at = uart.irq_since() + latency * char
+        if irq_at is not None and now >= irq_at:
+            uart.irq()
+            irq_at = None
+            entered.append((fw.stats('uart', stats)['rx_bytes'], now))
+        if now >= next_read:
+            n = lib.uart_async_read(buf, READ_MAX)
+            received.extend(buf[:n])
+            next_read += read_period
+
+    # 一帧最后一个字节收完 → 进入软件环（只统计读到了的帧尾）
+    index = match([b for _, b, _ in traffic], received)
+    tail = []
+    if index is not None:
+        at = {}
+        k = 0
+        for count, t in entered:
+            while k < count and k < len(index):
+                at[index[k]] = t
+                k += 1
+        tail = sorted(at[i] / char - traffic[i][0] for i in frame_ends if i in at)
+    return {
+        'sent': len(traffic),
+        'received': received,
+        'in_order': index is not None,
+        'stats': fw.stats('uart', stats),
+        'hw_lost': uart.hw_lost(),
+        'ore_events': uart.ore_events(),
+        'tail': tail,
+        'frames': len(frame_ends),
+    }
+
+def report(r):
+    st = r['stats']
+    received = r['received']
+    accounted = st['rx_bytes'] + st['rx_dropped'] + st['rx_errors'] + r['hw_lost']
+    tail = r['tail']
+    print(f"字节:       发送 {r['sent']}，读到 {len(received)}，rx_bytes {st['rx_bytes']}，"
+          f"环满丢弃 {st['rx_dropped']}，帧错误 {st['rx_errors']}，FIFO 溢出丢失 {r['hw_lost']}")
+    print(f"中断:       {st['rx_interrupts']} 次（{r['sent'] / max(st['rx_interrupts'], 1):.1f} 字节/次），"
+          f"空闲 {st['rx_idle_events']}，溢出 {st['rx_overruns']} / 实际 {r['ore_events']} 次")
+    if tail:
+        print(f"帧尾延迟:   {r['frames']} 帧，p50 {tail[len(tail) // 2]:.2f}，"
+              f"p99 {tail[len(tail) * 99 // 100]:.2f}，最大 {tail[-1]:.2f} 字符时间"
+              f"（不满 RXTL 的帧尾由空闲 {IDLE_CHARS} / 老化 {AGING_CHARS} 字符时间后取走，再加中断延迟）")
+    ok = (r['in_order'] and len(received) == st['rx_bytes'] and accounted == r['sent'] and
+          st['rx_overruns'] == r['ore_events'])
+    if not r['in_order']:
+        print("  读到的字节不是发送字节的按序子序列")
+    if len(received) != st['rx_bytes']:
+        print(f"  读到的字节数与 rx_bytes 不一致：{len(received)} != {st['rx_bytes']}")
+    if st['rx_overruns'] != r['ore_events']:
+        print(f"  溢出计数不一致：{st['rx_overruns']} != {r['ore_events']}")
+    if accounted != r['sent']:
+        print(f"  计数不平：{accounted} != {r['sent']}")
+    return ok
+
+def main():
+    parser = argparse.ArgumentParser(description='中断接收仿真')
+    parser.add_argument('--duration', type=float, default=20, help='仿真时长（秒），默认 20')
+    parser.add_argument('--baud', type=int, default=115200, help='波特率，默认 115200')
+    parser.add_argument('--gap', type=float, default=30, help='帧间平均空闲（字符时间），默认 30')
+    parser.add_argument('--burst-rate', type=float, default=0.5, help='长突发（100~300 字节）次/秒，默认 0.5')
+    parser.add_argument('--irq-latency', type=float, default=2, help='中断延迟上限（字符时间），默认 2')
+    parser.add_argument('--long-latency', type=float, default=40, help='偶发长延迟（字符时间），默认 40')
+    parser.add_argument('--long-rate', type=float, default=0.002, help='中断出现长延迟的概率，默认 0.002')
+    parser.add_argument('--read-period-ms', type=float, default=5, help='主循环读取周期（ms），默认 5')
+    parser.add_argument('--err', type=float, default=1e-4, help='字节帧错误概率，默认 1e-4')
+    parser.add_argument('--seed', type=int, default=1, help='随机种子，默认 1')
+    args = parser.parse_args()
+
+    print(f"{args.baud} 波特，{args.duration:g} 秒，帧间 {args.gap:g} 字符，中断延迟 0~{args.irq_latency:g} 字符"
+          f"（{args.long_rate:g} 概率 {args.long_latency:g}），每 {args.read_period_ms:g}ms 读一次\n")
+    ok = report(simulate(args))
+    print("\n✅ 按序、计数平衡、溢出全部计数" if ok else "\n❌ 接收路径不一致")
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""
+多 UART 条带化仿真
+
+板子侧是编译到主机上的固件（fw_host.py）：link_stripe.c 的轮转 / 条带头、bsp_uart_channel.c（链路 0 的遥测标签）、
+bsp_uart_async.c 的两个实例（UART1 / UART3），UART 接 host/sim_uart.c 的寄存器模型，按波特率把 TX FIFO 发到线路上。
+主循环按 Stage 3 irq_dma.c 的条带化分支：每 1ms 问 link_stripe_tx_room()，把采样 Ring（16 槽，满时丢最新）
+里的包交给 link_stripe_send()。两条线路上的字节随机翻转比特；上位机按 0x00 分帧、cobs_decode、去掉链路 0 的
+通道标签后交给 generic_receiver.py 的 StripeReassembler 合并，负载再用 decode_frame() 校验。
+发出的帧以没有误码的线路字节为准（条带头给出全局帧号），并和 link_stripe_get_stats() 的帧数核对。
+同样的采样流只走 UART1（不开条带化，uart_channel_send_ref() 批量发送）时的 Ring 溢出作对照；
+--stuck-uart3 时 UART3 软复位不结束，检查 uart_async_port_open() 超时后 STRIPE 应答 0、遥测留在 UART1
+
+使用方法：
+python stripe_sim.py [--duration 4] [--baud 115200] [--rate 500] [--ber 1e-4] [--seed 1] [--stuck-uart3]
+
+输出：各链路帧数、合并后交付 / 丢失 / 迟到 / 条带头损坏的帧数，交付的样本是否按序无重复、是否都是原样发出的样本，
+没被损坏波及的帧是否全部交付，交付 + 丢失是否等于发出的帧数
+误码率到 5e-3 量级时 8 位头校验和偶尔会放过坏掉的链路序号，表现为迟到帧
+"""
+
+import argparse
+import random
+import struct
+import sys
+from collections import deque
+
+import fw_host
+import generic_receiver as rx
+
+# ==================== 固件参数（与 link_stripe.h / bsp_uart_async.h / irq_dma.c 一致）====================
+LINKS = 2                       # LINK_STRIPE_LINKS
+STRIPE_UART = 3                 # LINK_STRIPE_UART
+FRAMING_COBS = 1                # UART_ASYNC_FRAMING_COBS
+CHANNEL_TELEMETRY = 1           # UART_CHANNEL_TELEMETRY
+TX_BUFFER_SIZE = 512            # UART_ASYNC_TX_BUFFER_SIZE
+RING_SIZE = 16                  # RING_BUFFER_SIZE
+LOOP_S = 0.001                  # 主循环周期
+
+# ==================== 板子侧 ====================
+def make_packet(seq):
+    body = struct.pack(rx.PACKET_FORMAT, b'\xAA\x55', seq & 0xFFFF, (seq * 1290) & 0xFFFFFFFF,
+                       *([seq & 0x7FFF] * 6), 0, 0, 0, 0)
+    crc = rx.crc16_ccitt(body[:-2])
+    return body[:-2] + bytes([crc >> 8, crc & 0xFF])
+
+def boot(args, stripe):
+    """固件启动到 Stage 3 主循环之前：UART1 COBS、逻辑通道、UART3 待命，返回 (fw, STRIPE 应答)"""
+    fw = fw_host.Firmware()
+    lib = fw.lib
+    lib.uart_async_init()
+    lib.uart_async_set_clock_hz(fw.gpt_hz)
+    if lib.uart_async_set_baud(args.baud) != 0:
+        raise SystemExit(f'uart_async_set_baud({args.baud}) 失败')
+    lib.uart_async_set_framing(FRAMING_COBS)
+    lib.uart_channel_init()
+    fw.uart(STRIPE_UART).hold_reset(args.stuck_uart3)
+    lib.link_stripe_init()
+    links = lib.link_stripe_enable(1) if stripe else 0
+    return fw, links
+
+def simulate(args, stripe):
+    """跑 duration 秒的采样流，返回 (fw, STRIPE 应答, 生成的样本数, Ring 溢出)"""
+    fw, links = boot(args, stripe)
+    lib = fw.lib
+    size = rx.PACKET_SIZE
+    ring = deque()
+    samples = overflow = 0
+    next_sample = 0.0
+    now = fw.now()
+    end = now + args.duration
+    while now < end:
+        now += LOOP_S
+        while next_sample <= now:
+            if len(ring) < RING_SIZE:
+                ring.append(samples)
+            else:
+                overflow += 1
+            samples += 1
+            next_sample += 1.0 / args.rate
+        fw.run(now)
+        if lib.link_stripe_enabled():
+            n = min(lib.link_stripe_tx_room(size), len(ring))
+            if n > 0 and lib.link_stripe_send(b''.join(make_packet(s) for s in list(ring)[:n]), size, size, n) != 0:
+                raise SystemExit('link_stripe_send() 在 tx_room 之内失败')
+        elif lib.uart_channel_tx_ready(CHANNEL_TELEMETRY):
+            n = min(TX_BUFFER_SIZE // lib.uart_channel_wire_len(size), len(ring))
+            if n > 0 and lib.uart_channel_send_ref(CHANNEL_TELEMETRY, b''.join(make_packet(s) for s in list(ring)[:n]),
+                                                   size, size, n, None, None) != 0:
+                raise SystemExit('uart_channel_send_ref() 在 tx_ready 之后失败')
+        else:
+            n = 0
+        for _ in range(n):
+            ring.popleft()
+        lib.uart_channel_poll()
+    # 收尾：把描述符和 FIFO 里剩下的发完
+    while lib.uart_async_is_busy() or lib.link_stripe_is_busy() or any(
+            fw.uart(u).tx_pending() for u in (1, STRIPE_UART)):
+        now += LOOP_S
+        fw.run(now)
+    return fw, links, samples, overflow
+
+# ==================== 上位机 ====================
+def split(wire):
+    """线路字节 [(byte, t_start, t_end)] 按 0x00 分帧：[(帧尾时刻, 起, 止)]，起止是字节位置（不含 0x00）"""
+    out = []
+    start = 0
+    for i, (b, _, t_end) in enumerate(wire):
+        if b == 0:
+            out.append((t_end, start, i))
+            start = i + 1
+    return out
+
+def unwrap(frame):
+    """去掉链路 0 的通道标签：返回 (是否其他通道（控制应答 / 日志）, 帧)"""
+    if frame and frame[0] in rx.CHANNEL_TAGS:
+        return frame[0] != rx.CHANNEL_TELEMETRY, frame[1:]
+    return False, frame
+
+def corrupt(data, ber, rng):
+    """逐字节按 ber x 8 的概率翻转一位，返回损坏后的字节流和被波及的字节位置"""
+    out = bytearray(data)
+    hit = set()
+    p = ber * 8
+    i = 0
+    while p > 0:
+        i += int(rng.expovariate(p)) + 1
+        if i > len(out):
+            break
+        out[i - 1] ^= 1 << rng.randrange(8)
+        hit.add(i - 1)
+    return bytes(out), hit
+
+def receive(fw, args, rng):
+    """上位机：两个串口各自按 0x00 分帧，按帧尾时刻交替交给 StripeReassembler"""
+    reasm = rx.StripeReassembler(LINKS)
+    payload_of = {}                 # 全局帧号 → 负载（按没有误码的线路字节）
+    clean = set()                   # 没被误码波及的全局帧号
+    events = []
+    for uart in (1, STRIPE_UART):
+        wire = fw.uart(uart).take()
+        sent = bytes(b for b, _, _ in wire)
+        data, hit = corrupt(sent, args.ber, rng)
+        for t, start, end in split(wire):
+            other, frame = unwrap(rx.cobs_decode(sent[start:end]))
+            if not other and frame is not None and frame[:2] == rx.STRIPE_HEADER:
+                g = (frame[3] | (frame[4] << 8)) * LINKS + frame[2]
+                payload_of[g] = bytes(frame[rx.STRIPE_HEAD_LEN:])
+                if not any(j in hit for j in range(start - 1, end + 1)):
+                    clean.add(g)
+            events.append((t, uart, data[start:end]))
+    events.sort(key=lambda e: e[0])
+
+    delivered = []
+    payload_bad = 0
+    def accept(payloads):
+        nonlocal payload_bad
+        for payload in payloads:
+            packet, single = rx.decode_frame(payload)
+            if packet is None:
+                payload_bad += 1
+            else:
+                delivered.append(payload)
+
+    for t, uart, chunk in events:
+        other, frame = unwrap(rx.cobs_decode(chunk) if chunk else None)
+        if other:
+            continue
+        if frame is None or frame[:2] != rx.STRIPE_HEADER:
+            reasm.bad_frames += 1
+            continue
+        accept(reasm.receive(frame, t) or [])
+        accept(reasm.poll(t))
+    end = events[-1][0] if events else 0.0
+    accept(reasm.poll(end + rx.STRIPE_GIVEUP_S + 1))
+    return reasm, delivered, payload_bad, clean, payload_of
+
+def check_stuck(args):
+    """UART3 软复位不结束：STRIPE 应答 0，遥测照常走 UART1，UART3 没有字节"""
+    fw, links, samples, overflow = simulate(args, True)
+    wire1 = fw.uart(1).take()
+    wire3 = fw.uart(STRIPE_UART).take()
+    tlm = sum(1 for _, s, e in split(wire1)
+              if rx.cobs_decode(bytes(b for b, _, _ in wire1[s:e]))[:1] == bytes([rx.CHANNEL_TELEMETRY]))
+    print(f"UART3 复位超时: STRIPE 应答 {links}，条带化 {'开' if fw.lib.link_stripe_enabled() else '关'}，"
+          f"UART1 遥测帧 {tlm}，UART3 字节 {len(wire3)}")
+    ok = links == 0 and not fw.lib.link_stripe_enabled() and tlm > 0 and not wire3
+    print("\n✅ UART3 打不开时不条带化，遥测留在 UART1" if ok else "\n❌ UART3 打不开时行为不对")
+    return ok
+
+def main():
+    parser = argparse.ArgumentParser(description='多 UART 条带化仿真')
+    parser.add_argument('--duration', type=float, default=4, help='仿真时长（秒），默认 4')
+    parser.add_argument('--baud', type=int, default=115200, help='两条链路的波特率，默认 115200')
+    parser.add_argument('--rate', type=int, default=500, help='采样率（包/秒），默认 500')
+    parser.add_argument('--ber', type=float, default=1e-4, help='线路误码率（每比特），默认 1e-4')
+    parser.add_argument('--seed', type=int, default=1, help='随机种子，默认 1')
+    parser.add_argument('--stuck-uart3', action='store_true', help='UART3 软复位不结束（没有时钟）')
+    args = parser.parse_args()
+
+    rx.CHECK_MODE = 'crc16'
+    rng = random.Random(args.seed)
+    print(f"{args.rate} 包/秒，{args.baud} 波特，{args.duration:g} 秒，误码率 {args.ber:g}\n")
+    if args.stuck_uart3:
+        sys.exit(0 if check_stuck(args) else 1)
+
+    _, _, samples1, overflow1 = simulate(args, False)
+    print(f"单链路:     生成 {samples1}，Ring 溢出 {overflow1}")
+
+    fw, links, samples, overflow = simulate(args, True)
+    st_fw = fw.stats('stripe', fw.lib.link_stripe_get_stats())
+    reasm, delivered, payload_bad, clean, payload_of = receive(fw, args, rng)
+    st = reasm.get_statistics()
+    sent = len(payload_of)
+    print(f"条带化:     STRIPE 应答 {links}，生成 {samples}，Ring 溢出 {overflow}，发出 {sent} 帧"
+          f"（链路 {st_fw['frames[0]']} / {st_fw['frames[1]']}），等待 {st_fw['stalls']} 次")
+    print(f"合并:       交付 {st['delivered_frames']}（其中负载 CRC 失败 {payload_bad}），丢失 {st['lost_frames']}，"
+          f"迟到 {st['late_frames']}，条带头 / COBS 损坏 {st['bad_frames']}")
+
+    order = [struct.unpack_from('<H', p, 2)[0] for p in delivered]
+    originals = set(payload_of.values())
+    false_accepts = sum(1 for p in delivered if p not in originals)
+    got = set(delivered)
+    missing_clean = sum(1 for g in clean if payload_of[g] not in got)
+    seqs = [struct.unpack_from('<H', payload_of[g], 2)[0] for g in sorted(payload_of)]
+    pos = {s: i for i, s in enumerate(seqs)}
+    in_order = all(pos[a] < pos[b] for a, b in zip(order, order[1:]))
+    accounted = st['delivered_frames'] + st['lost_frames'] == sent
+    complete = sorted(payload_of) == list(range(sent)) and sent == st_fw['frames[0]'] + st_fw['frames[1]']
+    print(f"检查:       按序 {'是' if in_order else '否'}，误收 {false_accepts}，"
+          f"未被波及却没交付 {missing_clean}，交付 + 丢失 {'=' if accounted else '!='} 发出，"
+          f"线路帧号 {'连续且与固件统计一致' if complete else '与固件统计不一致'}")
+
+    ok = (links == LINKS and in_order and false_accepts == 0 and missing_clean == 0 and accounted and
+          complete and st['late_frames'] == 0 and overflow <= overflow1)
+    print("\n✅ 两条链路按序合并，损坏只影响自身" if ok else "\n❌ 条带化合并不一致")
+    sys.exit(0 if ok else 1)
+
+if __name__ == '__main__':
+    main()
@@ -1,4 +1,6 @@
 #include "baseline.h"   
+#include "packet_crc.h"
+#include "../bsp/timebase/bsp_timebase.h"
 
 void baseline_loop(void)
 {
@@ -6,11 +8,14 @@ void baseline_loop(void)
     uint16_t seq = 0;
     uint32_t last_send_time = 0;
 
+    packet_crc_init();
     delayms(500);
     //printf("[DEBUG] Entering baseline_loop\r\n");
     
-    const uint32_t PERIOD_US = 32250;  // 50ms
-    uint32_t next_tick = get_system_tick() + PERIOD_US;
+    // GPT1 已经在走：对 32.768kHz RTC 标定一次，50ms 按实测频率换算成 tick（失败时按标称 645kHz，约 32250）
+    timebase_calibrate(GPT1);
+    const uint32_t PERIOD_TICKS = timebase_ms_to_ticks(50);
+    uint32_t next_tick = get_system_tick() + PERIOD_TICKS;
     
     //printf("[DEBUG] Starting main loop, will send binary data...\r\n");
     
@@ -26,10 +31,10 @@ void baseline_loop(void)
         packet.header[0] = 0xAA;
         packet.header[1] = 0x55;
         packet.timestamp = get_system_tick();
-        packet.process_time_us = read_end - read_start;
-        packet.send_time_us = last_send_time;
+        packet.process_ticks = read_end - read_start;
+        packet.send_ticks = last_send_time;
         packet.seq_num = seq++;
-        packet.checksum = calculate_checksum(&packet);
+        packet_seal(&packet);  // checksum / padding（PACKET_CHECK_MODE）
         
 
         uint32_t send_start = get_system_tick();
@@ -39,8 +44,8 @@ void baseline_loop(void)
         last_send_time = send_end - send_start;
 
         
-        while(get_system_tick() < next_tick);  // polling 
-        next_tick += PERIOD_US;  // next preiod
+        while((int32_t)(get_system_tick() - next_tick) < 0);  // polling（按差值比较，CNT 回绕时不会卡住一圈）
+        next_tick += PERIOD_TICKS;  // next preiod
     }
 }
 
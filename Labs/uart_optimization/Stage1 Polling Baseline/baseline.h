@@ -23,15 +23,15 @@
 typedef struct {
     uint8_t header[2];         // head 0xAA 0x55
     uint16_t seq_num;          // seq (移到前面，2+2=4字节对齐)
-    uint32_t timestamp;        // timestamp （GPT1 ticks，~645kHz）
+    uint32_t timestamp;        // timestamp （GPT1 ticks，~645kHz，实测频率见 timebase_rate_hz()）
     int16_t accel_x;           // 加速度X（原始ADC值）
     int16_t accel_y;           // 加速度Y
     int16_t accel_z;           // 加速度Z
     int16_t gyro_x;            // 陀螺仪X（原始ADC值）
     int16_t gyro_y;            // 陀螺仪Y
     int16_t gyro_z;            // 陀螺仪Z
-    uint32_t process_time_us;  // read（GPT1 ticks）
-    uint32_t send_time_us;     // sendtime（GPT1 ticks）
+    uint32_t process_ticks;    // read（GPT1 ticks，不是 us：换算见 timebase_ticks_to_us()）
+    uint32_t send_ticks;       // sendtime（GPT1 ticks）
     uint8_t checksum;          // check by sum
     uint8_t padding;           // 填充到偶数字节 (29->30字节)
 } __attribute__((packed)) sensor_packet_t;
@@ -0,0 +1,193 @@
+#include "packet_crc.h"
+#include "../stdio/include/stdio.h"
+
+// ==================== Lookup Tables ====================
+
+// CRC-16/CCITT-FALSE：poly 0x1021，init 0xFFFF，不反射
+static uint16_t crc16_table[256];
+
+// CRC-32/IEEE：反射 poly 0xEDB88320，init / xorout 0xFFFFFFFF
+// crc32_table[k][n]：字节 n 之后再经过 k 个零字节的 CRC，slice-by-4 一次处理 4 字节
+static uint32_t crc32_table[4][256];
+
+void packet_crc_init(void)
+{
+    uint32_t i, k;
+
+    for (i = 0; i < 256; i++) {
+        uint16_t c16 = (uint16_t)(i << 8);
+        uint32_t c32 = i;
+
+        for (k = 0; k < 8; k++) {
+            c16 = (c16 & 0x8000) ? (uint16_t)((c16 << 1) ^ 0x1021) : (uint16_t)(c16 << 1);
+            c32 = (c32 & 1) ? (c32 >> 1) ^ 0xEDB88320 : (c32 >> 1);
+        }
+        crc16_table[i] = c16;
+        crc32_table[0][i] = c32;
+    }
+
+    for (i = 0; i < 256; i++) {
+        for (k = 1; k < 4; k++) {
+            uint32_t prev = crc32_table[k - 1][i];
+            crc32_table[k][i] = (prev >> 8) ^ crc32_table[0][prev & 0xFF];
+        }
+    }
+}
+
+// ==================== CRC-16 ====================
+
+uint16_t crc16_ccitt(const uint8_t *data, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc = (uint16_t)((crc << 8) ^ crc16_table[((crc >> 8) ^ *data++) & 0xFF]);
+    }
+    return crc;
+}
+
+uint16_t crc16_ccitt_bitwise(const uint8_t *data, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+    uint32_t k;
+
+    while (len--) {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (k = 0; k < 8; k++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// ==================== CRC-32 ====================
+
+uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, uint32_t len)
+{
+    crc = ~crc;
+
+    // 每次 4 字节：逐字节拼成小端字（MMU 关闭时不能做非对齐的 32 位读）
+    while (len >= 4) {
+        crc ^= (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+               ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+        crc = crc32_table[3][crc & 0xFF] ^
+              crc32_table[2][(crc >> 8) & 0xFF] ^
+              crc32_table[1][(crc >> 16) & 0xFF] ^
+              crc32_table[0][crc >> 24];
+        data += 4;
+        len -= 4;
+    }
+
+    while (len--) {
+        crc = (crc >> 8) ^ crc32_table[0][(crc ^ *data++) & 0xFF];
+    }
+    return ~crc;
+}
+
+uint32_t crc32_ieee(const uint8_t *data, uint32_t len)
+{
+    return crc32_ieee_update(0, data, len);
+}
+
+uint32_t crc32_ieee_bytewise(const uint8_t *data, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (len--) {
+        crc = (crc >> 8) ^ crc32_table[0][(crc ^ *data++) & 0xFF];
+    }
+    return ~crc;
+}
+
+// ==================== Packet ====================
+
+void packet_seal(sensor_packet_t *pkt)
+{
+#if PACKET_CHECK_MODE == PACKET_CHECK_CRC16
+    uint16_t crc = crc16_ccitt((const uint8_t *)pkt, PACKET_CHECK_LEN);
+    pkt->checksum = (uint8_t)(crc >> 8);    // 高字节在前
+    pkt->padding = (uint8_t)(crc & 0xFF);
+#else
+    pkt->padding = 0;
+    pkt->checksum = calculate_checksum(pkt);
+#endif
+}
+
+int packet_verify(const sensor_packet_t *pkt)
+{
+#if PACKET_CHECK_MODE == PACKET_CHECK_CRC16
+    uint16_t crc = crc16_ccitt((const uint8_t *)pkt, PACKET_CHECK_LEN);
+    return (pkt->checksum == (crc >> 8) && pkt->padding == (crc & 0xFF)) ? 0 : -1;
+#else
+    return (pkt->checksum == calculate_checksum((sensor_packet_t *)pkt)) ? 0 : -1;
+#endif
+}
+
+// ==================== Microbenchmark ====================
+
+#define PACKET_CRC_BENCH_ROUNDS 1000
+
+void packet_crc_benchmark(void)
+{
+    static const uint8_t check[] = "123456789";
+    sensor_packet_t pkt;
+    volatile uint32_t sink = 0;     // 防止循环被优化掉
+    uint32_t start, i;
+    uint32_t cycles[5];
+
+    // 标准校验值：CRC-16/CCITT-FALSE = 0x29B1，CRC-32 = 0xCBF43926
+    printf("[CRC] self-test: crc16=0x%04X (0x29B1), crc32=0x%08X (0xCBF43926)\r\n",
+           crc16_ccitt(check, 9), crc32_ieee(check, 9));
+
+    for (i = 0; i < sizeof(pkt); i++) {
+        ((uint8_t *)&pkt)[i] = (uint8_t)(i * 37 + 11);
+    }
+
+    // seal 之后必须校验通过；翻转一位数据后必须校验失败（当前 PACKET_CHECK_MODE）
+    packet_seal(&pkt);
+    int sealed_ok = packet_verify(&pkt);
+    pkt.accel_x ^= 0x0100;
+    int flipped_ok = packet_verify(&pkt);
+    pkt.accel_x ^= 0x0100;
+    printf("[CRC] self-test: seal/verify %s, bit flip %s\r\n",
+           sealed_ok == 0 ? "ok" : "FAIL", flipped_ok != 0 ? "detected" : "MISSED");
+
+    start = PACKET_CRC_CYCLES();
+    for (i = 0; i < PACKET_CRC_BENCH_ROUNDS; i++) {
+        sink += calculate_checksum(&pkt);
+    }
+    cycles[0] = PACKET_CRC_CYCLES() - start;
+
+    start = PACKET_CRC_CYCLES();
+    for (i = 0; i < PACKET_CRC_BENCH_ROUNDS; i++) {
+        sink += crc16_ccitt_bitwise((const uint8_t *)&pkt, PACKET_CHECK_LEN);
+    }
+    cycles[1] = PACKET_CRC_CYCLES() - start;
+
+    start = PACKET_CRC_CYCLES();
+    for (i = 0; i < PACKET_CRC_BENCH_ROUNDS; i++) {
+        sink += crc16_ccitt((const uint8_t *)&pkt, PACKET_CHECK_LEN);
+    }
+    cycles[2] = PACKET_CRC_CYCLES() - start;
+
+    start = PACKET_CRC_CYCLES();
+    for (i = 0; i < PACKET_CRC_BENCH_ROUNDS; i++) {
+        sink += crc32_ieee_bytewise((const uint8_t *)&pkt, PACKET_CHECK_LEN);
+    }
+    cycles[3] = PACKET_CRC_CYCLES() - start;
+
+    start = PACKET_CRC_CYCLES();
+    for (i = 0; i < PACKET_CRC_BENCH_ROUNDS; i++) {
+        sink += crc32_ieee((const uint8_t *)&pkt, PACKET_CHECK_LEN);
+    }
+    cycles[4] = PACKET_CRC_CYCLES() - start;
+
+    printf("[CRC] cycles/packet (%u bytes, %u rounds):\r\n",
+           (uint32_t)PACKET_CHECK_LEN, PACKET_CRC_BENCH_ROUNDS);
+    printf("[CRC]   sum8           %u\r\n", cycles[0] / PACKET_CRC_BENCH_ROUNDS);
+    printf("[CRC]   crc16 bitwise  %u\r\n", cycles[1] / PACKET_CRC_BENCH_ROUNDS);
+    printf("[CRC]   crc16 table    %u\r\n", cycles[2] / PACKET_CRC_BENCH_ROUNDS);
+    printf("[CRC]   crc32 bytewise %u\r\n", cycles[3] / PACKET_CRC_BENCH_ROUNDS);
+    printf("[CRC]   crc32 slice-4  %u\r\n", cycles[4] / PACKET_CRC_BENCH_ROUNDS);
+    (void)sink;
+}
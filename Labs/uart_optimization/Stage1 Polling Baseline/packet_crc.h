@@ -0,0 +1,45 @@
+#ifndef __PACKET_CRC_H
+#define __PACKET_CRC_H
+
+#include "baseline.h"
+#include "../bsp/timebase/bsp_timebase.h"
+
+// ==================== Packet Integrity ====================
+// calculate_checksum() 是 28 字节的 8 位累加和：字节交换、多位错误都查不出来
+// 这里提供查表 CRC，所有阶段统一用 packet_seal() 填写校验字段：
+// - PACKET_CHECK_SUM8  : 原来的累加和（checksum），padding = 0，与旧上位机兼容
+// - PACKET_CHECK_CRC16 : CRC-16/CCITT-FALSE，占用 checksum + padding 两个字节（大端），包长不变
+// CRC-32（IEEE 802.3，slice-by-4）留给更长的帧（批量帧等）使用
+// 上位机用 generic_receiver.py --check sum8|crc16 对应解码
+
+#define PACKET_CHECK_SUM8       0
+#define PACKET_CHECK_CRC16      1
+
+#ifndef PACKET_CHECK_MODE
+#define PACKET_CHECK_MODE       PACKET_CHECK_SUM8
+#endif
+
+// 参与校验的字节数（不含 checksum / padding）
+#define PACKET_CHECK_LEN        (sizeof(sensor_packet_t) - 2)
+
+// 周期计数器（微基准用），默认 Cortex-A7 PMU PMCCNTR
+#ifndef PACKET_CRC_CYCLES
+#define PACKET_CRC_CYCLES()     timebase_cycles()
+#endif
+
+// ==================== Function Declarations ====================
+
+void packet_crc_init(void);                                 // 生成查找表（必须在中断启动前调用）
+
+uint16_t crc16_ccitt(const uint8_t *data, uint32_t len);    // 查表，每字节一次查表
+uint16_t crc16_ccitt_bitwise(const uint8_t *data, uint32_t len);  // 逐位计算（参考实现）
+uint32_t crc32_ieee(const uint8_t *data, uint32_t len);     // slice-by-4，每 4 字节 4 次查表
+uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, uint32_t len);  // 分段计算（初值 0）
+uint32_t crc32_ieee_bytewise(const uint8_t *data, uint32_t len);  // 单表逐字节（对照）
+
+void packet_seal(sensor_packet_t *pkt);                     // 按 PACKET_CHECK_MODE 填写 checksum / padding
+int packet_verify(const sensor_packet_t *pkt);              // 0=校验通过，-1=失败
+
+void packet_crc_benchmark(void);                            // 打印每包的周期数对比
+
+#endif // __PACKET_CRC_H
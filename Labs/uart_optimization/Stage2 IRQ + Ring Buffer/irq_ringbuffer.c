@@ -1,81 +1,20 @@
 #include "irq_ringbuffer.h"
+#include "packet_crc.h"
 #include "../bsp/int/bsp_int.h"
 #include "../bsp/led/bsp_led.h"
+#include "../bsp/icm20608/bsp_icm20608_async.h"
 #include "../stdio/include/string.h" 
 
 // ==================== Global Variables ====================
-ring_buffer_t g_ring_buffer;
+RING_SPSC_DEFINE(g_ring_buffer, sensor_packet_t, RING_BUFFER_SIZE);
 static uint16_t g_seq_num = 0;
 static uint32_t last_send_time = 0;
 
 uint32_t g_isr_led_count = 0;
+uint32_t g_sensor_busy_skips = 0;   // 上一次 SPI 读取未完成而跳过的采样
 
-// ==================== Ring Buffer ====================
-
-void ring_buffer_init(void)
-{
-    g_ring_buffer.write_idx = 0;
-    g_ring_buffer.read_idx = 0;
-    g_ring_buffer.overflow_count = 0;
-    g_ring_buffer.total_samples = 0;
-    
-    printf("[IRQ] Ring buffer initialized (size=%d)\r\n", RING_BUFFER_SIZE);
-}
-
-uint32_t ring_buffer_available(void)
-{
-    // 可读数据包数量
-    uint32_t write = g_ring_buffer.write_idx;
-    uint32_t read = g_ring_buffer.read_idx;
-    
-    if (write >= read) {
-        return write - read;
-    } else {
-        return RING_BUFFER_SIZE - (read - write);
-    }
-}
-
-uint32_t ring_buffer_free_space(void)
-{
-    // 可写空间（保留1个位置区分满/空）
-    return RING_BUFFER_SIZE - ring_buffer_available() - 1;
-}
-
-int ring_buffer_write(sensor_packet_t *packet)
-{
-    // 检查是否有空间
-    if (ring_buffer_free_space() == 0) {
-        g_ring_buffer.overflow_count++;
-        return -1;  // Buffer 满
-    }
-    
-    // 写入数据 - 使用 memcpy 避免结构体赋值问题
-    uint32_t write_idx = g_ring_buffer.write_idx;
-    memcpy(&g_ring_buffer.buffer[write_idx], packet, sizeof(sensor_packet_t));
-    
-    // 更新写指针（环形）
-    g_ring_buffer.write_idx = (write_idx + 1) & (RING_BUFFER_SIZE - 1);
-    g_ring_buffer.total_samples++;
-    
-    return 0;  // 成功
-}
-
-int ring_buffer_read(sensor_packet_t *packet)
-{
-    // 检查是否有数据
-    if (ring_buffer_available() == 0) {
-        return -1;  // Buffer 空
-    }
-    
-    // 读取数据 - 使用 memcpy 避免结构体赋值问题
-    uint32_t read_idx = g_ring_buffer.read_idx;
-    memcpy(packet, &g_ring_buffer.buffer[read_idx], sizeof(sensor_packet_t));
-    
-    // 更新读指针（环形）
-    g_ring_buffer.read_idx = (read_idx + 1) & (RING_BUFFER_SIZE - 1);
-    
-    return 0;  // 成功
-}
+performance_stats_t g_perf_stats;
+timebase_periodic_t g_sample_timer;
 
 // ==================== GPT1 Timer Interrupt ====================
 
@@ -86,73 +25,129 @@ void gpt1_timer_init(void)
     // 1. 禁用 GPT1
     GPT1->CR = 0;
     
-    // 2. 设置分频器：66分频 → ~645kHz
+    // 2. 设置分频器：IPG 时钟 66 分频，标称 1MHz，实测 ~645kHz（下一步标定）
     GPT1->PR = 65;
     
-    // 3. 设置初始比较值：50ms * 645kHz = 32250 ticks
-    GPT1->OCR[0] = PERIOD_TICKS;
-    
-    // 4. 清除所有中断标志
-    GPT1->SR = 0x3F;
-    
-    // 5. 使能输出比较中断
-    GPT1->IR = 1 << 0;  // OF1IE: Output Compare 1 Interrupt Enable
-    
-    // 6. 配置控制寄存器 - 使用 FreeRun 模式
+    // 3. 配置控制寄存器 - 使用 FreeRun 模式
     // bit 9: FRR=1 (FreeRun mode - 计数器自由运行，不会自动重载)
     // bit 8-6: CLKSRC=001 (IPG clock)
     // bit 1: ENMOD=1 (使能时计数器初始化为0)
     // bit 0: EN=0 (先不使能)
     GPT1->CR = (1 << 9) | (1 << 6) | (1 << 1);
     
-    // 7. 注册中断处理函数
+    // 4. 对 32.768kHz RTC 标定 GPT1 频率（约 250ms，临时使能），失败时按标称 645kHz
+    timebase_calibrate(GPT1);
+    
+    // 5. 设置第一个截止时刻：50ms 按标定频率换算，之后每次中断按周期累加
+    timebase_periodic_init(&g_sample_timer, GPT1, 0, PERIOD_TICKS);
+    
+    // 6. 清除所有中断标志
+    GPT1->SR = 0x3F;
+    
+    // 7. 使能输出比较中断
+    GPT1->IR = 1 << 0;  // OF1IE: Output Compare 1 Interrupt Enable
+    
+    // 8. 注册中断处理函数
     system_register_irqhandler(GPT1_IRQn, (system_irq_handler_t)gpt1_irq_handler, NULL);
     
-    // 8. 使能 GIC 中断
+    // 9. 使能 GIC 中断
     GIC_EnableIRQ(GPT1_IRQn);
     
-    // 9. 启动 GPT1
+    // 10. 启动 GPT1（ENMOD=1：从 0 开始计数）
     GPT1->CR |= (1 << 0);  // EN=1
     
+    // 11. 打开溢出中断，计数扩展到 64 位（要在写完 IR 之后）
+    timebase_init(GPT1);
+    
     printf("[IRQ] GPT1 timer started: %dms period, FreeRun mode\r\n", PERIOD_MS);
 }
 
 // ==================== Interrupt Service Routine ====================
 
+#if SENSOR_ASYNC_READ
+// SPI 读取完成回调（ECSPI3 中断上下文）：补全槽内数据包并发布
+static void sensor_read_done(const uint8_t *data, uint32_t len, void *param)
+{
+    uint32_t entry_time = get_system_tick();
+    sensor_packet_t *packet = (sensor_packet_t *)param;
+    
+    icm20608_async_decode(data, &packet->accel_x, &packet->accel_y, &packet->accel_z,
+                          &packet->gyro_x, &packet->gyro_y, &packet->gyro_z);
+    
+    // 性能数据：从启动 SPI 到数据就绪的时间
+    packet->process_ticks = entry_time - packet->timestamp;
+    packet->send_ticks = last_send_time;
+    packet_seal(packet);
+    
+    ring_spsc_commit(&g_ring_buffer);
+    perf_stats_isr_record(&g_perf_stats, entry_time);
+}
+#endif
+
 void gpt1_irq_handler(void)
 {
+    uint32_t entry_time = get_system_tick();
+    
+    // 溢出中断和比较中断共用 GPT1_IRQn，只是溢出时不采样
+    // SR 按 IR 过滤：没打开的中断源（OF2/OF3、输入捕获）置了标志也不当成采样中断
+    timebase_irq_handler();
+    if (!(GPT1->SR & GPT1->IR & (1 << 0))) {
+        return;
+    }
+    
     // 清除中断标志
     GPT1->SR = 1 << 0;
     
-    // 更新下一次比较值
-    GPT1->OCR[0] = GPT1->CNT + PERIOD_TICKS;
+    // 下一次比较值 = 本次截止时刻 + 周期（不是 CNT + 周期：中断延迟不会累积成相位漂移）
+    // 错过的截止时刻不补采样，序号跳过，PC 端按丢包统计
+    g_seq_num += timebase_periodic_advance(&g_sample_timer, entry_time) - 1;
     
     // 中断计数（主循环会用来控制 LED）
     g_isr_led_count++;
     
-    // 直接在中断中读取传感器并写入 Ring Buffer
-    sensor_packet_t packet;
-    packet.header[0] = 0xAA;
-    packet.header[1] = 0x55;
-    packet.seq_num = g_seq_num++;
-    packet.timestamp = get_system_tick();
+#if SENSOR_ASYNC_READ
+    // 上一次读取还没完成（槽仍被占用），跳过本次采样
+    if (icm20608_async_is_busy()) {
+        g_seq_num++;
+        g_sensor_busy_skips++;
+        return;
+    }
+#endif
     
+    // 直接在 Ring Buffer 的空槽里构造数据包（零拷贝）
+    uint16_t seq = g_seq_num++;  // 丢包时也递增，PC 端能看到序号缺口
+    sensor_packet_t *packet = ring_spsc_reserve(&g_ring_buffer);
+    if (packet == NULL) {
+        return;  // Buffer 满，丢弃本次采样（overflow_count 已累加）
+    }
+    packet->header[0] = 0xAA;
+    packet->header[1] = 0x55;
+    packet->seq_num = seq;
+    packet->timestamp = get_system_tick();
+    
+#if SENSOR_ASYNC_READ
+    // 只启动 SPI 传输（几 μs），数据在 ECSPI3 完成中断里填写并 commit
+    icm20608_async_read(ICM20608_REG_ACCEL_XOUT_H, ICM20608_SENSOR_DATA_LEN,
+                        sensor_read_done, packet);
+#else
     // 读取传感器数据
     uint32_t read_start = get_system_tick();
-    icm20608_read_data(&packet.accel_x, &packet.accel_y, &packet.accel_z,
-                        &packet.gyro_x, &packet.gyro_y, &packet.gyro_z);
+    icm20608_read_data(&packet->accel_x, &packet->accel_y, &packet->accel_z,
+                        &packet->gyro_x, &packet->gyro_y, &packet->gyro_z);
     uint32_t read_end = get_system_tick();
     
     // 性能数据
-    packet.process_time_us = read_end - read_start;
-    packet.send_time_us = last_send_time;  // 填充上一次的发送时间
-    packet.padding = 0;
+    packet->process_ticks = read_end - read_start;
+    packet->send_ticks = last_send_time;  // 填充上一次的发送时间
     
-    // 计算 checksum
-    packet.checksum = calculate_checksum(&packet);
+    // 计算 checksum（PACKET_CHECK_MODE）
+    packet_seal(packet);
     
-    // 写入 Ring Buffer
-    ring_buffer_write(&packet);
+    // 发布到 Ring Buffer
+    ring_spsc_commit(&g_ring_buffer);
+#endif
+    
+    perf_stats_isr_record(&g_perf_stats, entry_time);
 }
 
 // ==================== Main Loop (IRQ Version) ====================
@@ -172,9 +167,19 @@ void irq_ringbuffer_loop(void)
     // g_data_ready_flag = 0;  // 不再使用
     g_seq_num = 0;
     last_send_time = 0;
+    g_sensor_busy_skips = 0;
+    perf_stats_reset(&g_perf_stats);
     
     // 初始化
-    ring_buffer_init();
+    packet_crc_init();
+    ring_spsc_reset(&g_ring_buffer);
+    ring_spsc_set_policy(&g_ring_buffer, RING_BUFFER_POLICY, 0);
+    printf("[IRQ] Ring buffer initialized (size=%d, policy=%d)\r\n", RING_BUFFER_SIZE, RING_BUFFER_POLICY);
+    
+#if SENSOR_ASYNC_READ
+    // 异步 SPI 读取（icm20608_init() 之后）
+    icm20608_async_init();
+#endif
     
     // 启动 GPT1 定时中断
     gpt1_timer_init();
@@ -183,31 +188,35 @@ void irq_ringbuffer_loop(void)
     printf("[IRQ] Sending data to PC...\r\n\r\n");
     
     uint32_t packets_sent = 0;
-    uint32_t last_debug_time = get_system_tick();
     uint32_t last_led_check = 0;  // 上次检查 LED 的中断计数
     
     // 主循环 - 简化为单一任务：从 Buffer 读取并发送
     while(1) {
         // === 主任务：从 Ring Buffer 读取数据并发送 ===
-        if (ring_buffer_available() > 0) {
-            sensor_packet_t packet;
-            if (ring_buffer_read(&packet) == 0) {
-                // 发送并测量时间
-                uint32_t send_start = get_system_tick();
-                uart_send_blocking((uint8_t*)&packet, sizeof(packet));
-                uint32_t send_end = get_system_tick();
-                
-                // 保存本次发送时间（供下一个包使用）
-                last_send_time = send_end - send_start;
-                packets_sent++;
-            }
+        sensor_packet_t *packet = ring_spsc_peek(&g_ring_buffer);
+        if (packet != NULL) {
+            // 直接从槽内发送并测量时间
+            uint32_t send_start = get_system_tick();
+            uart_send_blocking((uint8_t*)packet, sizeof(sensor_packet_t));
+            uint32_t send_end = get_system_tick();
+            
+            // 发送完成后归还槽
+            ring_spsc_release(&g_ring_buffer);
+            
+            // 保存本次发送时间（供下一个包使用）
+            last_send_time = send_end - send_start;
+            packets_sent++;
         }
         else {
             // === Buffer 空闲时的其他任务 ===
             // 示例：LED 闪烁控制（每 10 次中断切换一次，约 500ms）
             uint32_t current_count = g_isr_led_count;
             if ((current_count / 10) != (last_led_check / 10)) {
+                // LED 和 ICM20608 CS 同在 GPIO1，读-改-写期间关中断
+                uint32_t cpsr;
+                ICM20608_ASYNC_GPIO_LOCK(cpsr);
                 led0_switch();
+                ICM20608_ASYNC_GPIO_UNLOCK(cpsr);
                 last_led_check = current_count;
             }
         }
@@ -2,43 +2,26 @@
 #define __IRQ_RINGBUFFER_H
 
 #include "baseline.h"
+#include "ring_spsc.h"
+#include "perf_stats.h"
+#include "../bsp/timebase/bsp_timebase.h"
 
 // ==================== Ring Buffer Configuration ====================
+// 可在编译命令中覆盖，例如 -DRING_BUFFER_SIZE=64
+#ifndef RING_BUFFER_SIZE
 #define RING_BUFFER_SIZE    16      // 缓冲区大小（必须是2的幂，方便取模优化）
+#endif
+#ifndef RING_BUFFER_POLICY
+#define RING_BUFFER_POLICY  RING_SPSC_DROP_NEWEST   // 满时策略（生产者是 ISR，不能用 RING_SPSC_BLOCK）
+#endif
+#ifndef SENSOR_ASYNC_READ
+#define SENSOR_ASYNC_READ   1       // 1=定时器 ISR 只启动 ECSPI 传输，完成中断里组包；0=ISR 内阻塞读取
+#endif
 #define PERIOD_MS           50      // 采样周期：50ms = 20Hz
-#define PERIOD_TICKS        32250   // 50ms * 645kHz = 32250 ticks
-
-// ==================== Ring Buffer Structure ====================
-typedef struct {
-    sensor_packet_t buffer[RING_BUFFER_SIZE];  // 数据缓冲区
-    volatile uint32_t write_idx;               // 写指针（中断中更新）
-    volatile uint32_t read_idx;                // 读指针（主循环更新）
-    volatile uint32_t overflow_count;          // 溢出计数（Buffer满时丢包）
-    volatile uint32_t total_samples;           // 总采样次数
-} ring_buffer_t;
-
-// ==================== Performance Statistics ====================
-typedef struct {
-    uint32_t isr_entry_time;        // 中断进入时间
-    uint32_t isr_exit_time;         // 中断退出时间
-    uint32_t max_isr_time;          // 最大中断执行时间
-    uint32_t total_isr_time;        // 总中断时间（用于计算平均）
-    uint32_t isr_count;             // 中断次数
-    
-    uint32_t main_idle_time;        // 主循环空闲时间
-    uint32_t main_send_time;        // 主循环发送时间
-    uint32_t last_activity_time;    // 上次活动时间
-} performance_stats_t;
+#define PERIOD_TICKS        timebase_ms_to_ticks(PERIOD_MS)  // 按标定出的 GPT1 频率换算（645kHz 下 32250）
 
 // ==================== Function Declarations ====================
 
-// Ring Buffer 操作
-void ring_buffer_init(void);
-uint32_t ring_buffer_available(void);      // 可读数据包数量
-uint32_t ring_buffer_free_space(void);     // 可写空间
-int ring_buffer_write(sensor_packet_t *packet);  // 返回 0=成功, -1=满
-int ring_buffer_read(sensor_packet_t *packet);   // 返回 0=成功, -1=空
-
 // GPT1 中断配置
 void gpt1_timer_init(void);
 void gpt1_irq_handler(void);               // 中断服务函数
@@ -47,7 +30,8 @@ void gpt1_irq_handler(void);               // 中断服务函数
 void irq_ringbuffer_loop(void);
 
 // 外部访问（用于调试）
-extern ring_buffer_t g_ring_buffer;
-extern performance_stats_t g_perf_stats;
+extern ring_spsc_t g_ring_buffer;    // sensor_packet_t x RING_BUFFER_SIZE
+extern performance_stats_t g_perf_stats;     // 定时器 ISR 和 SPI 完成 ISR 的耗时
+extern timebase_periodic_t g_sample_timer;  // 采样定时器：.stats 里是错过的截止时刻、间隔误差 min/max/mean（主循环不打印）
 
 #endif // __IRQ_RINGBUFFER_H
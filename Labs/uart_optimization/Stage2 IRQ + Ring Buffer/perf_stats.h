@@ -0,0 +1,44 @@
+#ifndef __PERF_STATS_H
+#define __PERF_STATS_H
+
+#include "baseline.h"
+#include "../stdio/include/string.h"
+
+// ==================== Performance Statistics ====================
+// 中断耗时统计（Stage 2 / Stage 3 共用）
+// 只有类型和内联函数，统计实例由各阶段自己定义（g_perf_stats / g_perf_stats_dma），
+// 两个阶段不再互相依赖对方的 .c 文件
+
+typedef struct {
+    uint32_t isr_entry_time;        // 中断进入时间
+    uint32_t isr_exit_time;         // 中断退出时间
+    uint32_t max_isr_time;          // 最大中断执行时间
+    uint32_t total_isr_time;        // 总中断时间（用于计算平均）
+    uint32_t isr_count;             // 中断次数
+    
+    uint32_t main_idle_time;        // 主循环空闲时间
+    uint32_t main_send_time;        // 主循环发送时间
+    uint32_t last_activity_time;    // 上次活动时间
+} performance_stats_t;
+
+static inline void perf_stats_reset(performance_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+// 在中断出口调用：entry_time 是中断入口处的 get_system_tick()
+static inline void perf_stats_isr_record(performance_stats_t *stats, uint32_t entry_time)
+{
+    uint32_t exit_time = get_system_tick();
+    uint32_t isr_time = exit_time - entry_time;
+    
+    stats->isr_entry_time = entry_time;
+    stats->isr_exit_time = exit_time;
+    stats->total_isr_time += isr_time;
+    stats->isr_count++;
+    if (isr_time > stats->max_isr_time) {
+        stats->max_isr_time = isr_time;
+    }
+}
+
+#endif // __PERF_STATS_H
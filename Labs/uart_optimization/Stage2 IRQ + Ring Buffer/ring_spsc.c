@@ -0,0 +1,254 @@
+#include "ring_spsc.h"
+#include "../stdio/include/string.h"
+
+// ==================== Common ====================
+
+void ring_spsc_reset(ring_spsc_t *ring)
+{
+    // 显式清零（不依赖 BSS 段清零），策略保持不变
+    ring->head = 0;
+    ring->tail = 0;
+    ring->peek_tail = 0;
+    ring->claim = 0;
+    ring->overflow_count = 0;
+    ring->total_samples = 0;
+    ring->high_water = 0;
+    ring->time_at_full = 0;
+    ring->full_since = 0;
+    ring->is_full = 0;
+    ring->torn_count = 0;
+}
+
+void ring_spsc_set_policy(ring_spsc_t *ring, ring_spsc_policy_t policy,
+                          uint32_t block_timeout)
+{
+    ring->policy = policy;
+    ring->block_timeout = block_timeout;
+}
+
+uint32_t ring_spsc_capacity(ring_spsc_t *ring)
+{
+    return ring->mask + 1;
+}
+
+uint32_t ring_spsc_available(ring_spsc_t *ring)
+{
+    // 自由递增计数器：无符号减法自动处理回绕
+    return ring->head - ring->tail;
+}
+
+uint32_t ring_spsc_free_space(ring_spsc_t *ring)
+{
+    return ring_spsc_capacity(ring) - ring_spsc_available(ring);
+}
+
+// ==================== Producer ====================
+
+void *ring_spsc_reserve(ring_spsc_t *ring)
+{
+    uint32_t head = ring->head;
+    uint32_t wait_start = 0;
+    uint32_t waiting = 0;
+    uint32_t dropped_oldest = 0;
+
+    while (1) {
+        uint32_t tail = ring->tail;
+
+        if (head - tail <= ring->mask) {
+            break;  // 有空槽
+        }
+
+        // 满：开始计时
+        if (!ring->is_full) {
+            ring->is_full = 1;
+            ring->full_since = RING_SPSC_NOW();
+        }
+
+        // 最旧的槽已被 claim_span 领取（claim - tail 在 1 ~ 容量之间）时中断可能正在读它，
+        // 不能覆盖，按丢弃新数据处理；只用 peek / release 时 claim 停在旧值，差值不会落在这个范围
+        if (ring->policy == RING_SPSC_DROP_OLDEST && ring->claim - tail - 1 > ring->mask) {
+            // 推进 tail 丢掉最旧的元素
+            // 消费者的 release 也会改 tail，用 LDREX/STREX 保证不丢更新
+            if (__sync_bool_compare_and_swap(&ring->tail, tail, tail + 1)) {
+                ring->overflow_count++;
+                dropped_oldest = 1;
+                break;
+            }
+            continue;  // 消费者刚好释放了槽，重新判断
+        }
+
+        if (ring->policy == RING_SPSC_BLOCK) {
+            if (!waiting) {
+                waiting = 1;
+                wait_start = RING_SPSC_NOW();
+            }
+            if (RING_SPSC_NOW() - wait_start < ring->block_timeout) {
+                RING_SPSC_WAIT();
+                continue;
+            }
+        }
+
+        // RING_SPSC_DROP_NEWEST，或 RING_SPSC_BLOCK 超时：丢弃新数据
+        ring->overflow_count++;
+        return NULL;
+    }
+
+    // 离开满状态：累计满的时间
+    if (ring->is_full && !dropped_oldest) {
+        ring->time_at_full += RING_SPSC_NOW() - ring->full_since;
+        ring->is_full = 0;
+    }
+
+    return ring->storage + (head & ring->mask) * ring->stride;
+}
+
+void ring_spsc_commit(ring_spsc_t *ring)
+{
+    uint32_t head;
+    uint32_t level;
+
+    // 槽内数据必须先于 head 对消费者可见
+    RING_SPSC_BARRIER();
+    head = ring->head + 1;
+    ring->head = head;
+    ring->total_samples++;
+
+    // 高水位
+    level = head - ring->tail;
+    if (level > ring->high_water) {
+        ring->high_water = level;
+    }
+}
+
+// ==================== Consumer ====================
+
+void *ring_spsc_peek(ring_spsc_t *ring)
+{
+    uint32_t count;
+    return ring_spsc_peek_span(ring, 1, &count);
+}
+
+int ring_spsc_release(ring_spsc_t *ring)
+{
+    return ring_spsc_release_n(ring, 1);
+}
+
+void *ring_spsc_peek_span(ring_spsc_t *ring, uint32_t max, uint32_t *count)
+{
+    uint32_t tail = ring->tail;
+    uint32_t avail = ring->head - tail;
+    uint32_t idx = tail & ring->mask;
+    uint32_t to_end = ring->mask + 1 - idx;   // 到数组末尾（回绕点）的槽数
+
+    if (avail == 0 || max == 0) {
+        *count = 0;
+        return NULL;
+    }
+
+    if (avail > to_end) {
+        avail = to_end;
+    }
+    if (avail > max) {
+        avail = max;
+    }
+    *count = avail;
+    ring->peek_tail = tail;
+
+    RING_SPSC_BARRIER();
+    return ring->storage + idx * ring->stride;
+}
+
+int ring_spsc_release_n(ring_spsc_t *ring, uint32_t n)
+{
+    uint32_t target = ring->peek_tail + n;
+    uint32_t tail;
+    uint32_t dropped;
+
+    // 槽内数据用完之后再交还给生产者
+    RING_SPSC_BARRIER();
+
+    if (ring->policy != RING_SPSC_DROP_OLDEST) {
+        ring->tail = target;
+        return 0;
+    }
+
+    // DROP_OLDEST：生产者可能在持有期间推进了 tail
+    while (1) {
+        tail = ring->tail;
+
+        if (tail == ring->peek_tail) {
+            if (__sync_bool_compare_and_swap(&ring->tail, tail, target)) {
+                return 0;
+            }
+            continue;
+        }
+
+        // 持有的元素中有 dropped 个已被丢弃（槽可能已被新数据覆盖）
+        dropped = tail - ring->peek_tail;
+        if (dropped >= n) {
+            ring->torn_count += n;
+            return -1;  // 全部已被丢弃，tail 已在 target 之后
+        }
+        if (__sync_bool_compare_and_swap(&ring->tail, tail, target)) {
+            ring->torn_count += dropped;
+            return -1;
+        }
+    }
+}
+
+// ==================== Claimed Consumer ====================
+
+void *ring_spsc_claim_span(ring_spsc_t *ring, uint32_t max, uint32_t *count)
+{
+    uint32_t tail = ring->tail;
+    uint32_t start = ring->claim;
+    uint32_t avail, idx, to_end;
+
+    // DROP_OLDEST 在没有领取中的槽时会推进 tail，越过 claim 的部分已被丢弃
+    if ((int32_t)(tail - start) > 0) {
+        start = tail;
+    }
+
+    avail = ring->head - start;
+    idx = start & ring->mask;
+    to_end = ring->mask + 1 - idx;
+
+    if (avail == 0 || max == 0) {
+        *count = 0;
+        return NULL;
+    }
+
+    if (avail > to_end) {
+        avail = to_end;
+    }
+    if (avail > max) {
+        avail = max;
+    }
+
+    // 先发布 claim，生产者看到 claim != tail 后就不会再覆盖最旧的槽
+    ring->claim = start + avail;
+    RING_SPSC_BARRIER();
+
+    // 发布之前生产者（中断）可能已经丢掉了 start 开始的槽：本次放弃，下次从新的 tail 领取
+    if (ring->tail != tail && (int32_t)(ring->tail - start) > 0) {
+        ring->claim = start;
+        *count = 0;
+        return NULL;
+    }
+
+    *count = avail;
+    return ring->storage + idx * ring->stride;
+}
+
+void ring_spsc_claim_cancel(ring_spsc_t *ring, uint32_t n)
+{
+    ring->claim -= n;
+}
+
+void ring_spsc_release_claimed(ring_spsc_t *ring, uint32_t n)
+{
+    // 槽内数据读完之后再交还给生产者
+    // tail ~ claim 之间有槽时生产者不会推进 tail（见 ring_spsc_reserve），这里不需要 CAS
+    RING_SPSC_BARRIER();
+    ring->tail = ring->tail + n;
+}
@@ -0,0 +1,115 @@
+#ifndef __RING_SPSC_H
+#define __RING_SPSC_H
+
+#include "../stdio/include/types.h"
+
+// ==================== SPSC Ring Buffer ====================
+// 单生产者 / 单消费者无锁环形缓冲区（Stage 2 / Stage 3 共用）
+// - 生产者（GPT1 ISR）：reserve → 在槽内直接构造数据 → commit
+// - 消费者（主循环）：  peek    → 直接使用槽内数据   → release
+// - 全程零拷贝，不再 memcpy 进出缓冲区
+// - 批量消费：peek_span 一次返回回绕点之前的最大连续区间
+// - 异步消费：claim_span 领取一段槽交给 DMA / UART 中断直接读取，发完后在完成回调里
+//   release_claimed 归还；领取未归还的槽可以有多段（按领取顺序归还），不与 peek / release 混用
+// - 元素类型和容量在编译期给定（RING_SPSC_DEFINE），容量必须是 2 的幂
+// - head / tail 是自由递增的计数器，全部 N 个槽都可用（不用空一个槽区分满/空）
+// - 满时策略可选：丢最新 / 丢最旧（覆盖）/ 阻塞等待（仅限任务上下文，RTOS 用）
+// - 统计高水位和处于"满"状态的累计时间，用数据决定 RING_BUFFER_SIZE
+
+// 槽宽度按 4 字节对齐
+// sensor_packet_t 是 30 字节的 packed 结构体，紧密排列时第 2 个槽开始
+// uint32_t 字段落在非对齐地址上，原地构造会触发非对齐访问
+#define RING_SPSC_STRIDE(size)      (((size) + 3u) & ~3u)
+
+// 内存屏障：保证槽内数据在索引更新之前写完 / 读完
+#ifndef RING_SPSC_BARRIER
+#define RING_SPSC_BARRIER()         __asm volatile ("dmb" ::: "memory")
+#endif
+
+// 时间源（用于满状态计时和阻塞超时），默认 GPT1 自由计数器
+// FreeRTOS 工程里 GPT1 也是自由运行的 Tick 定时器，同样可用
+#ifndef RING_SPSC_NOW
+#include "../imx6ul/imx6ul.h"
+#define RING_SPSC_NOW()             (GPT1->CNT)
+#endif
+
+// RING_SPSC_BLOCK 策略下每次等待调用的钩子
+// 裸机默认空转；RTOS 工程定义为让出 CPU，例如 -D'RING_SPSC_WAIT()=vTaskDelay(1)'
+#ifndef RING_SPSC_WAIT
+#define RING_SPSC_WAIT()            do { } while (0)
+#endif
+
+// ==================== Overflow Policy ====================
+typedef enum {
+    RING_SPSC_DROP_NEWEST = 0,  // 满时丢弃新数据（默认，ISR 安全）
+    RING_SPSC_DROP_OLDEST,      // 满时覆盖最旧数据（ISR 安全，消费者持有的槽可能被覆盖；
+                                //   最旧的槽已被 claim 时改为丢弃新数据）
+    RING_SPSC_BLOCK,            // 满时等待消费者，超时后丢弃新数据（只能在任务中使用）
+} ring_spsc_policy_t;
+
+// ==================== Ring Structure ====================
+typedef struct {
+    uint8_t *storage;                   // 槽存储区（4 字节对齐）
+    uint32_t stride;                    // 每个槽的字节数
+    uint32_t mask;                      // 容量 - 1
+    volatile uint32_t head;             // 已提交计数（只由生产者修改）
+    volatile uint32_t tail;             // 已释放计数（消费者修改；DROP_OLDEST 时生产者也会推进）
+    uint32_t peek_tail;                 // 消费者 peek 时看到的 tail（只由消费者使用）
+    volatile uint32_t claim;            // 已领取计数（只由消费者修改），tail ~ claim 之间的槽正在发送
+
+    ring_spsc_policy_t policy;          // 满时策略
+    uint32_t block_timeout;             // RING_SPSC_BLOCK 的超时（RING_SPSC_NOW 的 tick 数）
+
+    volatile uint32_t overflow_count;   // 丢失的元素数（任何策略下被丢弃的都算）
+    volatile uint32_t total_samples;    // 总提交次数
+    volatile uint32_t high_water;       // 提交后出现过的最大占用槽数
+    volatile uint32_t time_at_full;     // 处于满状态的累计 tick 数
+    uint32_t full_since;                // 本次进入满状态的时间
+    uint32_t is_full;                   // 生产者上次看到的是否为满
+    volatile uint32_t torn_count;       // 消费者持有期间被 DROP_OLDEST 覆盖的元素数
+} ring_spsc_t;
+
+// 定义一个环形缓冲区（全局变量 name + 静态存储区）
+// 例：RING_SPSC_DEFINE(g_ring_buffer, sensor_packet_t, 16);
+#define RING_SPSC_DEFINE(name, type, capacity)                                  \
+    typedef char name##_capacity_must_be_pow2                                   \
+        [((((capacity) & ((capacity) - 1)) == 0) && (capacity) > 0) ? 1 : -1]; \
+    static uint32_t name##_storage                                              \
+        [(capacity) * RING_SPSC_STRIDE(sizeof(type)) / 4];                      \
+    ring_spsc_t name = {                                                        \
+        .storage = (uint8_t *)name##_storage,                                   \
+        .stride = RING_SPSC_STRIDE(sizeof(type)),                               \
+        .mask = (capacity) - 1,                                                 \
+        .policy = RING_SPSC_DROP_NEWEST,                                        \
+    }
+
+// ==================== Function Declarations ====================
+
+// 通用
+void ring_spsc_reset(ring_spsc_t *ring);                // 清空并清零统计（必须在中断启动前调用）
+void ring_spsc_set_policy(ring_spsc_t *ring, ring_spsc_policy_t policy,
+                          uint32_t block_timeout);      // 设置满时策略（中断启动前调用）
+uint32_t ring_spsc_capacity(ring_spsc_t *ring);         // 槽数量
+uint32_t ring_spsc_available(ring_spsc_t *ring);        // 可读元素数量
+uint32_t ring_spsc_free_space(ring_spsc_t *ring);       // 可写槽数量
+
+// 生产者（ISR）
+void *ring_spsc_reserve(ring_spsc_t *ring);             // 返回空槽指针，满时按策略处理，丢弃新数据时返回 NULL
+void ring_spsc_commit(ring_spsc_t *ring);               // 发布 reserve 得到的槽
+
+// 消费者（主循环）
+void *ring_spsc_peek(ring_spsc_t *ring);                // 返回最旧元素指针，空时返回 NULL
+int ring_spsc_release(ring_spsc_t *ring);               // 归还 peek 得到的槽，0=正常，-1=持有期间被覆盖
+
+// 消费者批量接口（连续区间，槽间距为 ring->stride）
+// 返回最旧元素指针，*count = min(max, 可读数量, 到回绕点的槽数)；空时返回 NULL
+void *ring_spsc_peek_span(ring_spsc_t *ring, uint32_t max, uint32_t *count);
+int ring_spsc_release_n(ring_spsc_t *ring, uint32_t n);  // 一次归还 n 个槽，返回值同 release
+
+// 消费者异步接口（领取后由完成回调归还，数据不离开槽）
+// 返回第一个未领取元素的指针，*count 规则同 peek_span；空时返回 NULL
+void *ring_spsc_claim_span(ring_spsc_t *ring, uint32_t max, uint32_t *count);
+void ring_spsc_claim_cancel(ring_spsc_t *ring, uint32_t n);      // 撤销最近一次领取的 n 个槽（没交出去时）
+void ring_spsc_release_claimed(ring_spsc_t *ring, uint32_t n);   // 按领取顺序归还最早的 n 个槽（可在中断中调用）
+
+#endif // __RING_SPSC_H
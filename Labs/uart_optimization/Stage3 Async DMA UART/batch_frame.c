@@ -0,0 +1,155 @@
+#include "batch_frame.h"
+#include "packet_crc.h"
+
+// ==================== Private Functions ====================
+
+// 逐字节写小端（帧缓冲区内的偏移不保证对齐）
+static void put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)((v >> 8) & 0xFF);
+    p[2] = (uint8_t)((v >> 16) & 0xFF);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+// 无符号 varint：每字节 7 位，最高位 1 表示后面还有
+static uint32_t put_varint(uint8_t *p, uint32_t v)
+{
+    uint32_t n = 0;
+
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+// zigzag：0, -1, 1, -2 ... → 0, 1, 2, 3 ...，小幅正负值都编码成小数
+static uint32_t zigzag32(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+// 压缩帧：编码一个样本，返回字节数
+static uint32_t encode_delta_sample(batch_frame_t *frame, uint8_t *p,
+                                    uint32_t dt, const int16_t axis[6])
+{
+    uint32_t n = 0;
+    uint32_t i;
+
+    n += put_varint(p + n, zigzag32((int32_t)dt - (int32_t)frame->last_dt));
+    for (i = 0; i < 6; i++) {
+        int16_t delta = (int16_t)(uint16_t)(axis[i] - frame->last_axis[i]);  // 16 位回绕差分
+        n += put_varint(p + n, zigzag32(delta));
+        frame->last_axis[i] = axis[i];
+    }
+    frame->last_dt = dt;
+    return n;
+}
+
+// ==================== Public Functions ====================
+
+void batch_frame_begin(batch_frame_t *frame, uint32_t max_count, uint8_t compress)
+{
+    uint32_t i;
+
+    if (max_count == 0) {
+        max_count = 1;
+    }
+    if (max_count > BATCH_FRAME_MAX_SAMPLES) {
+        max_count = BATCH_FRAME_MAX_SAMPLES;
+    }
+
+    frame->compress = compress ? 1 : 0;
+    frame->len = compress ? BATCH_FRAME_DELTA_HEAD_LEN : BATCH_FRAME_HEAD_LEN;
+    frame->count = 0;
+    frame->max_count = max_count;
+    frame->next_seq = 0;
+    frame->last_ts = 0;
+
+    // 关键帧：第一个样本相对 0 编码
+    frame->last_dt = 0;
+    for (i = 0; i < 6; i++) {
+        frame->last_axis[i] = 0;
+    }
+}
+
+int batch_frame_add(batch_frame_t *frame, const sensor_packet_t *pkt)
+{
+    uint8_t *p = frame->buf + frame->len;
+    uint32_t dt = 0;
+
+    if (frame->count >= frame->max_count) {
+        return -1;
+    }
+    if (frame->compress &&
+        frame->len + BATCH_FRAME_DELTA_MAX_SAMPLE + BATCH_FRAME_CRC_LEN > BATCH_FRAME_MAX_LEN) {
+        return -1;  // 按最坏情况预留，保证不越界
+    }
+
+    if (frame->count == 0) {
+        // 第一个样本决定帧的 seq 和基准时间戳
+        put_u16(frame->buf + 3, pkt->seq_num);
+        put_u32(frame->buf + 5, pkt->timestamp);
+    } else {
+        dt = pkt->timestamp - frame->last_ts;   // 无符号减法处理回绕
+        if (pkt->seq_num != frame->next_seq || dt > 0xFFFF) {
+            return -1;  // 中间有丢包或间隔太长，另起一帧
+        }
+    }
+
+    if (frame->compress) {
+        int16_t axis[6];
+
+        axis[0] = pkt->accel_x;
+        axis[1] = pkt->accel_y;
+        axis[2] = pkt->accel_z;
+        axis[3] = pkt->gyro_x;
+        axis[4] = pkt->gyro_y;
+        axis[5] = pkt->gyro_z;
+        frame->len += encode_delta_sample(frame, p, dt, axis);
+    } else {
+        put_u16(p + 0, (uint16_t)dt);
+        put_u16(p + 2, (uint16_t)pkt->accel_x);
+        put_u16(p + 4, (uint16_t)pkt->accel_y);
+        put_u16(p + 6, (uint16_t)pkt->accel_z);
+        put_u16(p + 8, (uint16_t)pkt->gyro_x);
+        put_u16(p + 10, (uint16_t)pkt->gyro_y);
+        put_u16(p + 12, (uint16_t)pkt->gyro_z);
+        frame->len += BATCH_FRAME_SAMPLE_LEN;
+    }
+
+    frame->count++;
+    frame->next_seq = (uint16_t)(pkt->seq_num + 1);
+    frame->last_ts = pkt->timestamp;
+    return 0;
+}
+
+uint32_t batch_frame_finish(batch_frame_t *frame)
+{
+    uint16_t crc;
+
+    if (frame->count == 0) {
+        return 0;
+    }
+
+    frame->buf[0] = BATCH_FRAME_HEADER0;
+    frame->buf[1] = frame->compress ? BATCH_FRAME_HEADER1_DELTA : BATCH_FRAME_HEADER1;
+    frame->buf[2] = (uint8_t)frame->count;
+    if (frame->compress) {
+        put_u16(frame->buf + 9, (uint16_t)(frame->len - BATCH_FRAME_DELTA_HEAD_LEN));
+    }
+
+    crc = crc16_ccitt(frame->buf, frame->len);
+    frame->buf[frame->len++] = (uint8_t)(crc >> 8);     // 高字节在前，与单包 CRC-16 一致
+    frame->buf[frame->len++] = (uint8_t)(crc & 0xFF);
+
+    return frame->len;
+}
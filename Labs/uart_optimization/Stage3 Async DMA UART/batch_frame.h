@@ -0,0 +1,67 @@
+#ifndef __BATCH_FRAME_H
+#define __BATCH_FRAME_H
+
+#include "../stdio/include/types.h"
+#include "baseline.h"
+// ==================== 批量遥测帧 ====================
+// sensor_packet_t 每 12 字节的六轴数据要带 18 字节的包头 / 时间 / 校验开销
+// 批量帧把 N 个连续样本打成一帧，只带一次包头、基准时间戳和 CRC：
+//
+//   偏移  长度   内容
+//   0     2      帧头 0xAA 0x56（单包是 0xAA 0x55）
+//   2     1      样本数 N（1 ~ BATCH_FRAME_MAX_SAMPLES）
+//   3     2      第一个样本的 seq（小端）
+//   5     4      第一个样本的时间戳（GPT1 tick，小端）
+//   9     14*N   每个样本：dt(u16，距上一个样本的 tick 数，第一个为 0) + accel_x/y/z + gyro_x/y/z（i16）
+//   9+14N 2      CRC-16/CCITT-FALSE（覆盖前面所有字节，高字节在前）
+//
+// 帧内样本的 seq 必须连续、dt 必须放得进 16 位，否则 batch_frame_add() 拒绝，调用方先发出当前帧
+// process_time / send_time 不进批量帧（控制台统计里仍然有）
+//
+// 压缩帧（compress=1）：相邻样本高度相关，改为发差分
+//   0     2      帧头 0xAA 0x57
+//   2     1      样本数 N
+//   3     2      第一个样本的 seq
+//   5     4      第一个样本的时间戳
+//   9     2      负载字节数 L（小端）
+//   11    L      每个样本：varint(zigzag(dt - 上一个 dt)) + 6 x varint(zigzag(轴值 - 上一个样本的轴值))
+//   11+L  2      CRC-16
+// - 每帧第一个样本相对 0 编码（关键帧），帧之间互不依赖，丢一帧不影响后面的解码
+// - 轴差分按 16 位回绕计算，zigzag 后最多 3 个 varint 字节，无损
+// - 安静信号下每个样本约 7 字节（原始批量帧 14 字节，单包 30 字节）
+
+#define BATCH_FRAME_HEADER0         0xAA
+#define BATCH_FRAME_HEADER1         0x56
+#define BATCH_FRAME_HEADER1_DELTA   0x57
+#define BATCH_FRAME_HEAD_LEN        9
+#define BATCH_FRAME_DELTA_HEAD_LEN  11
+#define BATCH_FRAME_DELTA_MAX_SAMPLE 21     // 最坏情况：dt 3 字节 + 6 轴 x 3 字节
+#define BATCH_FRAME_SAMPLE_LEN      14
+#define BATCH_FRAME_CRC_LEN         2
+#define BATCH_FRAME_MAX_SAMPLES     32
+#define BATCH_FRAME_LEN(n)          (BATCH_FRAME_HEAD_LEN + (n) * BATCH_FRAME_SAMPLE_LEN + BATCH_FRAME_CRC_LEN)
+#define BATCH_FRAME_MAX_LEN         BATCH_FRAME_LEN(BATCH_FRAME_MAX_SAMPLES)
+
+// ==================== Data Structures ====================
+
+typedef struct {
+    uint8_t buf[BATCH_FRAME_MAX_LEN];
+    uint32_t len;               // 已写入字节数
+    uint32_t count;             // 已加入的样本数
+    uint32_t max_count;         // 本帧样本上限
+    uint16_t next_seq;          // 下一个样本应有的 seq
+    uint32_t last_ts;           // 上一个样本的时间戳
+    uint8_t compress;           // 1=差分 + zigzag + varint
+    uint32_t last_dt;           // 压缩帧：上一个样本的 dt
+    int16_t last_axis[6];       // 压缩帧：上一个样本的六轴值
+} batch_frame_t;
+
+// ==================== Function Declarations ====================
+
+void batch_frame_begin(batch_frame_t *frame, uint32_t max_count,
+                       uint8_t compress);                          // 清空，max_count 超过上限时截断
+int batch_frame_add(batch_frame_t *frame, const sensor_packet_t *pkt);  // 0=已加入，-1=帧满 / seq 不连续 / dt 溢出
+                                                                        // 压缩帧剩余空间不够最坏情况时也返回 -1
+uint32_t batch_frame_finish(batch_frame_t *frame);                 // 写入样本数和 CRC，返回帧长（空帧返回 0）
+
+#endif // __BATCH_FRAME_H
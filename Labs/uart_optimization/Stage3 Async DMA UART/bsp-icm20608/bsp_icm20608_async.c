@@ -0,0 +1,357 @@
+#include "bsp_icm20608_async.h"
+#include "../int/bsp_int.h"
+#include "../../stdio/include/string.h"
+#include "../../stdio/include/stdio.h"
+#include "../delay/bsp_delay.h"
+#include "../gpio/bsp_gpio.h"
+
+// ==================== Private Variables ====================
+
+// RX 缓冲区（存放读到的数据，不含地址字节）
+static uint8_t icm_rx_buffer[ICM20608_ASYNC_MAX_LEN];
+
+// 传输状态
+static uint32_t icm_rx_len;             // 本次要读的字节数
+static uint32_t icm_rx_idx;             // 已收到的数据字节数
+static uint32_t icm_chunk_len;          // 当前块在 FIFO 中的字节数
+static uint32_t icm_chunk_skip;         // 当前块开头要丢弃的字节数（地址字节对应的回读）
+static volatile int icm_busy;           // 是否正在读取
+static icm20608_async_cb_t icm_cb;
+static void *icm_cb_param;
+
+// FIFO 模式
+static icm20608_fifo_cb_t icm_fifo_cb;
+static void *icm_fifo_cb_param;
+
+// DRDY 模式
+static icm20608_drdy_cb_t icm_drdy_cb;
+static void *icm_drdy_cb_param;
+
+// 统计
+static icm20608_async_stats_t g_icm_stats;
+
+// ==================== Private Functions ====================
+
+// 填充下一块并启动传输
+// first: 第一块需要先发地址字节
+static void icm_start_chunk(uint8_t first_byte, int first)
+{
+    uint32_t remaining = icm_rx_len - icm_rx_idx;
+    uint32_t room = first ? ICM20608_ASYNC_FIFO_DEPTH - 1 : ICM20608_ASYNC_FIFO_DEPTH;
+    uint32_t n = (remaining < room) ? remaining : room;
+    uint32_t i;
+
+    icm_chunk_len = n + (first ? 1 : 0);
+    icm_chunk_skip = first ? 1 : 0;
+
+    // 先写 FIFO，再置 XCH 启动（SMC=0 时写 FIFO 不会自动开始）
+    if (first) {
+        ECSPI3->TXDATA = first_byte;
+    }
+    for (i = 0; i < n; i++) {
+        ECSPI3->TXDATA = 0xFF;  // 读取时发送哑字节
+    }
+
+    ECSPI3->STATREG = 1 << 7;       // 清除 TC
+    ECSPI3->CONREG |= (1 << 2);     // XCH: 开始传输
+    g_icm_stats.chunks++;
+}
+
+// 输出数据率 → SMPLRT_DIV（1kHz / (1 + SMPLRT_DIV)）
+static uint8_t icm_odr_to_div(uint32_t odr_hz)
+{
+    uint32_t div = (odr_hz == 0) ? 256 : 1000 / odr_hz;
+
+    if (div == 0) {
+        div = 1;
+    }
+    if (div > 256) {
+        div = 256;
+    }
+    return (uint8_t)(div - 1);
+}
+
+// ==================== Public Functions ====================
+
+void icm20608_async_init(void)
+{
+    icm_rx_len = 0;
+    icm_rx_idx = 0;
+    icm_busy = 0;
+    icm_cb = NULL;
+    icm_cb_param = NULL;
+    icm_drdy_cb = NULL;
+    icm_drdy_cb_param = NULL;
+    memset(&g_icm_stats, 0, sizeof(g_icm_stats));
+
+    // 关闭 ECSPI3 所有中断，清除状态
+    ECSPI3->INTREG = 0;
+    ECSPI3->STATREG = (1 << 7) | (1 << 6);  // TC | RO（写 1 清除）
+
+    system_register_irqhandler(ECSPI3_IRQn, (system_irq_handler_t)ecspi3_irq_handler, NULL);
+    GIC_EnableIRQ(ECSPI3_IRQn);
+
+    printf("[ICM] Async ECSPI3 read initialized (CONREG=0x%08X)\r\n", ECSPI3->CONREG);
+}
+
+int icm20608_async_read(uint8_t reg, uint32_t len, icm20608_async_cb_t cb, void *param)
+{
+    if (len == 0 || len > ICM20608_ASYNC_MAX_LEN || cb == NULL) {
+        return -2;
+    }
+
+    if (icm_busy) {
+        g_icm_stats.busy_rejects++;
+        return -1;
+    }
+
+    icm_busy = 1;
+    icm_rx_len = len;
+    icm_rx_idx = 0;
+    icm_cb = cb;
+    icm_cb_param = param;
+
+    // 清空 RX FIFO 中残留的数据
+    while (ECSPI3->STATREG & (1 << 3)) {    // RR: RX FIFO 有数据
+        (void)ECSPI3->RXDATA;
+    }
+
+    // SMC=0：写 TXFIFO 不立即启动，由 XCH 统一启动（阻塞驱动使用 SMC=1，完成后恢复）
+    ECSPI3->CONREG &= ~(1 << 3);
+
+    ICM20608_ASYNC_CS_LOW();
+    icm_start_chunk(reg | 0x80, 1);         // bit7=1 表示读
+
+    // TCEN: 传输完成中断
+    ECSPI3->INTREG = 1 << 7;
+
+    return 0;
+}
+
+int icm20608_async_is_busy(void)
+{
+    return icm_busy;
+}
+
+void icm20608_async_decode(const uint8_t *data,
+                           int16_t *ax, int16_t *ay, int16_t *az,
+                           int16_t *gx, int16_t *gy, int16_t *gz)
+{
+    // ACCEL_X/Y/Z(6) + TEMP(2) + GYRO_X/Y/Z(6)，高字节在前
+    *ax = (int16_t)((data[0] << 8) | data[1]);
+    *ay = (int16_t)((data[2] << 8) | data[3]);
+    *az = (int16_t)((data[4] << 8) | data[5]);
+    *gx = (int16_t)((data[8] << 8) | data[9]);
+    *gy = (int16_t)((data[10] << 8) | data[11]);
+    *gz = (int16_t)((data[12] << 8) | data[13]);
+}
+
+// ==================== FIFO Mode ====================
+
+void icm20608_fifo_config(uint32_t odr_hz)
+{
+    uint8_t div = icm_odr_to_div(odr_hz);
+
+    // 1. 停止 FIFO 写入并复位
+    //    USER_CTRL 其他位（I2C_IF_DIS 等）由 icm20608_init() 配置，只改 FIFO 相关位
+    icm20608_write_reg(ICM20608_REG_FIFO_EN, 0x00);
+    uint8_t ctrl = icm20608_read_reg(ICM20608_REG_USER_CTRL) & ~(1 << 6);
+    icm20608_write_reg(ICM20608_REG_USER_CTRL, ctrl | (1 << 2));   // FIFO_EN=0 + FIFO_RST（自动清零）
+    delayms(1);
+
+    // 2. 采样率：1kHz / (1 + SMPLRT_DIV)
+    //    DLPF_CFG=1（陀螺仪 176Hz 带宽）+ FIFO_MODE=1（满后不覆盖）
+    icm20608_write_reg(ICM20608_REG_SMPLRT_DIV, div);
+    icm20608_write_reg(ICM20608_REG_CONFIG, (1 << 6) | 0x01);
+    icm20608_write_reg(ICM20608_REG_ACCEL_CONFIG2, 0x01);  // 加速度计 218Hz 带宽
+
+    // 3. XG | YG | ZG | ACCEL 进 FIFO，使能 FIFO
+    icm20608_write_reg(ICM20608_REG_FIFO_EN, (1 << 6) | (1 << 5) | (1 << 4) | (1 << 3));
+    icm20608_write_reg(ICM20608_REG_USER_CTRL, ctrl | (1 << 6));   // FIFO_EN
+
+    printf("[ICM] FIFO mode: ODR=%u Hz, %u bytes/sample\r\n",
+           1000 / (div + 1), ICM20608_FIFO_RECORD_LEN);
+}
+
+// 第二步：FIFO 数据读完
+static void icm_fifo_data_done(const uint8_t *data, uint32_t len, void *param)
+{
+    uint32_t count = len / ICM20608_FIFO_RECORD_LEN;
+
+    g_icm_stats.fifo_drains++;
+    g_icm_stats.fifo_records += count;
+    if (count > g_icm_stats.fifo_max_records) {
+        g_icm_stats.fifo_max_records = count;
+    }
+
+    icm_fifo_cb(data, count, icm_fifo_cb_param);
+}
+
+// 第一步：FIFO_COUNT 读完，启动数据读取
+static void icm_fifo_count_done(const uint8_t *data, uint32_t len, void *param)
+{
+    uint32_t count = ((data[0] & 0x1F) << 8) | data[1];
+
+    if (count >= ICM20608_FIFO_SIZE - ICM20608_FIFO_RECORD_LEN) {
+        g_icm_stats.fifo_overflows++;   // 满了，之后的样本被丢弃
+    }
+
+    // 只读完整样本（ICM20608_ASYNC_MAX_LEN 以内），剩下的留到下次
+    if (count > ICM20608_ASYNC_MAX_LEN) {
+        count = ICM20608_ASYNC_MAX_LEN;
+    }
+    count -= count % ICM20608_FIFO_RECORD_LEN;
+
+    if (count == 0) {
+        g_icm_stats.fifo_drains++;
+        icm_fifo_cb(icm_rx_buffer, 0, icm_fifo_cb_param);
+        return;
+    }
+
+    // 回调时 icm_busy 已清零，可以直接开始下一次读取
+    icm20608_async_read(ICM20608_REG_FIFO_R_W, count, icm_fifo_data_done, NULL);
+}
+
+int icm20608_fifo_drain(icm20608_fifo_cb_t cb, void *param)
+{
+    if (icm_busy) {
+        g_icm_stats.busy_rejects++;
+        return -1;
+    }
+
+    icm_fifo_cb = cb;
+    icm_fifo_cb_param = param;
+
+    // FIFO_COUNTH + FIFO_COUNTL
+    return icm20608_async_read(ICM20608_REG_FIFO_COUNTH, 2, icm_fifo_count_done, NULL);
+}
+
+void icm20608_fifo_decode(const uint8_t *record,
+                          int16_t *ax, int16_t *ay, int16_t *az,
+                          int16_t *gx, int16_t *gy, int16_t *gz)
+{
+    // FIFO 中按寄存器顺序：ACCEL_X/Y/Z 然后 GYRO_X/Y/Z，高字节在前
+    *ax = (int16_t)((record[0] << 8) | record[1]);
+    *ay = (int16_t)((record[2] << 8) | record[3]);
+    *az = (int16_t)((record[4] << 8) | record[5]);
+    *gx = (int16_t)((record[6] << 8) | record[7]);
+    *gy = (int16_t)((record[8] << 8) | record[9]);
+    *gz = (int16_t)((record[10] << 8) | record[11]);
+}
+
+// ==================== DRDY Mode ====================
+
+void icm20608_drdy_init(uint32_t odr_hz, icm20608_drdy_cb_t cb, void *param)
+{
+    gpio_pin_config_t drdy_config;
+    uint8_t div = icm_odr_to_div(odr_hz);
+
+    icm_drdy_cb = cb;
+    icm_drdy_cb_param = param;
+
+    // 1. 引脚复用为 GPIO，输入，上升沿中断（先不使能）
+    IOMUXC_SetPinMux(ICM20608_DRDY_PINMUX, 0);
+    drdy_config.direction = kGPIO_DigitalInput;
+    drdy_config.outputLogic = 0;
+    drdy_config.interruptMode = kGPIO_IntRisingEdge;
+    gpio_init(ICM20608_DRDY_GPIO, ICM20608_DRDY_PIN, &drdy_config);
+    gpio_disableint(ICM20608_DRDY_GPIO, ICM20608_DRDY_PIN);
+    gpio_clearintflags(ICM20608_DRDY_GPIO, ICM20608_DRDY_PIN);
+
+    // 2. ICM20608：采样率 + INT 引脚（高有效、推挽、50μs 脉冲）+ DATA_RDY_INT_EN
+    icm20608_write_reg(ICM20608_REG_SMPLRT_DIV, div);
+    icm20608_write_reg(ICM20608_REG_INT_PIN_CFG, 0x00);
+    icm20608_write_reg(ICM20608_REG_INT_ENABLE, 1 << 0);
+
+    system_register_irqhandler(ICM20608_DRDY_IRQn, (system_irq_handler_t)icm20608_drdy_irq_handler, NULL);
+    GIC_EnableIRQ(ICM20608_DRDY_IRQn);
+
+    printf("[ICM] DRDY mode: ODR=%u Hz, INT on GPIO pin %d\r\n",
+           1000 / (div + 1), ICM20608_DRDY_PIN);
+}
+
+void icm20608_drdy_enable(void)
+{
+    gpio_clearintflags(ICM20608_DRDY_GPIO, ICM20608_DRDY_PIN);
+    gpio_enableint(ICM20608_DRDY_GPIO, ICM20608_DRDY_PIN);
+}
+
+void icm20608_drdy_disable(void)
+{
+    gpio_disableint(ICM20608_DRDY_GPIO, ICM20608_DRDY_PIN);
+}
+
+icm20608_async_stats_t* icm20608_async_get_stats(void)
+{
+    return &g_icm_stats;
+}
+
+// ==================== Interrupt Handler ====================
+
+void ecspi3_irq_handler(void)
+{
+    uint32_t irq_start = ICM20608_ASYNC_NOW();
+    uint32_t status = ECSPI3->STATREG;
+    uint32_t i;
+
+    // === 只处理 TC（传输完成）===
+    if (!(status & (1 << 7))) {
+        return;
+    }
+    ECSPI3->STATREG = 1 << 7;
+
+    if (status & (1 << 6)) {                // RO: RX FIFO 溢出
+        ECSPI3->STATREG = 1 << 6;
+        g_icm_stats.rx_overruns++;
+    }
+
+    // === 取出本块收到的数据 ===
+    for (i = 0; i < icm_chunk_len; i++) {
+        uint8_t byte = ECSPI3->RXDATA & 0xFF;
+        if (icm_chunk_skip > 0) {
+            icm_chunk_skip--;               // 地址字节对应的回读，丢弃
+        } else if (icm_rx_idx < icm_rx_len) {
+            icm_rx_buffer[icm_rx_idx++] = byte;
+        }
+    }
+
+    // === 还有数据：继续下一块（CS 保持低电平）===
+    if (icm_rx_idx < icm_rx_len) {
+        icm_start_chunk(0, 0);
+    } else {
+        // === 全部完成 ===
+        ECSPI3->INTREG = 0;
+        ICM20608_ASYNC_CS_HIGH();
+        ECSPI3->CONREG |= (1 << 3);         // 恢复 SMC，阻塞驱动可以继续使用
+        g_icm_stats.transfers++;
+        icm_busy = 0;
+
+        icm_cb(icm_rx_buffer, icm_rx_len, icm_cb_param);
+    }
+
+    uint32_t irq_ticks = ICM20608_ASYNC_NOW() - irq_start;
+    if (irq_ticks > g_icm_stats.max_irq_ticks) {
+        g_icm_stats.max_irq_ticks = irq_ticks;
+    }
+}
+
+void icm20608_drdy_irq_handler(void)
+{
+    // 第一件事：锁存时间戳，之后的处理不影响样本时间
+    uint32_t edge_time = ICM20608_ASYNC_NOW();
+
+    if (!(ICM20608_DRDY_GPIO->ISR & (1 << ICM20608_DRDY_PIN))) {
+        return;     // 同一组合中断里的其他引脚
+    }
+    gpio_clearintflags(ICM20608_DRDY_GPIO, ICM20608_DRDY_PIN);
+    g_icm_stats.drdy_edges++;
+
+    if (icm_drdy_cb != NULL) {
+        icm_drdy_cb(edge_time, icm_drdy_cb_param);
+    }
+
+    uint32_t latency = ICM20608_ASYNC_NOW() - edge_time;
+    if (latency > g_icm_stats.drdy_max_latency) {
+        g_icm_stats.drdy_max_latency = latency;
+    }
+}
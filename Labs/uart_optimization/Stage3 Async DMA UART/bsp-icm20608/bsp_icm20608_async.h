@@ -0,0 +1,194 @@
+#ifndef _BSP_ICM20608_ASYNC_H
+#define _BSP_ICM20608_ASYNC_H
+
+#include "../../imx6ul/MCIMX6Y2.h"
+#include "../../stdio/include/types.h"
+#include "bsp_icm20608.h"
+// ==================== ICM20608 异步读取模块 ====================
+// 用 ECSPI3 传输完成中断（TC）驱动的状态机代替阻塞式 icm20608_read_data()
+// 定时器 ISR 只负责拉低 CS、填 TX FIFO、启动传输（几 μs）
+// 传输完成中断里取出 RX FIFO、拉高 CS、调用回调（在回调中组包并写入 Ring Buffer）
+// 超过 FIFO 深度的读取自动分块，CS 在整个读取期间保持低电平
+// FIFO 模式：ICM20608 以高 ODR（如 1kHz）把样本写进自身 512 字节 FIFO，
+// 定时器以较低频率一次突发读出（先读 FIFO_COUNT，再读 FIFO_R_W）
+// DRDY 模式：ICM20608 INT 引脚接 GPIO 中断，每次转换完成触发一次，
+// 中断入口第一条语句锁存时间戳，采样和传感器转换时钟同步，不会读到旧数据或重复数据
+//
+// 前提：
+// - icm20608_init() 已完成（ECSPI3 由阻塞驱动初始化，这里只接管 INTREG/XCH）
+// - 异步读取进行期间不要再调用阻塞 SPI 函数
+// - CS 是 GPIO1_IO20，跨中断保持低电平，其他地方对 GPIO1->DR 的读-改-写
+//   （例如 led0_switch()）需要关中断，见 ICM20608_ASYNC_GPIO_LOCK()
+
+// ==================== Configuration ====================
+
+#define ICM20608_ASYNC_FIFO_DEPTH   64      // ECSPI TX/RX FIFO 深度（32 位 x 64）
+#define ICM20608_ASYNC_MAX_LEN      512     // 单次读取最大字节数（ICM20608 FIFO 为 512 字节）
+
+// ICM20608 寄存器
+#define ICM20608_REG_ACCEL_XOUT_H   0x3B    // ACCEL(6) + TEMP(2) + GYRO(6) 连续 14 字节
+#define ICM20608_SENSOR_DATA_LEN    14
+#define ICM20608_REG_SMPLRT_DIV     0x19
+#define ICM20608_REG_CONFIG         0x1A
+#define ICM20608_REG_ACCEL_CONFIG2  0x1D
+#define ICM20608_REG_FIFO_EN        0x23
+#define ICM20608_REG_INT_PIN_CFG    0x37
+#define ICM20608_REG_INT_ENABLE     0x38
+#define ICM20608_REG_USER_CTRL      0x6A
+#define ICM20608_REG_FIFO_COUNTH    0x72
+#define ICM20608_REG_FIFO_R_W       0x74
+
+// FIFO 模式：每个样本 ACCEL(6) + GYRO(6)，不含温度
+#define ICM20608_FIFO_SIZE          512
+#define ICM20608_FIFO_RECORD_LEN    12
+
+// 片选（GPIO1_IO20）
+#define ICM20608_ASYNC_CS_LOW()     (GPIO1->DR &= ~(1 << 20))
+#define ICM20608_ASYNC_CS_HIGH()    (GPIO1->DR |= (1 << 20))
+
+// DRDY 中断引脚（ICM20608 INT 接到的 GPIO，按实际接线修改）
+// 默认 GPIO1_IO01，属于 GPIO1_Combined_0_15 中断
+#ifndef ICM20608_DRDY_GPIO
+#define ICM20608_DRDY_GPIO          GPIO1
+#define ICM20608_DRDY_PIN           1
+#define ICM20608_DRDY_PINMUX        IOMUXC_GPIO1_IO01_GPIO1_IO01
+#define ICM20608_DRDY_IRQn          GPIO1_Combined_0_15_IRQn
+#endif
+
+// 临界区：主循环里对 GPIO1->DR 的读-改-写要包在里面，避免覆盖中断里的 CS 状态
+// 保存并恢复 CPSR.I（同 TIMEBASE_LOCK），在已关中断的上下文里调用也不会提前打开中断
+#define ICM20608_ASYNC_GPIO_LOCK(cpsr)      __asm volatile ("mrs %0, cpsr\n\tcpsid i" : "=r" (cpsr) :: "memory")
+#define ICM20608_ASYNC_GPIO_UNLOCK(cpsr)    __asm volatile ("msr cpsr_c, %0" :: "r" (cpsr) : "memory")
+
+// 时间源（统计中断耗时），默认 GPT1 自由计数器
+#ifndef ICM20608_ASYNC_NOW
+#define ICM20608_ASYNC_NOW()        (GPT1->CNT)
+#endif
+
+// ==================== Data Structures ====================
+
+// 传输完成回调（在 ECSPI3 中断上下文中执行）
+// data: 读到的数据（驱动内部缓冲区，回调返回后失效）
+typedef void (*icm20608_async_cb_t)(const uint8_t *data, uint32_t len, void *param);
+
+// FIFO 读取完成回调（ECSPI3 中断上下文）
+// records: count 个 12 字节样本（最旧的在前），count 可能为 0
+typedef void (*icm20608_fifo_cb_t)(const uint8_t *records, uint32_t count, void *param);
+
+// DRDY 回调（GPIO 中断上下文）
+// edge_time: 中断入口锁存的 ICM20608_ASYNC_NOW()，作为样本时间戳
+typedef void (*icm20608_drdy_cb_t)(uint32_t edge_time, void *param);
+
+// 统计信息
+typedef struct {
+    uint32_t transfers;         // 完成的读取次数
+    uint32_t chunks;            // 传输块数（每块最多 64 字节）
+    uint32_t busy_rejects;      // 上一次读取未完成时的启动请求
+    uint32_t rx_overruns;       // RX FIFO 溢出次数
+    uint32_t max_irq_ticks;     // ECSPI 中断最长耗时
+    uint32_t fifo_drains;       // FIFO 读取次数
+    uint32_t fifo_records;      // FIFO 读出的样本总数
+    uint32_t fifo_max_records;  // 单次读出的最大样本数
+    uint32_t fifo_overflows;    // FIFO 满（样本丢失）的次数
+    uint32_t drdy_edges;        // DRDY 中断次数
+    uint32_t drdy_max_latency;  // DRDY 回调返回时距离边沿的最大 tick 数
+} icm20608_async_stats_t;
+
+// ==================== Function Prototypes ====================
+
+/**
+ * @brief 初始化异步读取模块
+ *
+ * 注册 ECSPI3 中断处理函数并使能 GIC 中断
+ * 必须在 icm20608_init() 之后调用
+ */
+void icm20608_async_init(void);
+
+/**
+ * @brief 启动异步连续读取
+ *
+ * @param reg   起始寄存器地址
+ * @param len   读取字节数（1 ~ ICM20608_ASYNC_MAX_LEN）
+ * @param cb    完成回调（中断上下文）
+ * @param param 传给回调的参数
+ * @return int 0=成功启动，-1=忙（上次读取未完成），-2=参数错误
+ *
+ * 可以在中断中调用，立即返回
+ */
+int icm20608_async_read(uint8_t reg, uint32_t len, icm20608_async_cb_t cb, void *param);
+
+/**
+ * @brief 检查是否有读取正在进行
+ */
+int icm20608_async_is_busy(void);
+
+/**
+ * @brief 解析 ACCEL_XOUT_H 开始的 14 字节（大端）为 6 轴原始值
+ */
+void icm20608_async_decode(const uint8_t *data,
+                           int16_t *ax, int16_t *ay, int16_t *az,
+                           int16_t *gx, int16_t *gy, int16_t *gz);
+
+/**
+ * @brief 配置 ICM20608 硬件 FIFO
+ *
+ * @param odr_hz 输出数据率（4 ~ 1000 Hz，1kHz / (1 + SMPLRT_DIV)）
+ *
+ * 使用阻塞 SPI 写寄存器，必须在启动定时器之前调用
+ * FIFO 满后不覆盖旧数据（CONFIG.FIFO_MODE=1），样本边界不会错位
+ */
+void icm20608_fifo_config(uint32_t odr_hz);
+
+/**
+ * @brief 异步读空 FIFO
+ *
+ * 先读 FIFO_COUNT，再一次突发读出所有完整样本（最多 ICM20608_ASYNC_MAX_LEN 字节）
+ * @return int 0=成功启动，-1=忙
+ */
+int icm20608_fifo_drain(icm20608_fifo_cb_t cb, void *param);
+
+/**
+ * @brief 解析一个 12 字节 FIFO 样本
+ */
+void icm20608_fifo_decode(const uint8_t *record,
+                          int16_t *ax, int16_t *ay, int16_t *az,
+                          int16_t *gx, int16_t *gy, int16_t *gz);
+
+/**
+ * @brief 配置 DRDY 中断采样
+ *
+ * @param odr_hz 输出数据率（4 ~ 1000 Hz，写 SMPLRT_DIV，DLPF 保持 icm20608_init() 的设置）
+ * @param cb     每次数据就绪时调用（GPIO 中断上下文），通常在这里启动 icm20608_async_read()
+ * @param param  传给回调的参数
+ *
+ * INT 引脚配置为高电平有效、推挽、50μs 脉冲（无需读 INT_STATUS 清除），GPIO 上升沿触发
+ * 使用阻塞 SPI 写寄存器，必须在启动异步读取之前调用；中断在 icm20608_drdy_enable() 后才打开
+ */
+void icm20608_drdy_init(uint32_t odr_hz, icm20608_drdy_cb_t cb, void *param);
+
+/**
+ * @brief 打开 / 关闭 DRDY GPIO 中断
+ */
+void icm20608_drdy_enable(void);
+void icm20608_drdy_disable(void);
+
+/**
+ * @brief 获取统计信息
+ */
+icm20608_async_stats_t* icm20608_async_get_stats(void);
+
+/**
+ * @brief ECSPI3 中断处理函数
+ *
+ * 内部函数，由中断系统调用
+ */
+void ecspi3_irq_handler(void);
+
+/**
+ * @brief DRDY GPIO 中断处理函数
+ *
+ * 内部函数，由中断系统调用
+ */
+void icm20608_drdy_irq_handler(void);
+
+#endif // _BSP_ICM20608_ASYNC_H
@@ -0,0 +1,360 @@
+#include "bsp_timebase.h"
+#include "../../stdio/include/stdio.h"
+
+// ==================== Private Variables ====================
+
+static GPT_Type *timebase_gpt = NULL;
+static volatile uint32_t timebase_hi = 0;      // 回绕次数
+
+// 频率和换算系数（Q32：真值 x 2^32），初值按标称频率（编译期算好）
+#define TIMEBASE_Q32(num, den)  ((((uint64_t)(num) << 32) + (den) / 2) / (den))
+static uint32_t timebase_hz = TIMEBASE_NOMINAL_HZ;
+static uint8_t timebase_calibrated_flag = 0;
+static uint8_t timebase_cal_err = TIMEBASE_CAL_OK;
+static uint64_t timebase_ns_per_tick = TIMEBASE_Q32(1000000000u, TIMEBASE_NOMINAL_HZ);
+static uint64_t timebase_us_per_tick = TIMEBASE_Q32(1000000u, TIMEBASE_NOMINAL_HZ);
+static uint64_t timebase_ticks_per_us = TIMEBASE_Q32(TIMEBASE_NOMINAL_HZ, 1000000u);
+static uint64_t timebase_ticks_per_ms = TIMEBASE_Q32(TIMEBASE_NOMINAL_HZ, 1000u);
+
+// ==================== Private Functions ====================
+
+// (num << 32) / den 四舍五入，移位减法：运行时不调用库里的 64 位除法（只在标定时用几次）
+static uint64_t q32_div(uint32_t num, uint32_t den)
+{
+    uint64_t n = (uint64_t)num << 32;
+    uint64_t q = 0, r = 0;
+    int i;
+
+    for (i = 63; i >= 0; i--) {
+        r = (r << 1) | ((n >> i) & 1);
+        if (r >= den) {
+            r -= den;
+            q |= (uint64_t)1 << i;
+        }
+    }
+    if (r >= den - r) {
+        q++;
+    }
+    return q;
+}
+
+// x * q >> 32（q 是 Q32 系数），四舍五入；32x32 拆开乘，不溢出
+static uint64_t q32_mul(uint32_t x, uint64_t q)
+{
+    return (uint64_t)x * (uint32_t)(q >> 32) +
+           (((uint64_t)x * (uint32_t)q + 0x80000000u) >> 32);
+}
+
+// SRTC 计数（LPSRTCLR：低 15 位是秒以下的 32768 分之一秒）
+// 跨时钟域读：连续两次相同才算数
+static uint32_t rtc_read(void)
+{
+    uint32_t a, b;
+
+    b = SNVS->LPSRTCLR;
+    do {
+        a = b;
+        b = SNVS->LPSRTCLR;
+    } while (a != b);
+    return a;
+}
+
+// 等 RTC 从 from 跳到下一个值，跳变后立刻读 CNT（关中断，两次读之间不被打断）
+// timeout：最多等这么多 GPT tick，返回 TIMEBASE_CAL_ERR_RTC；
+// 另有 TIMEBASE_CAL_SPIN_MAX 次循环的上限（GPT 不走时 tick 超时永远不到），用完时 GPT 也没动返回 TIMEBASE_CAL_ERR_STALL
+static int rtc_wait_edge(GPT_Type *gpt, uint32_t from, uint32_t timeout,
+                         uint32_t *rtc, uint32_t *cnt)
+{
+    uint32_t cpsr, start = gpt->CNT;
+    uint32_t spins = TIMEBASE_CAL_SPIN_MAX;
+    uint32_t r;
+
+    TIMEBASE_LOCK(cpsr);
+    while ((r = rtc_read()) == from) {
+        if (gpt->CNT - start > timeout) {
+            TIMEBASE_UNLOCK(cpsr);
+            return TIMEBASE_CAL_ERR_RTC;
+        }
+        if (--spins == 0) {
+            TIMEBASE_UNLOCK(cpsr);
+            return (gpt->CNT != start) ? TIMEBASE_CAL_ERR_RTC : TIMEBASE_CAL_ERR_STALL;
+        }
+    }
+    *cnt = gpt->CNT;
+    TIMEBASE_UNLOCK(cpsr);
+    *rtc = r;
+    return 0;
+}
+
+// ==================== Public Functions ====================
+
+void timebase_init(GPT_Type *gpt)
+{
+    uint32_t cpsr;
+
+    TIMEBASE_LOCK(cpsr);
+    timebase_gpt = gpt;
+    timebase_hi = 0;
+    gpt->SR = 1 << 5;           // ROV: Rollover Flag（写 1 清除）
+    gpt->IR |= 1 << 5;          // ROVIE: Rollover Interrupt Enable
+    TIMEBASE_UNLOCK(cpsr);
+
+    printf("[TIMEBASE] GPT counter extended to 64 bits (rollover IRQ on), CNT=%u\r\n", gpt->CNT);
+}
+
+void timebase_irq_handler(void)
+{
+    uint32_t cpsr;
+
+    if (timebase_gpt == NULL || !(timebase_gpt->SR & (1 << 5))) {
+        return;
+    }
+    // 加高位和清 ROV 不能被嵌套中断里的 timebase_now64() 拆开看到
+    TIMEBASE_LOCK(cpsr);
+    timebase_hi++;
+    timebase_gpt->SR = 1 << 5;
+    TIMEBASE_UNLOCK(cpsr);
+}
+
+uint64_t timebase_now64(void)
+{
+    uint32_t cpsr, hi, lo;
+
+    if (timebase_gpt == NULL) {
+        return 0;
+    }
+    TIMEBASE_LOCK(cpsr);
+    hi = timebase_hi;
+    lo = timebase_gpt->CNT;
+    // 已经回绕但溢出中断还没处理：读 CNT 之前回绕的（CNT 很小）要补上这一圈
+    if ((timebase_gpt->SR & (1 << 5)) && lo < 0x80000000u) {
+        hi++;
+    }
+    TIMEBASE_UNLOCK(cpsr);
+
+    return ((uint64_t)hi << 32) | lo;
+}
+
+uint32_t timebase_wraps(void)
+{
+    return (uint32_t)(timebase_now64() >> 32);
+}
+
+// ==================== Periodic Compare ====================
+
+uint32_t timebase_next_deadline(GPT_Type *gpt, uint32_t deadline, uint32_t period, uint32_t *periods)
+{
+    uint32_t next = deadline + period;
+    uint32_t n = 1;
+
+    // 下一个截止时刻已经过了（或来不及写进 OCR）：往后推整周期，保持相位
+    while ((int32_t)(next - gpt->CNT) < TIMEBASE_OCR_MARGIN) {
+        next += period;
+        n++;
+    }
+    *periods = n;
+    return next;
+}
+
+void timebase_interval_record(timebase_interval_t *s, uint32_t latency, uint32_t periods)
+{
+    int32_t err;
+
+    if (latency > s->latency_max) {
+        s->latency_max = latency;
+    }
+    s->count++;
+    if (periods > 1) {
+        // 错过截止时刻的这次只计入 missed：间隔误差只比较按时触发的相邻两次，
+        // 下一次仍和上一次按时触发的延迟比较
+        s->missed += periods - 1;
+        return;
+    }
+    // 第一次没有上一次可比，只记延迟
+    if (s->count > 1) {
+        err = (int32_t)(latency - s->last_latency);
+        if (err < s->err_min) {
+            s->err_min = err;
+        }
+        if (err > s->err_max) {
+            s->err_max = err;
+        }
+        s->err_sum += err;
+        s->err_abs_sum += (err < 0) ? (uint32_t)-err : (uint32_t)err;
+        s->err_count++;
+    }
+    s->last_latency = latency;
+}
+
+void timebase_interval_reset(timebase_interval_t *s)
+{
+    s->count = 0;
+    s->missed = 0;
+    s->latency_max = 0;
+    s->err_min = 0x7FFFFFFF;
+    s->err_max = -0x7FFFFFFF - 1;
+    s->err_sum = 0;
+    s->err_abs_sum = 0;
+    s->err_count = 0;
+}
+
+void timebase_periodic_init(timebase_periodic_t *p, GPT_Type *gpt, uint32_t channel, uint32_t period)
+{
+    p->gpt = gpt;
+    p->channel = channel;
+    p->period = period;
+    p->deadline = period;
+    gpt->OCR[channel] = period;
+    p->stats.last_latency = 0;
+    timebase_interval_reset(&p->stats);
+}
+
+uint32_t timebase_periodic_advance(timebase_periodic_t *p, uint32_t entry)
+{
+    uint32_t latency = entry - p->deadline;
+    uint32_t periods;
+
+    p->deadline = timebase_next_deadline(p->gpt, p->deadline, p->period, &periods);
+    p->gpt->OCR[p->channel] = p->deadline;
+
+    // 统计放在写 OCR 之后
+    timebase_interval_record(&p->stats, latency, periods);
+    return periods;
+}
+
+// ==================== Calibration ====================
+
+// 窗口两端都对齐到 RTC 跳变：先等一次跳变作起点，再数 TIMEBASE_CAL_RTC_COUNTS 个计数到终点
+// 中间不关中断，同样有 GPT tick 和循环次数两道上限（RTC / GPT 中途停了也能退出）
+// 返回 TIMEBASE_CAL_OK 或 TIMEBASE_CAL_ERR_*
+static int calibrate_measure(GPT_Type *gpt, uint32_t *gpt_counts, uint32_t *rtc_counts)
+{
+    uint32_t timeout = 0x100000;   // 等一次 RTC 跳变最多这么多 GPT tick（标称频率下 1.6 秒）
+    uint32_t spins = TIMEBASE_CAL_SPIN_MAX * 64;
+    uint32_t r0, r1, t0, t1, r, last, t_last;
+    int ret;
+
+    ret = rtc_wait_edge(gpt, rtc_read(), timeout, &r0, &t0);
+    if (ret != TIMEBASE_CAL_OK) {
+        return ret;
+    }
+    // RTC 超过 timeout 个 GPT tick 没变就是中途停了（不按整个窗口算，GPT 频率再高也不误判）
+    last = r0;
+    t_last = t0;
+    while ((r = rtc_read()) - r0 < TIMEBASE_CAL_RTC_COUNTS - 1) {
+        if (r != last) {
+            last = r;
+            t_last = gpt->CNT;
+        } else if (gpt->CNT - t_last > timeout) {
+            return TIMEBASE_CAL_ERR_RTC;
+        }
+        if (--spins == 0) {
+            return (gpt->CNT != t0) ? TIMEBASE_CAL_ERR_RTC : TIMEBASE_CAL_ERR_STALL;
+        }
+    }
+    ret = rtc_wait_edge(gpt, rtc_read(), timeout, &r1, &t1);
+    if (ret != TIMEBASE_CAL_OK) {
+        return ret;
+    }
+    *rtc_counts = r1 - r0;
+    *gpt_counts = t1 - t0;
+    return TIMEBASE_CAL_OK;
+}
+
+int timebase_calibrate(GPT_Type *gpt)
+{
+    uint32_t cr = gpt->CR;
+    uint32_t rtc_counts, gpt_counts, hz;
+    int ret;
+
+    gpt->CR = cr | (1 << 0);        // EN（已经在计数的不受影响）
+    SNVS->LPCR |= 1 << 0;           // SRTC_ENV：RTC 没开的话打开，已经在走的不受影响
+    ret = calibrate_measure(gpt, &gpt_counts, &rtc_counts);
+    gpt->CR = cr;
+
+    timebase_cal_err = (uint8_t)ret;
+    if (ret == TIMEBASE_CAL_ERR_RTC) {
+        printf("[TIMEBASE] Calibration failed: RTC not running, using %u Hz\r\n", timebase_hz);
+        return -1;
+    }
+    if (ret == TIMEBASE_CAL_ERR_STALL) {
+        printf("[TIMEBASE] Calibration failed: GPT not counting, using %u Hz\r\n", timebase_hz);
+        return -1;
+    }
+
+    // hz = gpt_counts * (32768 / rtc_counts)，后一项是 Q32 系数
+    hz = (uint32_t)q32_mul(gpt_counts, q32_div(TIMEBASE_CAL_RTC_HZ, rtc_counts));
+    if (hz < TIMEBASE_CAL_RTC_HZ || hz > 100000000u) {
+        timebase_cal_err = TIMEBASE_CAL_ERR_RANGE;
+        printf("[TIMEBASE] Calibration failed: %u GPT ticks in %u RTC counts, using %u Hz\r\n",
+               gpt_counts, rtc_counts, timebase_hz);
+        return -1;
+    }
+
+    timebase_hz = hz;
+    timebase_calibrated_flag = 1;
+    timebase_ns_per_tick = q32_div(1000000000u, hz);
+    timebase_us_per_tick = q32_div(1000000u, hz);
+    timebase_ticks_per_us = q32_div(hz, 1000000u);
+    timebase_ticks_per_ms = q32_div(hz, 1000u);
+
+    printf("[TIMEBASE] GPT calibrated against 32.768kHz RTC: %u Hz (%u ticks / %u RTC counts, nominal %u)\r\n",
+           hz, gpt_counts, rtc_counts, TIMEBASE_NOMINAL_HZ);
+    return 0;
+}
+
+uint32_t timebase_rate_hz(void)
+{
+    return timebase_hz;
+}
+
+int timebase_calibrated(void)
+{
+    return timebase_calibrated_flag;
+}
+
+int timebase_cal_error(void)
+{
+    return timebase_cal_err;
+}
+
+uint64_t timebase_ticks_to_ns(uint32_t ticks)
+{
+    return q32_mul(ticks, timebase_ns_per_tick);
+}
+
+uint32_t timebase_ticks_to_us(uint32_t ticks)
+{
+    return (uint32_t)q32_mul(ticks, timebase_us_per_tick);
+}
+
+uint32_t timebase_us_to_ticks(uint32_t us)
+{
+    return (uint32_t)q32_mul(us, timebase_ticks_per_us);
+}
+
+uint32_t timebase_ms_to_ticks(uint32_t ms)
+{
+    return (uint32_t)q32_mul(ms, timebase_ticks_per_ms);
+}
+
+// ==================== CPU Cycle Counter ====================
+
+uint32_t timebase_cycles(void)
+{
+    static int enabled = 0;
+    uint32_t value;
+
+    if (!enabled) {
+        uint32_t pmcr;
+        __asm volatile ("mrc p15, 0, %0, c9, c12, 0" : "=r"(pmcr));
+        pmcr |= 1 << 0;                     // E: 使能（不复位，已经在跑的计时照样能用）
+        pmcr &= ~(1u << 3);                 // D=0: 每个周期加 1（不分频 64）
+        __asm volatile ("mcr p15, 0, %0, c9, c12, 0" :: "r"(pmcr));
+        __asm volatile ("mcr p15, 0, %0, c9, c12, 1" :: "r"(1u << 31));  // PMCNTENSET.C
+        enabled = 1;
+    }
+
+    __asm volatile ("mrc p15, 0, %0, c9, c13, 0" : "=r"(value));  // PMCCNTR
+    return value;
+}
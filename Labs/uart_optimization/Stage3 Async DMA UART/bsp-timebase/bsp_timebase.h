@@ -0,0 +1,211 @@
+#ifndef _BSP_TIMEBASE_H
+#define _BSP_TIMEBASE_H
+
+#include "../../imx6ul/MCIMX6Y2.h"
+#include "../../stdio/include/types.h"
+// ==================== 64 位时间基准 ====================
+// GPT 的 CNT 只有 32 位，约 645kHz 下 1.85 小时回绕一次：包里的时间戳、运行时间统计跨过回绕就乱了
+// 这里打开 GPT 的溢出中断（IR.ROVIE，bit 5），每次回绕把软件高 32 位加 1，和 CNT 拼成 64 位计数
+// 645kHz 下 64 位计数几十万年不回绕
+//
+// 用法：
+// - GPT 配置好（写完 IR）之后调用 timebase_init(GPTx)，溢出中断和比较中断共用 GPTx_IRQn
+// - 该 GPT 的中断处理函数开头调用 timebase_irq_handler()；比较中断的处理要检查 SR & IR，
+//   溢出中断进来时不能当成一次比较中断
+// - timebase_now64() 任何上下文都能调用：中断里、关中断时、嵌套中断里
+//
+// 一致性：溢出中断里"高位加 1 + 清 ROV"和 timebase_now64() 的"读高位 + CNT + ROV"都在关中断下完成，
+// 读的一方看到 ROV 已置位（中断还没处理，例如调用者自己就在关中断或更高优先级的中断里）时：
+// CNT 在下半圈说明回绕发生在读 CNT 之前，高位按已加 1 算；CNT 在上半圈说明读 CNT 之后才回绕，不加
+// 32 位的 GPT 值（get_system_tick() 等）就是 64 位计数的低 32 位，求差照旧
+//
+// 周期比较（timebase_periodic_*）：OCR 按绝对截止时刻累加（OCR += period），
+// 不再是 OCR = CNT + period：中断延迟只影响这一次，不会累积成相位漂移
+// 进中断时已经错过了下一个截止时刻（中断被关太久 / 处理比周期还长）时，
+// 把 OCR 往后推到第一个还没到的截止时刻（否则比较要等 CNT 绕一圈），返回经过的周期数，
+// 由调用者决定怎么补：采样跳过错过的点（序号照样递增），RTOS 节拍按周期数补 tick
+//
+// 频率标定（timebase_calibrate）：GPT 用 IPG 时钟 66 分频，标称 1MHz，但实测约 645kHz，
+// 各处写死的 645000 / 645 也只是估计值。启动时拿 SNVS 的 32.768kHz 安全 RTC（LP SRTC，
+// 晶振精度几十 ppm）当尺子：数 TIMEBASE_CAL_RTC_COUNTS 个 RTC 计数（250ms）里 GPT 走了多少，
+// 两端都在 RTC 跳变后立刻读 CNT，误差约 ±1 个 GPT tick（645kHz 下约 6ppm）
+// 之后周期、超时都用 timebase_ms_to_ticks() 等按实测频率换算；没标定（或 RTC 没走）时按标称值
+// 换算系数是 Q32 定点数（乘法 + 移位，没有运行时除法）
+
+// 写 OCR 时截止时刻至少还要这么多 tick 才到，否则当作已经错过（写进去之前 CNT 可能就跑过去了）
+#define TIMEBASE_OCR_MARGIN     2
+
+// 标定前 / 标定失败时用的频率
+#define TIMEBASE_NOMINAL_HZ     645000
+
+// 标定窗口：RTC 计数数（32768 = 1 秒）
+#define TIMEBASE_CAL_RTC_HZ     32768
+#define TIMEBASE_CAL_RTC_COUNTS 8192
+
+// 标定里每段自旋等待的最多循环次数（GPT 本身也不走时靠它退出，每次循环至少读两次 RTC）
+// 等一次跳变最多 TIMEBASE_CAL_SPIN_MAX 次（关着中断），等整个窗口最多 x 64
+#define TIMEBASE_CAL_SPIN_MAX   0x100000
+
+// 标定失败原因（timebase_cal_error()），失败时频率保持标称值
+#define TIMEBASE_CAL_OK             0
+#define TIMEBASE_CAL_ERR_RTC        1   // RTC 没有走（等跳变超时）
+#define TIMEBASE_CAL_ERR_STALL      2   // 自旋次数用完：GPT 也没有走
+#define TIMEBASE_CAL_ERR_RANGE      3   // 测出的频率不合理
+
+// 临界区：保存并恢复 CPSR.I，中断里调用不会提前打开中断
+#define TIMEBASE_LOCK(cpsr)     __asm volatile ("mrs %0, cpsr\n\tcpsid i" : "=r" (cpsr) :: "memory")
+#define TIMEBASE_UNLOCK(cpsr)   __asm volatile ("msr cpsr_c, %0" :: "r" (cpsr) : "memory")
+
+// ==================== Data Structures ====================
+
+// 周期触发的时序统计：每次触发距截止时刻的延迟、相邻两次的间隔误差、错过的截止时刻
+typedef struct {
+    uint32_t last_latency;      // 上一次按时进入中断时距截止时刻的 tick 数
+    uint32_t count;             // 触发次数
+    uint32_t missed;            // 错过的截止时刻（跳过 / 补 tick 的周期数）
+    uint32_t latency_max;       // 进入中断距截止时刻的最大 tick 数
+    int32_t err_min;            // 间隔误差：相邻两次按时进入中断的间隔 - 标称间隔（tick），= 两次延迟之差
+    int32_t err_max;
+    int32_t err_sum;            // 均值 = err_sum / err_count，绝对截止时刻下各次误差相互抵消，趋于 0
+    uint32_t err_abs_sum;       // 平均绝对误差 = err_abs_sum / err_count（抖动）
+    uint32_t err_count;         // 参与间隔误差统计的次数（错过截止时刻的那次不算）
+} timebase_interval_t;
+
+// 一个按绝对截止时刻触发的周期比较通道
+typedef struct {
+    GPT_Type *gpt;
+    uint32_t channel;           // OCR 通道（0 ~ 2，对应 SR / IR 的 bit 0 ~ 2）
+    uint32_t period;            // 周期（tick）
+    uint32_t deadline;          // 当前写在 OCR 里的截止时刻
+    timebase_interval_t stats;  // timebase_interval_reset() 清零
+} timebase_periodic_t;
+
+// ==================== Function Prototypes ====================
+
+/**
+ * @brief 把 GPT 计数扩展成 64 位
+ *
+ * @param gpt 已配置为自由运行（CR.FRR=1）的 GPT
+ *
+ * 打开溢出中断，高 32 位清零；GPT 的中断处理函数由调用者注册，并在里面调用 timebase_irq_handler()
+ * 必须在写完 gpt->IR 之后调用（IR 整体赋值会关掉溢出中断）
+ */
+void timebase_init(GPT_Type *gpt);
+
+/**
+ * @brief 溢出中断处理
+ *
+ * 在 timebase_init() 那个 GPT 的中断处理函数里调用，ROV 置位时高 32 位加 1 并清除 ROV
+ */
+void timebase_irq_handler(void);
+
+/**
+ * @brief 读 64 位计数
+ *
+ * @return uint64_t 高 32 位是回绕次数，低 32 位是 CNT；timebase_init() 之前返回 0
+ */
+uint64_t timebase_now64(void);
+
+/**
+ * @brief 计数已经回绕的次数（64 位计数的高 32 位）
+ */
+uint32_t timebase_wraps(void);
+
+/**
+ * @brief 初始化周期比较通道
+ *
+ * @param p       通道状态
+ * @param gpt     GPT（还没有使能：CR.ENMOD=1 时使能后从 0 计数）
+ * @param channel OCR 通道（0 ~ 2）
+ * @param period  周期（tick）
+ *
+ * 第一个截止时刻是 period，写进 OCR[channel]；比较中断使能（IR）由调用者设置
+ */
+void timebase_periodic_init(timebase_periodic_t *p, GPT_Type *gpt, uint32_t channel, uint32_t period);
+
+/**
+ * @brief 比较中断里调用：记录统计，OCR 推进到下一个截止时刻
+ *
+ * @param p     通道状态
+ * @param entry 中断入口读到的 CNT
+ * @return uint32_t 这次截止时刻到新截止时刻之间的周期数：1=正常，n>1 表示错过了 n-1 个
+ *
+ * 调用者先清 SR 的比较标志
+ */
+uint32_t timebase_periodic_advance(timebase_periodic_t *p, uint32_t entry);
+
+/**
+ * @brief deadline 之后第一个来得及写进 OCR 的截止时刻
+ *
+ * @param gpt      计数的 GPT
+ * @param deadline 刚到的截止时刻
+ * @param period   周期（tick）
+ * @param periods  返回 deadline 到新截止时刻的周期数（1=没有错过）
+ * @return uint32_t deadline + periods * period，离 CNT 至少 TIMEBASE_OCR_MARGIN
+ */
+uint32_t timebase_next_deadline(GPT_Type *gpt, uint32_t deadline, uint32_t period, uint32_t *periods);
+
+/**
+ * @brief 记一次周期触发
+ *
+ * @param s       统计
+ * @param latency 进入中断（或开始处理）距截止时刻的 tick 数
+ * @param periods timebase_next_deadline() 返回的周期数
+ */
+void timebase_interval_record(timebase_interval_t *s, uint32_t latency, uint32_t periods);
+
+/**
+ * @brief 清零统计（保留上一次的延迟，下一次照样能算间隔误差）
+ */
+void timebase_interval_reset(timebase_interval_t *s);
+
+/**
+ * @brief 用 32.768kHz RTC 测 GPT 的实际频率（启动时调用一次，约 250ms）
+ *
+ * @param gpt 已设置好分频（PR）和时钟源（CR.CLKSRC）的 GPT，没有使能时临时使能，结束后恢复 CR
+ * @return int 0=成功，-1=RTC 没有走 / GPT 没有走 / 测出的频率不合理（保持原来的频率，原因见 timebase_cal_error()）
+ *
+ * RTC 没有打开时打开（不改 RTC 的时间）；在写 OCR / IR 之前调用，周期要在标定之后再按新频率算
+ */
+int timebase_calibrate(GPT_Type *gpt);
+
+/**
+ * @brief GPT 频率（Hz）：标定值，没标定时是 TIMEBASE_NOMINAL_HZ
+ */
+uint32_t timebase_rate_hz(void);
+
+/**
+ * @brief 1=频率是 timebase_calibrate() 测出来的，0=标称值
+ */
+int timebase_calibrated(void);
+
+/**
+ * @brief 上一次 timebase_calibrate() 失败的原因（TIMEBASE_CAL_ERR_*），成功或没标定过为 TIMEBASE_CAL_OK
+ */
+int timebase_cal_error(void);
+
+/**
+ * @brief tick 数 → 纳秒（Q32 定点乘法，误差小于 1ns）
+ */
+uint64_t timebase_ticks_to_ns(uint32_t ticks);
+
+/**
+ * @brief tick 数 → 微秒（误差小于 1us，结果超过 32 位时截断：差值要在 71 分钟以内）
+ */
+uint32_t timebase_ticks_to_us(uint32_t ticks);
+
+/**
+ * @brief 微秒 / 毫秒 → tick 数（误差小于 1 tick，结果要在 32 位以内）
+ */
+uint32_t timebase_us_to_ticks(uint32_t us);
+uint32_t timebase_ms_to_ticks(uint32_t ms);
+
+/**
+ * @brief 读 CPU 周期计数器 PMCCNTR（首次调用时使能）
+ *
+ * GPT 一个 tick 约 1.5us，几百个周期的开销要用它量：CRC 微基准、定时器服务的分发开销
+ * 在中断里第一次调用也可以（使能只是读-改-写 PMCR，重复执行无害）
+ */
+uint32_t timebase_cycles(void);
+
+#endif // _BSP_TIMEBASE_H
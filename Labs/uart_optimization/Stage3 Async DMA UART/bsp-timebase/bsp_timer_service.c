@@ -0,0 +1,280 @@
+#include "bsp_timer_service.h"
+#include "../../stdio/include/stdio.h"
+#include "../../stdio/include/string.h"
+
+// a 比 b 早（32 位差值，截止时刻相差不到半圈）
+#define DEADLINE_BEFORE(a, b)   ((int32_t)((a) - (b)) < 0)
+
+// ==================== Private Variables ====================
+
+static GPT_Type *svc_gpt = NULL;
+static uint32_t svc_channels;                           // 交给服务的通道掩码
+static uint32_t svc_list_channel;                       // 链表通道
+static timer_job_t *svc_list;                           // 按截止时刻排序，表头装在链表通道的 OCR 里
+static timer_job_t *svc_slot[TIMER_SERVICE_CHANNELS];   // 独占通道上的任务
+static uint32_t svc_callback_cycles;                    // 本次中断里回调用掉的周期（从分发开销里扣掉）
+
+static timer_service_stats_t svc_stats;
+
+// ==================== Private Functions ====================
+
+static void list_insert(timer_job_t *job)
+{
+    timer_job_t **pp = &svc_list;
+
+    // 截止时刻相同的排在已有任务后面：先启动的先执行
+    while (*pp != NULL && !DEADLINE_BEFORE(job->deadline, (*pp)->deadline)) {
+        pp = &(*pp)->next;
+    }
+    job->next = *pp;
+    *pp = job;
+
+    svc_stats.list_len++;
+    if (svc_stats.list_len > svc_stats.list_len_max) {
+        svc_stats.list_len_max = svc_stats.list_len;
+    }
+}
+
+static void list_remove(timer_job_t *job)
+{
+    timer_job_t **pp = &svc_list;
+
+    while (*pp != NULL && *pp != job) {
+        pp = &(*pp)->next;
+    }
+    if (*pp != NULL) {
+        *pp = job->next;
+        job->next = NULL;
+        svc_stats.list_len--;
+    }
+}
+
+// 表头的截止时刻写进链表通道的 OCR；表空时关掉该通道的比较中断
+// 返回 0：表头的截止时刻离 CNT 不到 TIMEBASE_OCR_MARGIN，写进去可能已经错过，调用者接着分发
+static int list_arm(void)
+{
+    uint32_t bit = 1u << svc_list_channel;
+
+    if (svc_list == NULL) {
+        svc_gpt->IR &= ~bit;
+        return 1;
+    }
+    svc_gpt->OCR[svc_list_channel] = svc_list->deadline;
+    svc_gpt->IR |= bit;
+    return (int32_t)(svc_list->deadline - svc_gpt->CNT) >= TIMEBASE_OCR_MARGIN;
+}
+
+// 释放独占通道
+static void slot_release(timer_job_t *job)
+{
+    svc_gpt->IR &= ~(1u << job->channel);
+    svc_slot[job->channel] = NULL;
+    job->channel = -1;
+    svc_stats.dedicated--;
+}
+
+// 执行一个到期的任务：先排好下一次（回调里可以停止 / 重启自己），再调用回调
+static void job_run(timer_job_t *job, uint32_t now)
+{
+    uint32_t latency = now - job->deadline;
+    uint32_t periods = 1;
+    uint32_t start;
+
+    if (job->period == 0) {
+        job->active = 0;
+        if (job->channel >= 0) {
+            slot_release(job);
+        }
+    } else {
+        job->deadline = timebase_next_deadline(svc_gpt, job->deadline, job->period, &periods);
+        if (job->channel >= 0) {
+            svc_gpt->OCR[job->channel] = job->deadline;
+        } else {
+            list_insert(job);
+        }
+    }
+    timebase_interval_record(&job->stats, latency, periods);
+
+    start = TIMER_SERVICE_CYCLES();
+    job->fn(job->param, periods);
+    svc_callback_cycles += TIMER_SERVICE_CYCLES() - start;
+    svc_stats.jobs_run++;
+}
+
+// ==================== Public Functions ====================
+
+void timer_service_init(GPT_Type *gpt, uint32_t channels)
+{
+    uint32_t cpsr, ch;
+
+    channels &= (1u << TIMER_SERVICE_CHANNELS) - 1;
+    if (channels == 0) {
+        return;
+    }
+
+    TIMEBASE_LOCK(cpsr);
+    svc_gpt = gpt;
+    svc_channels = channels;
+    for (ch = 0; ch < TIMER_SERVICE_CHANNELS; ch++) {
+        if (channels & (1u << ch)) {
+            svc_list_channel = ch;      // 编号最大的通道
+        }
+        svc_slot[ch] = NULL;
+    }
+    svc_list = NULL;
+    memset(&svc_stats, 0, sizeof(svc_stats));
+    gpt->IR &= ~channels;               // 有任务时才打开
+    gpt->SR = channels;
+    TIMEBASE_UNLOCK(cpsr);
+
+    timebase_cycles();                  // 使能 PMCCNTR（中断里开始计时之前）
+
+    printf("[TIMER] Timer service on GPT compare channels 0x%x, job list on OCR[%u]\r\n",
+           channels, svc_list_channel);
+}
+
+int timer_job_start(timer_job_t *job, uint32_t delay, uint32_t period, uint32_t flags,
+                    timer_job_fn_t fn, void *param)
+{
+    uint32_t cpsr, ch, bit;
+
+    if (svc_gpt == NULL || job == NULL || fn == NULL ||
+        delay >= 0x80000000u || period >= 0x80000000u) {
+        return -2;
+    }
+    if (delay < TIMEBASE_OCR_MARGIN) {
+        delay = TIMEBASE_OCR_MARGIN;
+    }
+
+    TIMEBASE_LOCK(cpsr);
+    if (job->active) {
+        TIMEBASE_UNLOCK(cpsr);
+        return -1;
+    }
+    job->fn = fn;
+    job->param = param;
+    job->period = period;
+    job->channel = -1;
+    job->next = NULL;
+    job->active = 1;
+    job->stats.last_latency = 0;
+    timebase_interval_reset(&job->stats);
+
+    // 独占通道：找一个空闲的（链表通道除外）
+    if (flags & TIMER_JOB_DEDICATED) {
+        for (ch = 0; ch < TIMER_SERVICE_CHANNELS; ch++) {
+            if (ch != svc_list_channel && (svc_channels & (1u << ch)) && svc_slot[ch] == NULL) {
+                job->channel = ch;
+                break;
+            }
+        }
+    }
+
+    job->deadline = svc_gpt->CNT + delay;
+    if (job->channel >= 0) {
+        bit = 1u << job->channel;
+        svc_slot[job->channel] = job;
+        svc_stats.dedicated++;
+        svc_gpt->OCR[job->channel] = job->deadline;
+        svc_gpt->SR = bit;              // 空闲时 OCR 也会比较匹配，清掉残留的标志
+        svc_gpt->IR |= bit;
+    } else {
+        if (svc_list == NULL) {
+            svc_gpt->SR = 1u << svc_list_channel;
+        }
+        list_insert(job);
+        if (svc_list == job) {
+            // 新表头比原来的早（至少还有 TIMEBASE_OCR_MARGIN），直接改 OCR
+            list_arm();
+        }
+    }
+    TIMEBASE_UNLOCK(cpsr);
+    return 0;
+}
+
+int timer_job_stop(timer_job_t *job)
+{
+    uint32_t cpsr;
+
+    if (job == NULL) {
+        return -2;
+    }
+    TIMEBASE_LOCK(cpsr);
+    if (!job->active) {
+        TIMEBASE_UNLOCK(cpsr);
+        return -1;
+    }
+    if (job->channel >= 0) {
+        slot_release(job);
+    } else {
+        // OCR 不改：原来的表头到时候触发一次空中断，在中断里重新装表头
+        list_remove(job);
+    }
+    job->active = 0;
+    TIMEBASE_UNLOCK(cpsr);
+    return 0;
+}
+
+uint32_t timer_service_irq_handler(void)
+{
+    uint32_t start = TIMER_SERVICE_CYCLES();
+    uint32_t cpsr, pending, ch, now, runs, cost;
+    timer_job_t *job;
+
+    if (svc_gpt == NULL) {
+        return 0;
+    }
+    // 整个分发都在关中断下：嵌套中断里的 timer_job_start() / stop() 不会改到一半的链表
+    // 回调也在关中断下执行，要短（给信号量、置标志）
+    TIMEBASE_LOCK(cpsr);
+    pending = svc_gpt->SR & svc_gpt->IR & svc_channels;
+    if (pending == 0) {
+        TIMEBASE_UNLOCK(cpsr);
+        return 0;
+    }
+    svc_gpt->SR = pending;
+    runs = svc_stats.jobs_run;
+    svc_callback_cycles = 0;
+    now = svc_gpt->CNT;
+
+    // 独占通道：到期的就是它自己
+    for (ch = 0; ch < TIMER_SERVICE_CHANNELS; ch++) {
+        if (ch != svc_list_channel && (pending & (1u << ch)) && svc_slot[ch] != NULL) {
+            job_run(svc_slot[ch], now);
+        }
+    }
+
+    // 链表通道：取出所有到期的任务，再把新表头装进 OCR
+    // 新表头近得来不及装时继续循环（最多等 TIMEBASE_OCR_MARGIN 个 tick）
+    if (pending & (1u << svc_list_channel)) {
+        do {
+            now = svc_gpt->CNT;
+            while (svc_list != NULL && (int32_t)(svc_list->deadline - now) <= 0) {
+                job = svc_list;
+                svc_list = job->next;
+                job->next = NULL;
+                svc_stats.list_len--;
+                job_run(job, now);
+                now = svc_gpt->CNT;
+            }
+        } while (!list_arm());
+    }
+
+    runs = svc_stats.jobs_run - runs;
+    cost = TIMER_SERVICE_CYCLES() - start - svc_callback_cycles;
+    svc_stats.irqs++;
+    svc_stats.dispatch_total += cost;
+    if (cost > svc_stats.dispatch_max) {
+        svc_stats.dispatch_max = cost;
+    }
+    if (runs > svc_stats.jobs_per_irq_max) {
+        svc_stats.jobs_per_irq_max = runs;
+    }
+    TIMEBASE_UNLOCK(cpsr);
+    return runs;
+}
+
+timer_service_stats_t *timer_service_get_stats(void)
+{
+    return &svc_stats;
+}
@@ -0,0 +1,106 @@
+#ifndef _BSP_TIMER_SERVICE_H
+#define _BSP_TIMER_SERVICE_H
+
+#include "bsp_timebase.h"
+// ==================== 定时器服务：一个 GPT 上的多路定时任务 ====================
+// GPT 有 3 个输出比较通道（OCR[0] ~ OCR[2]），以前每个周期源各占一个 GPT、只用 OCR[0]
+// 这里把任意多个周期 / 单次任务复用到同一个 GPT 的比较通道上：
+// - 交给服务的通道里编号最大的一个是"链表通道"：任务按截止时刻排成有序链表，OCR 只装表头，
+//   到期时在中断里依次取出到期的任务执行，周期任务按截止时刻累加后插回链表
+// - 其余通道是"独占通道"：带 TIMER_JOB_DEDICATED 启动的任务有空闲通道就独占一个，
+//   OCR 直接装它自己的截止时刻，不受链表里其他任务的影响（抖动最小）；没有空闲通道时进链表
+// - 截止时刻都是绝对值（deadline += period），错过的截止时刻跳过并计入 missed，回调收到经过的周期数
+//
+// 用法：
+// - GPT 配置好、timebase 之外其他比较通道不用时调用 timer_service_init(GPTx, 通道掩码)
+// - 该 GPT 的中断处理函数里调用 timer_service_irq_handler()（和 timebase_irq_handler() 并列）
+// - 回调在中断上下文、关中断下执行，要短；FreeRTOS 下只能用 FromISR 接口
+// - timer_job_t 由调用者分配（静态变量），停止之前不能释放
+//
+// 截止时刻按 32 位差值比较：延迟和周期都要小于 2^31 tick（645kHz 下约 55 分钟）
+
+// 服务最多管理的比较通道数
+#define TIMER_SERVICE_CHANNELS      3
+
+// timer_job_start() 的 flags
+#define TIMER_JOB_DEDICATED         (1 << 0)    // 尽量独占一个比较通道
+
+// 分发开销计时用的周期计数器：CPU 周期计数器 PMCCNTR（timer_service_init() 里使能）
+// GPT 一个 tick 约 1.5us，量不出几百个周期的分发开销
+#ifndef TIMER_SERVICE_CYCLES
+#define TIMER_SERVICE_CYCLES()      timebase_cycles()
+#endif
+
+// ==================== Data Structures ====================
+
+// 任务回调（中断上下文）：periods = 这次到下一次截止时刻之间的周期数，>1 表示错过了 periods-1 个
+typedef void (*timer_job_fn_t)(void *param, uint32_t periods);
+
+typedef struct timer_job {
+    struct timer_job *next;     // 链表里的下一个（截止时刻更晚）
+    timer_job_fn_t fn;
+    void *param;
+    uint32_t deadline;          // 下一个截止时刻（GPT tick）
+    uint32_t period;            // 周期（tick），0 = 单次任务
+    int32_t channel;            // 独占的比较通道，-1 = 在链表里
+    uint8_t active;
+    timebase_interval_t stats;  // 延迟 / 间隔误差 / 错过的截止时刻（start 时清零）
+} timer_job_t;
+
+typedef struct {
+    uint32_t irqs;              // 有比较事件的中断次数
+    uint32_t jobs_run;          // 执行的回调次数
+    uint32_t jobs_per_irq_max;  // 一次中断里执行的最多回调数
+    uint32_t dispatch_max;      // 一次中断的分发开销（CPU 周期，不含回调本身）
+    uint32_t dispatch_total;    // 分发开销累计（平均 = dispatch_total / irqs）
+    uint32_t list_len;          // 链表里的任务数
+    uint32_t list_len_max;
+    uint32_t dedicated;         // 占用独占通道的任务数
+} timer_service_stats_t;
+
+// ==================== Function Prototypes ====================
+
+/**
+ * @brief 初始化定时器服务
+ *
+ * @param gpt      自由运行（CR.FRR=1）的 GPT
+ * @param channels 交给服务的比较通道掩码（bit n = OCR[n]），编号最大的一个做链表通道
+ *
+ * 只改掩码里通道的 IR 位（有任务时才打开），不影响其他通道和溢出中断
+ */
+void timer_service_init(GPT_Type *gpt, uint32_t channels);
+
+/**
+ * @brief 启动任务
+ *
+ * @param job    任务（调用者分配，不能正在运行）
+ * @param delay  第一次触发距现在的 tick 数（至少 TIMEBASE_OCR_MARGIN）
+ * @param period 周期（tick），0 = 单次
+ * @param flags  TIMER_JOB_DEDICATED 等
+ * @param fn     回调（中断上下文）
+ * @param param  回调参数
+ * @return int 0=成功，-1=任务已在运行，-2=参数错误
+ *
+ * 任务上下文和回调里都可以调用
+ */
+int timer_job_start(timer_job_t *job, uint32_t delay, uint32_t period, uint32_t flags,
+                    timer_job_fn_t fn, void *param);
+
+/**
+ * @brief 停止任务（回调里可以停止自己）
+ *
+ * @return int 0=成功，-1=任务没有在运行
+ */
+int timer_job_stop(timer_job_t *job);
+
+/**
+ * @brief 比较中断处理
+ *
+ * 在 timer_service_init() 那个 GPT 的中断处理函数里调用，只处理服务的通道（SR & IR）
+ * @return uint32_t 执行的回调数
+ */
+uint32_t timer_service_irq_handler(void);
+
+timer_service_stats_t *timer_service_get_stats(void);
+
+#endif // _BSP_TIMER_SERVICE_H
@@ -6,132 +6,1013 @@
 
 // ==================== Private Variables ====================
 
-// TX 缓冲区（存放待发送的数据）
-static uint8_t uart_tx_buffer[UART_ASYNC_TX_BUFFER_SIZE];
+// 默认实例（UART1 控制台），状态全部在 uart_async_port_t 里
+uart_async_port_t g_uart_async_default;
 
-// 发送状态
-static uint32_t uart_tx_len;           // 本次要发送的字节数
-static uint32_t uart_tx_idx;           // 当前发送到第几个字节
-static volatile bool uart_tx_busy;     // 是否正在发送
+// 时间源频率：标定前按标称值，uart_async_set_clock_hz() 换成实测值
+static uint32_t uart_now_hz = UART_ASYNC_NOW_HZ;
 
-// 性能统计
-static uart_async_stats_t g_stats;
+// 初始化过的实例（uart_async_port_init() 登记，重复初始化不重复登记）
+static uart_async_port_t *uart_ports;
+
+// ==================== Private Functions ====================
+
+#define COBS_NO_TAG     (-1)
+
+// COBS 编码：[tag] + src[len] → dst，末尾加 0x00 分隔符，返回写入的字节数
+// 每个块以长度字节开头（块内非零字节数 + 1），块之间原来的 0x00 被省略
+// tag >= 0 时作为帧的第一个字节一起编码（逻辑通道标签），COBS_NO_TAG 不加
+// dst 至少要有 UART_ASYNC_COBS_LEN(len)（带标签时 len + 1）字节
+static uint32_t cobs_encode(uint8_t *dst, int tag, const uint8_t *src, uint32_t len)
+{
+    uint32_t code_idx = 0;      // 当前块长度字节的位置
+    uint32_t out = 1;
+    uint8_t code = 1;
+    uint32_t extra = (tag >= 0) ? 1 : 0;
+    uint32_t i;
+    
+    for (i = 0; i < len + extra; i++) {
+        uint8_t b = (i < extra) ? (uint8_t)tag : src[i - extra];
+        
+        if (b == 0) {
+            dst[code_idx] = code;
+            code_idx = out++;
+            code = 1;
+        } else {
+            dst[out++] = b;
+            code++;
+            if (code == 0xFF) {     // 块满 254 字节，强制分块
+                dst[code_idx] = code;
+                code_idx = out++;
+                code = 1;
+            }
+        }
+    }
+    dst[code_idx] = code;
+    dst[out++] = 0x00;              // 帧分隔符
+    return out;
+}
+
+// 一个字符（起始位 + 8 数据位 + 停止位）的时间，x256 保留小数（3M 波特率下约 2.15 tick）
+// 10 x hz x 256 在 hz 超过约 1.67MHz 时超出 32 位，用 64 位算；只在改波特率 / 时间源频率时算一次
+static uint32_t char_ticks_x256(uint32_t baud)
+{
+    return (uint32_t)(((uint64_t)10u * uart_now_hz * 256u) / baud);
+}
+
+// 取一个空闲描述符，队列满时返回 NULL
+static uart_async_tx_desc_t *tx_queue_slot(uart_async_port_t *port)
+{
+    if (port->tx_head - port->tx_tail >= UART_ASYNC_TX_QUEUE_DEPTH) {
+        port->stats.errors++;
+        return NULL;
+    }
+    return &port->tx_queue[port->tx_head & (UART_ASYNC_TX_QUEUE_DEPTH - 1)];
+}
+
+// count 个元素各自编码成一个 COBS 帧，首尾相连写进 desc->data，返回总字节数
+static uint32_t tx_desc_encode(uart_async_tx_desc_t *desc, int tag, const uint8_t *base,
+                               uint32_t elem_len, uint32_t stride, uint32_t count)
+{
+    uint32_t len = 0;
+    uint32_t i;
+    
+    for (i = 0; i < count; i++) {
+        len += cobs_encode(&desc->data[len], tag, base + i * stride, elem_len);
+    }
+    return len;
+}
+
+// 复制发送：数据已在 desc->data 中
+static void tx_desc_copy(uart_async_tx_desc_t *desc, uint32_t len)
+{
+    desc->base = desc->data;
+    desc->elem_len = len;
+    desc->stride = len;
+    desc->count = 1;
+    desc->done = NULL;
+    desc->param = NULL;
+    desc->done_count = 0;
+}
+
+// 提交描述符并确保 TX 中断打开
+static void tx_queue_push(uart_async_port_t *port, uart_async_tx_desc_t *desc)
+{
+    uint32_t depth;
+    uint32_t len = desc->elem_len * desc->count;
+    
+    desc->t_enqueue = UART_ASYNC_NOW();
+    __asm volatile ("dmb" ::: "memory");    // 数据先于 head 可见
+    port->tx_head++;
+    
+    depth = port->tx_head - port->tx_tail;
+    if (depth > port->stats.queue_high_water) {
+        port->stats.queue_high_water = depth;
+    }
+    
+    // === 更新统计（线路上的字节数）===
+    port->stats.total_bytes += len;
+    port->stats.total_packets++;
+    
+    // === 使能 UART TX 中断 ===
+    // 中断正在发送时 TRDYEN 本来就是 1，这里重复置位无影响；
+    // 若中断恰好在读-改-写之间发完并关掉 TRDYEN，这里会再打开一次，
+    // 下一次中断看到队列为空后重新关闭，不会丢数据
+    // 流控暂停时不打开，由 RTS 恢复中断打开（两者之间的竞争最多多一次空中断）
+    if (!port->tx_throttled) {
+        port->regs->UCR1 |= (1 << 13);
+    }
+}
 
 // ==================== Public Functions ====================
 
-void uart_async_init(void)
+void uart_async_port_init(uart_async_port_t *port, UART_Type *regs, IRQn_Type irq)
 {
-    // 1. 初始化全局变量
-    uart_tx_len = 0;
-    uart_tx_idx = 0;
-    uart_tx_busy = false;
+    uart_async_port_t *p;
+    
+    // 0. 登记实例（uart_async_set_clock_hz() 要重算它的字符时间）
+    for (p = uart_ports; p != NULL && p != port; p = p->next) {
+    }
+    if (p == NULL) {
+        port->next = uart_ports;
+        uart_ports = port;
+    }
+    
+    // 1. 初始化实例状态
+    port->regs = regs;
+    port->irq = irq;
+    port->tx_head = 0;
+    port->tx_tail = 0;
+    port->tx_elem = 0;
+    port->tx_idx = 0;
+    port->framing = UART_ASYNC_FRAMING_RAW;
+    port->baud = UART_ASYNC_BAUD_DEFAULT;
+    port->char_ticks_x256 = char_ticks_x256(UART_ASYNC_BAUD_DEFAULT);
+    port->tx_throttled = false;
+    port->flow_enabled = false;
+    port->throttle_start = 0;
+    port->throttled_ticks = 0;
+    port->rx_head = 0;
+    port->rx_tail = 0;
+    port->rx_enabled = false;
+    port->rx_cb = NULL;
+    port->rx_param = NULL;
     
     // 2. 初始化统计信息
-    memset(&g_stats, 0, sizeof(g_stats));
+    memset(&port->stats, 0, sizeof(port->stats));
     
     // 3. 配置 TX FIFO 触发阈值
     // UFCR bits 10-15: TXTL (TX Trigger Level)
-    // 设置为 2：当 FIFO 中少于 2 个字节时触发中断
-    uint32_t ufcr = UART1->UFCR;
+    // FIFO 中字节数 <= TXTL 时触发中断，中断里一次填满 FIFO
+    uint32_t ufcr = port->regs->UFCR;
     ufcr &= ~(0x3F << 10);  // 清除 TXTL bits
-    ufcr |= (2 << 10);       // 设置 TXTL = 2
-    UART1->UFCR = ufcr;
+    ufcr |= (UART_ASYNC_TXTL << 10);
+    port->regs->UFCR = ufcr;
     
     // 4. 确保 TX 中断初始状态为禁用
     // UCR1 bit 13: TRDYEN (Transmitter Ready Interrupt Enable)
-    UART1->UCR1 &= ~(1 << 13);
+    port->regs->UCR1 &= ~(1 << 13);
     
-    // 5. 注册 UART1 中断处理函数
-    system_register_irqhandler(UART1_IRQn, (system_irq_handler_t)uart1_tx_irq_handler, NULL);
+    // 5. 注册中断处理函数（RX / TX 共用，参数是实例）
+    system_register_irqhandler(irq, uart_async_irq_handler, port);
     
     // 6. 使能 GIC 中断
-    GIC_EnableIRQ(UART1_IRQn);
+    GIC_EnableIRQ(irq);
     
-    printf("[ASYNC] UART async TX initialized\r\n");
-    printf("[ASYNC] Buffer size: %d bytes\r\n", UART_ASYNC_TX_BUFFER_SIZE);
-    printf("[ASYNC] 11UFCR=0x%08X (TXTL=%u)\r\n", UART1->UFCR, (UART1->UFCR >> 10) & 0x3F);
+    printf("[ASYNC] UART async TX initialized (IRQ %d)\r\n", irq);
+    printf("[ASYNC] Buffer size: %d bytes x %d descriptors\r\n",
+           UART_ASYNC_TX_BUFFER_SIZE, UART_ASYNC_TX_QUEUE_DEPTH);
+    printf("[ASYNC] 11UFCR=0x%08X (TXTL=%u)\r\n", port->regs->UFCR, (port->regs->UFCR >> 10) & 0x3F);
 }
 
-int uart_async_send(uint8_t *data, uint32_t len)
+int uart_async_port_open(uart_async_port_t *port, UART_Type *regs, IRQn_Type irq, uint32_t baud)
 {
+    uint32_t start;
+    uint32_t timeout = UART_ASYNC_RESET_TIMEOUT_MS * (uart_now_hz / 1000u);
+    
+    if (baud == 0 || baud > UART_ASYNC_REF_CLK_HZ / 16) {
+        return -2;
+    }
+    
+    // 1. 关闭并软复位
+    // UCR1 bit 0: UARTEN，UCR2 bit 0: SRST（写 0 开始复位，完成后硬件置 1）
+    regs->UCR1 &= ~(1 << 0);
+    regs->UCR2 &= ~(1 << 0);
+    start = UART_ASYNC_NOW();
+    while ((regs->UCR2 & (1 << 0)) == 0) {
+        if (UART_ASYNC_NOW() - start > timeout) {
+            printf("[ASYNC] UART reset timeout: IRQ %d\r\n", irq);
+            return -1;
+        }
+    }
+    
+    // 2. 8N1，忽略 RTS_B，收发使能
+    // UCR2 bit 14: IRTS，bit 5: WS（8 位），bit 2: TXEN，bit 1: RXEN（PREN / STPB 复位后为 0：无校验、1 停止位）
+    // UCR3 bit 2: RXDMUXSEL，i.MX6ULL 上必须置 1
+    regs->UCR1 = 0;
+    regs->UCR2 |= (1 << 14) | (1 << 5) | (1 << 2) | (1 << 1);
+    regs->UCR3 |= (1 << 2);
+    
+    // 3. 异步收发 + 分频（UFCR.RFDIV / UBIR / UBMR）
+    uart_async_port_init(port, regs, irq);
+    uart_async_port_set_baud(port, baud);
+    
+    // 4. 使能 UART
+    regs->UCR1 |= (1 << 0);
+    
+    printf("[ASYNC] UART opened: IRQ %d, %u baud\r\n", irq, baud);
+    return 0;
+}
+
+int uart_async_port_send(uart_async_port_t *port, uint8_t *data, uint32_t len)
+{
+    uart_async_tx_desc_t *desc;
+    
     // === 参数检查 ===
     if (data == NULL || len == 0) {
         return -2;  // 参数错误
     }
     
-    if (len > UART_ASYNC_TX_BUFFER_SIZE) {
+    if (uart_async_port_wire_len(port, len) > UART_ASYNC_TX_BUFFER_SIZE) {
         return -2;  // 数据太长
     }
     
-    // === 检查是否忙 ===
-    if (uart_tx_busy) {
-        g_stats.errors++;
-        return -1;  // 上一次发送还没完成
+    // === 取空闲描述符 ===
+    desc = tx_queue_slot(port);
+    if (desc == NULL) {
+        return -1;  // 队列满（前面还有 UART_ASYNC_TX_QUEUE_DEPTH 次发送没写完）
     }
     
-    // === 复制数据到 TX 缓冲区 ===
+    // === 复制数据到描述符 ===
     // 为什么要复制？因为调用者的 data 可能会被修改
     // 例如：ring buffer 的下一次 read 会覆盖同一个位置
-    memcpy(uart_tx_buffer, data, len);
+    if (port->framing == UART_ASYNC_FRAMING_COBS) {
+        len = cobs_encode(desc->data, COBS_NO_TAG, data, len);
+    } else {
+        memcpy(desc->data, data, len);
+    }
     
-    // === 初始化发送状态 ===
-    uart_tx_len = len;
-    uart_tx_idx = 0;
-    uart_tx_busy = true;
+    // === 入队：接在前面的数据后面发送 ===
+    tx_desc_copy(desc, len);
+    tx_queue_push(port, desc);
     
-    // === 更新统计 ===
-    g_stats.total_bytes += len;
-    g_stats.total_packets++;
+    // === 立即返回！CPU 不用等待 ===
+    return 0;
+}
+
+int uart_async_port_send_gather(uart_async_port_t *port, const uint8_t *base, uint32_t elem_len,
+                                uint32_t stride, uint32_t count)
+{
+    uart_async_tx_desc_t *desc;
+    uint32_t len = elem_len * count;
+    uint32_t i;
     
-    // === 启动发送：使能 UART TX 中断 ===
-    UART1->UCR1 |= (1 << 13);
+    // === 参数检查 ===
+    if (base == NULL || elem_len == 0 || count == 0 || stride < elem_len) {
+        return -2;
+    }
+    
+    if (uart_async_port_wire_len(port, elem_len) * count > UART_ASYNC_TX_BUFFER_SIZE) {
+        return -2;  // 数据太长
+    }
+    
+    // === 取空闲描述符 ===
+    desc = tx_queue_slot(port);
+    if (desc == NULL) {
+        return -1;
+    }
+    
+    // === 去掉槽间填充，首尾相连地复制到描述符（COBS：每个元素一帧）===
+    if (port->framing == UART_ASYNC_FRAMING_COBS) {
+        len = tx_desc_encode(desc, COBS_NO_TAG, base, elem_len, stride, count);
+    } else {
+        for (i = 0; i < count; i++) {
+            memcpy(&desc->data[i * elem_len], base + i * stride, elem_len);
+        }
+    }
+    
+    // === 入队（一批算一次传输） ===
+    tx_desc_copy(desc, len);
+    tx_queue_push(port, desc);
     
-    // === 立即返回！CPU 不用等待 ===
     return 0;
 }
 
-bool uart_async_is_busy(void)
+int uart_async_port_send_ref(uart_async_port_t *port, const uint8_t *base, uint32_t elem_len,
+                             uint32_t stride, uint32_t count, uart_async_done_t done, void *param)
 {
-    return uart_tx_busy;
+    uart_async_tx_desc_t *desc;
+    
+    // === 参数检查 ===
+    if (base == NULL || elem_len == 0 || count == 0 || stride < elem_len) {
+        return -2;
+    }
+    
+    if (port->framing == UART_ASYNC_FRAMING_COBS &&
+        uart_async_port_wire_len(port, elem_len) * count > UART_ASYNC_TX_BUFFER_SIZE) {
+        return -2;  // COBS 要编码进描述符，受缓冲区大小限制
+    }
+    
+    // === 取空闲描述符 ===
+    desc = tx_queue_slot(port);
+    if (desc == NULL) {
+        return -1;
+    }
+    
+    if (port->framing == UART_ASYNC_FRAMING_COBS) {
+        // COBS 要改写数据，不能原地发送：编码进描述符
+        // done 仍然在中断里调用（编码后的数据写进 FIFO 时），与引用发送的调用上下文一致
+        tx_desc_copy(desc, tx_desc_encode(desc, COBS_NO_TAG, base, elem_len, stride, count));
+        desc->done = done;
+        desc->param = param;
+        desc->done_count = count;
+        tx_queue_push(port, desc);
+        return 0;
+    }
+    
+    // === 引用发送：中断直接从调用者的缓冲区读，不复制 ===
+    desc->base = base;
+    desc->elem_len = elem_len;
+    desc->stride = stride;
+    desc->count = count;
+    desc->done = done;
+    desc->param = param;
+    desc->done_count = count;
+    tx_queue_push(port, desc);
+    
+    return 0;
 }
 
-void uart_async_wait_complete(void)
+int uart_async_port_send_tagged(uart_async_port_t *port, uint8_t tag, const uint8_t *base,
+                                uint32_t elem_len, uint32_t stride, uint32_t count,
+                                uart_async_done_t done, void *param)
 {
-    // 阻塞等待发送完成
-    while (uart_tx_busy) {
-        // 空等待
-        // 也可以添加超时保护
+    uart_async_tx_desc_t *desc;
+    
+    // === 参数检查：标签只能放在 COBS 帧里 ===
+    if (port->framing != UART_ASYNC_FRAMING_COBS || tag == 0) {
+        return -2;
+    }
+    if (base == NULL || elem_len == 0 || count == 0 || stride < elem_len) {
+        return -2;
+    }
+    if (UART_ASYNC_COBS_LEN(elem_len + 1) * count > UART_ASYNC_TX_BUFFER_SIZE) {
+        return -2;
+    }
+    
+    desc = tx_queue_slot(port);
+    if (desc == NULL) {
+        return -1;
     }
+    
+    // 每个元素编码成 COBS(tag + 元素)，调用者的缓冲区在返回后就可以复用；
+    // done 和引用发送一样在中断里调用（编码后的数据写进 FIFO 时）
+    tx_desc_copy(desc, tx_desc_encode(desc, tag, base, elem_len, stride, count));
+    desc->done = done;
+    desc->param = param;
+    desc->done_count = count;
+    tx_queue_push(port, desc);
+    return 0;
 }
 
-uart_async_stats_t* uart_async_get_stats(void)
+void uart_async_port_set_framing(uart_async_port_t *port, uint32_t framing)
+{
+    port->framing = framing;
+    printf("[ASYNC] Framing: %s\r\n", framing == UART_ASYNC_FRAMING_COBS ? "COBS" : "raw");
+}
+
+uint32_t uart_async_port_wire_len(uart_async_port_t *port, uint32_t len)
+{
+    if (port->framing == UART_ASYNC_FRAMING_COBS) {
+        return UART_ASYNC_COBS_LEN(len);
+    }
+    return len;
+}
+
+void uart_async_port_set_flow_control(uart_async_port_t *port, bool enable)
+{
+    if (!enable) {
+        // UCR1 bit 5: RTSDEN (RTS Delta Interrupt Enable)
+        // UCR2 bit 14: IRTS = 1，忽略 RTS_B，发送器一直可以发送
+        port->regs->UCR1 &= ~(1 << 5);
+        port->regs->UCR2 |= (1 << 14);
+        port->flow_enabled = false;
+        if (port->tx_throttled) {
+            port->tx_throttled = false;
+            port->throttled_ticks += UART_ASYNC_NOW() - port->throttle_start;
+        }
+        return;
+    }
+    
+    // 1. 当前 RTS 状态（RTS_B 引脚复用由调用者配置，默认实例见 uart_async_set_flow_control()）
+    // USR1 bit 14: RTSS（1 = RTS_B 有效，可以发送），bit 12: RTSD（变化标志，写 1 清零）
+    UART_ASYNC_CLEAR_USR1(port->regs, 1 << 12);
+    port->throttle_start = UART_ASYNC_NOW();
+    port->tx_throttled = !(port->regs->USR1 & (1 << 14));
+    if (port->tx_throttled) {
+        port->stats.tx_throttle_events++;
+    }
+    port->flow_enabled = true;
+    
+    // 2. 发送器受 RTS_B 控制 + RTS 变化中断
+    port->regs->UCR2 &= ~(1 << 14);
+    port->regs->UCR1 |= (1 << 5);
+    
+    printf("[ASYNC] RTS/CTS flow control enabled, RTS %s\r\n",
+           port->tx_throttled ? "deasserted (TX paused)" : "asserted");
+}
+
+int uart_async_port_set_baud(uart_async_port_t *port, uint32_t baud)
+{
+    uint32_t num, den, a, b, t;
+    uint32_t ufcr;
+    
+    if (baud == 0 || baud > UART_ASYNC_REF_CLK_HZ / 16) {
+        return -2;
+    }
+    
+    // (UBIR + 1) / (UBMR + 1) = 16 x baud / ref，辗转相除约分
+    num = baud * 16;
+    den = UART_ASYNC_REF_CLK_HZ;
+    a = num;
+    b = den;
+    while (b != 0) {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    num /= a;
+    den /= a;
+    
+    // UBIR / UBMR 只有 16 位：约分后还放不下时一起缩小（误差 < 0.01%）
+    while (num > 0x10000 || den > 0x10000) {
+        num = (num + 1) >> 1;
+        den = (den + 1) >> 1;
+    }
+    
+    // UFCR bits 7-9: RFDIV = 101（参考时钟 /1）
+    ufcr = port->regs->UFCR;
+    ufcr &= ~(7 << 7);
+    ufcr |= (5 << 7);
+    port->regs->UFCR = ufcr;
+    
+    // 必须先写 UBIR 再写 UBMR，写 UBMR 时新分频值生效
+    port->regs->UBIR = num - 1;
+    port->regs->UBMR = den - 1;
+    
+    port->baud = baud;
+    port->char_ticks_x256 = char_ticks_x256(baud);
+    return 0;
+}
+
+uint32_t uart_async_port_get_baud(uart_async_port_t *port)
+{
+    return port->baud;
+}
+
+bool uart_async_port_is_busy(uart_async_port_t *port)
 {
-    return &g_stats;
+    return port->tx_head != port->tx_tail;
+}
+
+uint32_t uart_async_port_tx_free(uart_async_port_t *port)
+{
+    return UART_ASYNC_TX_QUEUE_DEPTH - (port->tx_head - port->tx_tail);
+}
+
+bool uart_async_port_is_throttled(uart_async_port_t *port)
+{
+    return port->tx_throttled;
+}
+
+int uart_async_port_wait_complete(uart_async_port_t *port)
+{
+    uint32_t start = UART_ASYNC_NOW();
+    uint32_t timeout = UART_ASYNC_WAIT_TIMEOUT_MS * (uart_now_hz / 1000u);
+    
+    // 阻塞等待队列里的描述符全部写进 FIFO
+    // 流控暂停时队列和 FIFO 都不会变空，超时返回
+    while (uart_async_port_is_busy(port)) {
+        if (UART_ASYNC_NOW() - start > timeout) {
+            return -1;
+        }
+    }
+    
+    // 再等 FIFO 和移位寄存器发空
+    // USR2 bit 3: TXDC (Transmitter Complete)
+    while (!(port->regs->USR2 & (1 << 3))) {
+        if (UART_ASYNC_NOW() - start > timeout) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void uart_async_port_rx_enable(uart_async_port_t *port, uart_async_rx_cb_t cb, void *param)
+{
+    uint32_t ufcr;
+    
+    port->rx_cb = cb;
+    port->rx_param = param;
+    port->rx_enabled = true;
+    
+    // 1. RX FIFO 触发阈值
+    // UFCR bits 0-5: RXTL，FIFO 中字节数 >= RXTL 时置 RRDY
+    ufcr = port->regs->UFCR;
+    ufcr &= ~0x3F;
+    ufcr |= UART_ASYNC_RXTL;
+    port->regs->UFCR = ufcr;
+    
+    // 2. 清掉使能前残留的状态
+    // USR1 bit 8: AGTIM，USR2 bit 1: ORE，USR2 bit 12: IDLE（均为写 1 清零）
+    UART_ASYNC_CLEAR_USR1(port->regs, 1 << 8);
+    UART_ASYNC_CLEAR_USR2(port->regs, (1 << 1) | (1 << 12));
+    
+    // 3. 老化定时器：FIFO 非空且 8 个字符时间没有新数据时置 AGTIM，
+    //    不满 RXTL 的尾巴也能及时取走
+    // UCR2 bit 3: ATEN (Aging Timer Enable)
+    port->regs->UCR2 |= (1 << 3);
+    
+    // 4. 溢出中断
+    // UCR4 bit 1: OREN (Receiver Overrun Interrupt Enable)
+    port->regs->UCR4 |= (1 << 1);
+    
+    // 5. RRDY 中断 + 空闲检测中断
+    // UCR1 bit 9: RRDYEN，bit 12: IDEN，bits 10-11: ICD = 00（空闲 4 个字符时间）
+    port->regs->UCR1 = (port->regs->UCR1 & ~(3 << 10)) | (1 << 9) | (1 << 12);
+    
+    printf("[ASYNC] UART async RX enabled: ring %d bytes, RXTL=%d\r\n",
+           UART_ASYNC_RX_BUFFER_SIZE, UART_ASYNC_RXTL);
+}
+
+uint32_t uart_async_port_rx_available(uart_async_port_t *port)
+{
+    return port->rx_head - port->rx_tail;
+}
+
+uint32_t uart_async_port_read(uart_async_port_t *port, uint8_t *buf, uint32_t max)
+{
+    uint32_t tail = port->rx_tail;
+    uint32_t n = port->rx_head - tail;
+    uint32_t i;
+    
+    if (buf == NULL) {
+        return 0;
+    }
+    if (n > max) {
+        n = max;
+    }
+    
+    __asm volatile ("dmb" ::: "memory");    // 先看到 head，再读数据
+    for (i = 0; i < n; i++) {
+        buf[i] = port->rx_buffer[(tail + i) & (UART_ASYNC_RX_BUFFER_SIZE - 1)];
+    }
+    __asm volatile ("dmb" ::: "memory");    // 读完再归还空间
+    port->rx_tail = tail + n;
+    
+    return n;
+}
+
+uart_async_stats_t* uart_async_port_get_stats(uart_async_port_t *port)
+{
+    uint32_t start, ticks;
+    bool throttled;
+
+    // 正在暂停时加上本次已经暂停的时间（中断只在恢复时累加）
+    // 读到一半被 RTS 中断打断时 throttle_start / throttled_ticks 会变，重读
+    do {
+        start = port->throttle_start;
+        ticks = port->throttled_ticks;
+        throttled = port->tx_throttled;
+    } while (start != port->throttle_start || ticks != port->throttled_ticks);
+    port->stats.tx_throttled = throttled ? 1 : 0;
+    port->stats.tx_throttled_ticks = throttled ? ticks + (UART_ASYNC_NOW() - start) : ticks;
+
+    // 平均每次中断写入的字节数（主循环里算，中断里不做除法）
+    // 整数部分和余数分开算，避免 irq_bytes * 100 溢出
+    uint32_t n = port->stats.total_interrupts;
+    if (n > 0) {
+        port->stats.bytes_per_irq_x100 = (port->stats.irq_bytes / n) * 100 +
+                                     (port->stats.irq_bytes % n) * 100 / n;
+    }
+    return &port->stats;
+}
+
+// tick → us（分开算整数部分和余数，避免大 tick 值乘 1000 溢出）
+static uint32_t lat_ticks_to_us(uint32_t ticks)
+{
+    uint32_t hz = uart_now_hz;
+    
+    return (ticks / hz) * 1000000u + (ticks % hz) * 1000u / (hz / 1000u);
+}
+
+// 累计计数达到 count x permille / 1000 的桶的上界（tick），不超过最大值
+static uint32_t lat_percentile(const uart_async_lat_hist_t *h, uint32_t permille)
+{
+    // count x permille 可能超过 32 位，拆开算（向上取整）
+    uint32_t target = (h->count / 1000) * permille + ((h->count % 1000) * permille + 999) / 1000;
+    uint32_t sum = 0;
+    uint32_t i;
+    
+    for (i = 0; i < UART_ASYNC_LAT_BUCKETS - 1; i++) {
+        sum += h->bucket[i];
+        if (sum >= target) {
+            return (i == 0) ? 0 : ((1u << i) < h->max ? (1u << i) : h->max);
+        }
+    }
+    return h->max;
+}
+
+static void lat_print_summary(uart_async_print_t print, const char *name,
+                              const uart_async_lat_hist_t *h)
+{
+    print("[ASYNC]   %s: p50<=%u us, p99<=%u us, max=%u us\r\n", name,
+           lat_ticks_to_us(lat_percentile(h, 500)),
+           lat_ticks_to_us(lat_percentile(h, 990)),
+           lat_ticks_to_us(h->max));
+}
+
+void uart_async_port_dump_latency(uart_async_port_t *port, uart_async_print_t print)
+{
+    uint32_t i;
+    
+    if (print == NULL) {
+        print = printf;
+    }
+    print("[ASYNC] TX latency: transfers=%u, baud=%u (log2 buckets, us)\r\n",
+           port->stats.tx_total_lat.count, port->baud);
+    for (i = 0; i < UART_ASYNC_LAT_BUCKETS; i++) {
+        uint32_t q = port->stats.tx_queue_lat.bucket[i];
+        uint32_t w = port->stats.tx_wire_lat.bucket[i];
+        uint32_t t = port->stats.tx_total_lat.bucket[i];
+        
+        if (q == 0 && w == 0 && t == 0) {
+            continue;   // 只打印非空的桶
+        }
+        if (i == UART_ASYNC_LAT_BUCKETS - 1) {
+            print("[ASYNC]   >=%8u  queue=%6u  wire=%6u  total=%6u\r\n",
+                   lat_ticks_to_us(1u << (i - 1)), q, w, t);
+        } else {
+            print("[ASYNC]   < %8u  queue=%6u  wire=%6u  total=%6u\r\n",
+                   lat_ticks_to_us(i == 0 ? 1 : (1u << i)), q, w, t);
+        }
+    }
+    lat_print_summary(print, "queue", &port->stats.tx_queue_lat);
+    lat_print_summary(print, "wire ", &port->stats.tx_wire_lat);
+    lat_print_summary(print, "total", &port->stats.tx_total_lat);
+}
+
+void uart_async_port_reset_latency(uart_async_port_t *port)
+{
+    memset(&port->stats.tx_queue_lat, 0, sizeof(port->stats.tx_queue_lat));
+    memset(&port->stats.tx_wire_lat, 0, sizeof(port->stats.tx_wire_lat));
+    memset(&port->stats.tx_total_lat, 0, sizeof(port->stats.tx_total_lat));
+}
+
+void uart_async_set_clock_hz(uint32_t hz)
+{
+    uart_async_port_t *port;
+    
+    if (hz < 1000u) {
+        return;                 // lat_ticks_to_us() 除以 hz / 1000
+    }
+    uart_now_hz = hz;
+    
+    // 字符时间是一个字，中断里读到旧值或新值都可以
+    for (port = uart_ports; port != NULL; port = port->next) {
+        port->char_ticks_x256 = char_ticks_x256(port->baud);
+    }
+}
+
+uint32_t uart_async_get_clock_hz(void)
+{
+    return uart_now_hz;
 }
 
 // ==================== Interrupt Handler ====================
 
-void uart1_tx_irq_handler(void)
+// 记一个延迟样本：桶号 = 有效位数（0 → 0，1 → 1，2~3 → 2，4~7 → 3 ...），一条 CLZ 指令
+static void lat_record(uart_async_lat_hist_t *h, uint32_t ticks)
+{
+    uint32_t b = (ticks == 0) ? 0 : 32 - __builtin_clz(ticks);
+    
+    if (b > UART_ASYNC_LAT_BUCKETS - 1) {
+        b = UART_ASYNC_LAT_BUCKETS - 1;
+    }
+    h->bucket[b]++;
+    h->count++;
+    if (ticks > h->max) {
+        h->max = ticks;
+    }
+}
+
+// 一次传输完成（最后一个字节进了 FIFO）：t_done 是它发完的估算时刻
+static void tx_record_latency(uart_async_port_t *port, const uart_async_tx_desc_t *desc, uint32_t t_done)
+{
+    port->stats.tx_last_enqueue = desc->t_enqueue;
+    port->stats.tx_last_first = desc->t_first;
+    port->stats.tx_last_done = t_done;
+    lat_record(&port->stats.tx_queue_lat, desc->t_first - desc->t_enqueue);
+    lat_record(&port->stats.tx_wire_lat, t_done - desc->t_first);
+    lat_record(&port->stats.tx_total_lat, t_done - desc->t_enqueue);
+}
+
+// 取空 RX FIFO，返回取到的字节数
+static uint32_t uart_rx_drain(uart_async_port_t *port)
+{
+    uint32_t head = port->rx_head;
+    uint32_t count = 0;
+    
+    // USR2 bit 0: RDR (Receive Data Ready)
+    while (port->regs->USR2 & (1 << 0)) {
+        // URXD bit 14: ERR（bit 12 FRMERR / bit 10 PRERR / bit 11 BRK 的汇总），bits 0-7: 数据
+        uint32_t rx = UART_ASYNC_READ_RXD(port->regs);
+        
+        if (rx & (1 << 14)) {
+            port->stats.rx_errors++;
+            continue;           // 帧错误 / 校验错误 / break：丢弃这个字节
+        }
+        if (head - port->rx_tail >= UART_ASYNC_RX_BUFFER_SIZE) {
+            port->stats.rx_dropped++;
+            continue;           // 软件环满：读走腾出硬件 FIFO，丢新字节
+        }
+        port->rx_buffer[head & (UART_ASYNC_RX_BUFFER_SIZE - 1)] = (uint8_t)(rx & 0xFF);
+        head++;
+        count++;
+    }
+    
+    __asm volatile ("dmb" ::: "memory");    // 数据先于 head 可见
+    port->rx_head = head;
+    port->stats.rx_bytes += count;
+    return count;
+}
+
+static void uart_rx_irq_handler(uart_async_port_t *port)
+{
+    uint32_t status1 = port->regs->USR1;
+    uint32_t status2 = port->regs->USR2;
+    uint32_t events = 0;
+    
+    if (!port->rx_enabled) {
+        return;
+    }
+    
+    // USR2 bit 1: ORE，硬件 FIFO 溢出（中断来晚了），写 1 清零
+    if (status2 & (1 << 1)) {
+        UART_ASYNC_CLEAR_USR2(port->regs, 1 << 1);
+        port->stats.rx_overruns++;
+    }
+    
+    // USR1 bit 9: RRDY（>= RXTL），bit 8: AGTIM（老化），USR2 bit 12: IDLE
+    if (!(status1 & ((1 << 9) | (1 << 8))) && !(status2 & (1 << 12))) {
+        return;
+    }
+    port->stats.rx_interrupts++;
+    
+    if (uart_rx_drain(port) > 0) {
+        events |= UART_ASYNC_RX_EVENT_DATA;
+    }
+    
+    // 老化 / 空闲：对端停了，当前是一帧的结尾，通知上层立即处理不满阈值的数据
+    if (status1 & (1 << 8)) {
+        UART_ASYNC_CLEAR_USR1(port->regs, 1 << 8);
+    }
+    if (status2 & (1 << 12)) {
+        UART_ASYNC_CLEAR_USR2(port->regs, 1 << 12);
+        port->stats.rx_idle_events++;
+        events |= UART_ASYNC_RX_EVENT_IDLE;
+    }
+    
+    if (events && port->rx_cb != NULL) {
+        port->rx_cb(port->rx_param, events);
+    }
+}
+
+// RTS 变化：暂停 / 恢复发送
+static void uart_flow_irq_handler(uart_async_port_t *port)
+{
+    uint32_t status1 = port->regs->USR1;
+    
+    // USR1 bit 12: RTSD，写 1 清零
+    if (!port->flow_enabled || !(status1 & (1 << 12))) {
+        return;
+    }
+    UART_ASYNC_CLEAR_USR1(port->regs, 1 << 12);
+    
+    // USR1 bit 14: RTSS，1 = RTS_B 有效
+    if (!(status1 & (1 << 14))) {
+        if (!port->tx_throttled) {
+            port->tx_throttled = true;
+            port->throttle_start = UART_ASYNC_NOW();
+            port->stats.tx_throttle_events++;
+            port->regs->UCR1 &= ~(1 << 13);
+        }
+    } else if (port->tx_throttled) {
+        port->tx_throttled = false;
+        port->throttled_ticks += UART_ASYNC_NOW() - port->throttle_start;
+        // 队列里还有数据：接着断点继续（tx_elem / tx_idx 没有变）
+        if (port->tx_tail != port->tx_head) {
+            port->regs->UCR1 |= (1 << 13);
+        }
+    }
+}
+
+static void uart_tx_irq_handler(uart_async_port_t *port)
 {
     // === 读取 UART 状态寄存器 ===
-    uint32_t status1 = UART1->USR1;
+    uint32_t status1 = port->regs->USR1;
     
     // === 检查 TX Ready 标志 ===
-    // USR1 bit 13: TRDY (Transmitter Ready)
-    if (status1 & (1 << 13)) {
-        // === 发送一个字节 ===
-        if (uart_tx_idx < uart_tx_len) {
-            UART1->UTXD = uart_tx_buffer[uart_tx_idx] & 0xFF;
-            uart_tx_idx++;
-            g_stats.total_interrupts++;
+    // USR1 bit 13: TRDY (Transmitter Ready，FIFO 中字节数 <= TXTL)
+    // TX 空闲时 TRDY 一直是 1，RX 中断进来时要看 TRDYEN，避免把 RX 中断算成 TX 中断
+    if ((status1 & (1 << 13)) && (port->regs->UCR1 & (1 << 13))) {
+        // 流控暂停：FIFO 不会变空，TRDY 一直有效，必须关掉 TRDYEN 否则中断风暴
+        if (port->tx_throttled) {
+            port->regs->UCR1 &= ~(1 << 13);
+            return;
         }
         
-        // === 检查是否全部发送完成 ===
-        if (uart_tx_idx >= uart_tx_len) {
-            // 禁用 TX 中断
-            UART1->UCR1 &= ~(1 << 13);
-            // 标记为空闲
-            uart_tx_busy = false;
+        uint32_t written = 0;
+        uint32_t now = UART_ASYNC_NOW();
+        // FIFO 里排在下一个字节前面的字节数（延迟统计用）
+        // USR2 bit 14: TXFE，FIFO 空；不空时 TRDY 说明剩余 <= TXTL，按 TXTL 估算
+        uint32_t fifo = (port->regs->USR2 & (1 << 14)) ? 0 : UART_ASYNC_TXTL;
+        
+        // === 填满 TX FIFO ===
+        // 一个描述符发完直接接着发下一个，同一次中断内完成切换，线路上没有空隙
+        // UTS bit 4: TXFULL
+        while (port->tx_tail != port->tx_head && !(port->regs->UTS & (1 << 4))) {
+            uart_async_tx_desc_t *desc = &port->tx_queue[port->tx_tail & (UART_ASYNC_TX_QUEUE_DEPTH - 1)];
+            
+            if (port->tx_elem == 0 && port->tx_idx == 0) {
+                // 传输的第一个字节：前面的 fifo 个字节发完后开始上线
+                desc->t_first = now + ((fifo * port->char_ticks_x256) >> 8);
+            }
+            UART_ASYNC_WRITE_TXD(port->regs, desc->base[port->tx_elem * desc->stride + port->tx_idx] & 0xFF);
+            port->tx_idx++;
+            written++;
+            fifo++;
+            
+            if (port->tx_idx < desc->elem_len) {
+                continue;
+            }
+            port->tx_idx = 0;            // 下一个元素（跳过元素间的填充）
+            if (++port->tx_elem < desc->count) {
+                continue;
+            }
+            
+            // 描述符发完：最后的字节已进 FIFO，调用者的缓冲区可以归还了
+            // 它前面（含自己）的 fifo 个字节发完就是这次传输离开线路的时刻
+            tx_record_latency(port, desc, now + ((fifo * port->char_ticks_x256) >> 8));
+            port->tx_elem = 0;
+            port->tx_tail++;
+            if (desc->done != NULL) {
+                desc->done(desc->param, desc->done_count);
+            }
+        }
+        
+        port->stats.total_interrupts++;
+        port->stats.irq_bytes += written;
+        if (written > port->stats.max_bytes_per_irq) {
+            port->stats.max_bytes_per_irq = written;
         }
+        
+        // === 检查队列是否已空 ===
+        if (port->tx_tail == port->tx_head) {
+            // 禁用 TX 中断，下一次 send 重新打开
+            port->regs->UCR1 &= ~(1 << 13);
+        }
+    }
+}
+
+void uart_async_irq_handler(unsigned int giccIar, void *param)
+{
+    uart_async_port_t *port = (uart_async_port_t *)param;
+    
+    uart_flow_irq_handler(port);
+    uart_rx_irq_handler(port);
+    uart_tx_irq_handler(port);
+}
+
+// ==================== Default Port ====================
+// 不带 port 的接口：作用于默认实例（UART_ASYNC_BASE / UART_ASYNC_IRQn）
+
+void uart_async_init(void)
+{
+    uart_async_port_init(&g_uart_async_default, UART_ASYNC_BASE, UART_ASYNC_IRQn);
+}
+
+int uart_async_send(uint8_t *data, uint32_t len)
+{
+    return uart_async_port_send(&g_uart_async_default, data, len);
+}
+
+int uart_async_send_gather(const uint8_t *base, uint32_t elem_len,
+                           uint32_t stride, uint32_t count)
+{
+    return uart_async_port_send_gather(&g_uart_async_default, base, elem_len, stride, count);
+}
+
+int uart_async_send_ref(const uint8_t *base, uint32_t elem_len, uint32_t stride,
+                        uint32_t count, uart_async_done_t done, void *param)
+{
+    return uart_async_port_send_ref(&g_uart_async_default, base, elem_len, stride, count, done, param);
+}
+
+int uart_async_send_tagged(uint8_t tag, const uint8_t *base, uint32_t elem_len,
+                           uint32_t stride, uint32_t count,
+                           uart_async_done_t done, void *param)
+{
+    return uart_async_port_send_tagged(&g_uart_async_default, tag, base, elem_len, stride, count,
+                                       done, param);
+}
+
+void uart_async_set_framing(uint32_t framing)
+{
+    uart_async_port_set_framing(&g_uart_async_default, framing);
+}
+
+uint32_t uart_async_wire_len(uint32_t len)
+{
+    return uart_async_port_wire_len(&g_uart_async_default, len);
+}
+
+int uart_async_set_baud(uint32_t baud)
+{
+    return uart_async_port_set_baud(&g_uart_async_default, baud);
+}
+
+uint32_t uart_async_get_baud(void)
+{
+    return uart_async_port_get_baud(&g_uart_async_default);
+}
+
+void uart_async_set_flow_control(bool enable)
+{
+    if (enable) {
+        // UART1_RTS_B（输入，上拉：对端没接时视为无效 → 暂停发送，提示接线问题）
+        IOMUXC_SetPinMux(UART_ASYNC_RTS_PINMUX, 0);
+        IOMUXC_SetPinConfig(UART_ASYNC_RTS_PINMUX, 0x10B0);
     }
+    uart_async_port_set_flow_control(&g_uart_async_default, enable);
+}
+
+bool uart_async_is_busy(void)
+{
+    return uart_async_port_is_busy(&g_uart_async_default);
+}
+
+uint32_t uart_async_tx_free(void)
+{
+    return uart_async_port_tx_free(&g_uart_async_default);
+}
+
+int uart_async_wait_complete(void)
+{
+    return uart_async_port_wait_complete(&g_uart_async_default);
+}
+
+bool uart_async_is_throttled(void)
+{
+    return uart_async_port_is_throttled(&g_uart_async_default);
+}
+
+void uart_async_rx_enable(uart_async_rx_cb_t cb, void *param)
+{
+    uart_async_port_rx_enable(&g_uart_async_default, cb, param);
+}
+
+uint32_t uart_async_rx_available(void)
+{
+    return uart_async_port_rx_available(&g_uart_async_default);
+}
+
+uint32_t uart_async_read(uint8_t *buf, uint32_t max)
+{
+    return uart_async_port_read(&g_uart_async_default, buf, max);
+}
+
+uart_async_stats_t* uart_async_get_stats(void)
+{
+    return uart_async_port_get_stats(&g_uart_async_default);
+}
+
+void uart_async_dump_latency(uart_async_print_t print)
+{
+    uart_async_port_dump_latency(&g_uart_async_default, print);
+}
+
+void uart_async_reset_latency(void)
+{
+    uart_async_port_reset_latency(&g_uart_async_default);
+}
+
+void uart1_irq_handler(void)
+{
+    uart_async_irq_handler(0, &g_uart_async_default);
+}
+
+void uart1_tx_irq_handler(void)
+{
+    uart_tx_irq_handler(&g_uart_async_default);
 }
@@ -9,27 +9,225 @@
 // ==================== UART 异步发送模块 ====================
 // Stage 3: 使用 UART TX 中断实现非阻塞异步发送
 // 目标: CPU 不阻塞在 UART 发送上，可以处理其他任务
-// 原理: 利用 UART TX FIFO 空中断，每次中断发送一个字节
+// 原理: 利用 UART TX FIFO 低水位中断（TRDY），每次中断把 32 字节的 TX FIFO 填满
+// 发送队列: send 把数据复制进一个 TX 描述符后追加到队尾，中断发完一个接着发下一个，
+//           连续发送时线路不停顿，调用方不需要等上一次发送完成
+// 多实例: 每个 UART 的队列 / RX 环 / 统计都在一个 uart_async_port_t 里，uart_async_port_*() 指定实例；
+//         不带 port 的 uart_async_*() 作用于默认实例（UART_ASYNC_BASE，即 UART1 控制台）
 
 // ==================== Configuration ====================
 
+// 默认实例的寄存器块和中断号，主机上测试时可以换成模拟的寄存器块
+#ifndef UART_ASYNC_BASE
+#define UART_ASYNC_BASE             UART1
+#endif
+#ifndef UART_ASYNC_IRQn
+#define UART_ASYNC_IRQn             UART1_IRQn
+#endif
+
+// UART 参考时钟：PLL3 480MHz / 6 = 80MHz（CSCDR1 选 pll3_80m，UART_CLK_PODF 不分频）
+// UFCR.RFDIV 设为 /1，波特率 = 80MHz / (16 x (UBMR + 1) / (UBIR + 1))
+#ifndef UART_ASYNC_REF_CLK_HZ
+#define UART_ASYNC_REF_CLK_HZ       80000000
+#endif
+
+// 上电后 BSP uart_init() 设置的波特率，也是协商失败时的回退波特率
+#define UART_ASYNC_BAUD_DEFAULT     115200
+
 // TX 缓冲区大小（必须 >= sizeof(sensor_packet_t) = 30）
-#define UART_ASYNC_TX_BUFFER_SIZE   64
+// 批量发送时一次最多装 UART_ASYNC_TX_BUFFER_SIZE / 30 个包（512 → 17 个，覆盖整个 16 槽 Ring Buffer）
+#define UART_ASYNC_TX_BUFFER_SIZE   512
+
+// TX 描述符个数（2 的幂），每个描述符一块 UART_ASYNC_TX_BUFFER_SIZE 缓冲区
+// 4 个：中断发送一个的同时，主循环还能再排 3 次发送
+#ifndef UART_ASYNC_TX_QUEUE_DEPTH
+#define UART_ASYNC_TX_QUEUE_DEPTH   4
+#endif
+
+#if (UART_ASYNC_TX_QUEUE_DEPTH & (UART_ASYNC_TX_QUEUE_DEPTH - 1)) != 0
+#error "UART_ASYNC_TX_QUEUE_DEPTH must be a power of 2"
+#endif
+
+// TX FIFO 触发阈值：FIFO 中剩余字节数 <= TXTL 时触发 TRDY 中断
+// 32 字节 FIFO，阈值 8：每次中断补约 24 字节，剩下的 8 字节（115200 下约 0.7ms）留给中断延迟
+#define UART_ASYNC_TX_FIFO_SIZE     32
+#define UART_ASYNC_TXTL             8
+
+// 硬件流控（uart_async_set_flow_control）：上位机 USB 串口的 RTS 接 UART1_RTS_B 引脚
+// i.MX UART 默认是 DCE，RTS_B 是输入；UCR2.IRTS = 0 时 RTS_B 无效（高电平）发送器停在字符边界，
+// 中断同时停止补 FIFO，排队的数据留在描述符里，积压最终在采样 Ring 的 overflow_count 里体现
+#ifndef UART_ASYNC_RTS_PINMUX
+#define UART_ASYNC_RTS_PINMUX       IOMUXC_UART1_RTS_B_UART1_RTS_B
+#endif
+
+// uart_async_wait_complete() 最长等待时间：4 个满描述符在 115200 下约 180ms 发完，
+// 超过这个时间说明发送器被流控暂停（对端 RTS 无效），返回 -1 而不是死等
+#ifndef UART_ASYNC_WAIT_TIMEOUT_MS
+#define UART_ASYNC_WAIT_TIMEOUT_MS  500
+#endif
+
+// uart_async_port_open() 等软复位完成的最长时间：SRST 几个模块时钟就结束，
+// 超时说明 UART 没有时钟（时钟门控没开）或寄存器块不对，返回 -1 而不是死等
+#ifndef UART_ASYNC_RESET_TIMEOUT_MS
+#define UART_ASYNC_RESET_TIMEOUT_MS 10
+#endif
+
+// 时间源（流控暂停计时 / TX 延迟统计），默认 GPT1 自由计数器
+#ifndef UART_ASYNC_NOW
+#include "../../imx6ul/imx6ul.h"
+#define UART_ASYNC_NOW()            (GPT1->CNT)
+#endif
+// 时间源频率的初值：GPT1 标称约 645kHz；bsp 不依赖 timebase，标定后由调用者
+// uart_async_set_clock_hz(timebase_rate_hz()) 换成实测值
+#ifndef UART_ASYNC_NOW_HZ
+#define UART_ASYNC_NOW_HZ           645000
+#endif
+
+// 有副作用的寄存器访问：读 URXD 取走 RX FIFO 的一个字节，写 UTXD 放进 TX FIFO，USR1 / USR2 写 1 清零
+// 默认直接访问寄存器；主机上测试时（Docs/host）换成 UART 模型的函数，其余寄存器当普通内存读写
+#ifndef UART_ASYNC_READ_RXD
+#define UART_ASYNC_READ_RXD(regs)           ((regs)->URXD)
+#define UART_ASYNC_WRITE_TXD(regs, value)   ((regs)->UTXD = (value))
+#define UART_ASYNC_CLEAR_USR1(regs, bits)   ((regs)->USR1 = (bits))
+#define UART_ASYNC_CLEAR_USR2(regs, bits)   ((regs)->USR2 = (bits))
+#endif
+
+// TX 延迟直方图桶数（log2 刻度）：桶 0 = 0 tick，桶 i = [2^(i-1), 2^i) tick，最后一个桶收所有更大的值
+// 20 个桶：最后一个桶从 2^18 tick（约 400ms）开始
+#define UART_ASYNC_LAT_BUCKETS      20
+
+// RX 环形缓冲区大小（2 的幂）
+#ifndef UART_ASYNC_RX_BUFFER_SIZE
+#define UART_ASYNC_RX_BUFFER_SIZE   256
+#endif
+
+#if (UART_ASYNC_RX_BUFFER_SIZE & (UART_ASYNC_RX_BUFFER_SIZE - 1)) != 0
+#error "UART_ASYNC_RX_BUFFER_SIZE must be a power of 2"
+#endif
+
+// RX FIFO 触发阈值：FIFO 中字节数 >= RXTL 时触发 RRDY 中断
+// 16：115200 下还剩 16 字节（约 1.4ms）的余量才会溢出；不满 16 字节的尾巴由老化定时器取走
+#define UART_ASYNC_RXTL             16
+
+// RX 事件（uart_async_rx_cb_t 的 events，可同时置位）
+#define UART_ASYNC_RX_EVENT_DATA    (1 << 0)    // 有新数据进入 RX 环
+#define UART_ASYNC_RX_EVENT_IDLE    (1 << 1)    // 线路空闲（4 个字符时间没有数据），通常是一帧结束
+
+// 帧格式（uart_async_set_framing）
+// RAW : 原样发送，上位机靠 0xAA 0x55 找包头（数据里也可能出现这两个字节）
+// COBS: 每次 send（gather 时每个元素）编码成一个 COBS 帧并以 0x00 结尾
+//       数据中不再有 0x00，帧边界唯一，出错后最多丢一帧就能重新同步
+#define UART_ASYNC_FRAMING_RAW      0
+#define UART_ASYNC_FRAMING_COBS     1
+
+// n 字节数据 COBS 编码后（含 0x00 分隔符）的最大长度
+#define UART_ASYNC_COBS_LEN(n)      ((n) + (n) / 254 + 2)
 
 // ==================== Data Structures ====================
 
+// 引用发送的完成回调（中断上下文）：count 个元素的最后一个字节已写进 TX FIFO，
+// 缓冲区可以归还 / 复用。回调里只做归还和通知，不要再调用 uart_async_send*()
+typedef void (*uart_async_done_t)(void *param, uint32_t count);
+
+// 打印函数（uart_async_dump_latency 的输出），与 printf 相同的用法
+typedef int (*uart_async_print_t)(const char *fmt, ...);
+
+// RX 事件回调（中断上下文）：events 为 UART_ASYNC_RX_EVENT_* 的组合
+// 回调里只做通知（置标志 / 给信号量），数据用 uart_async_read() 在主循环 / 任务里取
+typedef void (*uart_async_rx_cb_t)(void *param, uint32_t events);
+
+// TX 延迟直方图（单位：UART_ASYNC_NOW 的 tick）
+typedef struct {
+    uint32_t count;                             // 样本数
+    uint32_t max;                               // 最大值
+    uint32_t bucket[UART_ASYNC_LAT_BUCKETS];    // log2 分桶计数
+} uart_async_lat_hist_t;
+
 // 异步发送统计信息
 typedef struct {
     uint32_t total_bytes;       // 总发送字节数
     uint32_t total_packets;     // 总发送包数
-    uint32_t total_interrupts;  // 总中断次数
-    uint32_t errors;            // 错误次数（发送时 busy）
+    uint32_t total_interrupts;  // 总中断次数（每次中断计一次，不是每字节）
+    uint32_t errors;            // 错误次数（发送时队列满）
+    uint32_t irq_bytes;         // 中断中写入 UTXD 的总字节数
+    uint32_t max_bytes_per_irq; // 单次中断写入的最大字节数
+    uint32_t bytes_per_irq_x100;// 平均每次中断写入的字节数 x100（uart_async_get_stats() 时计算）
+    uint32_t queue_high_water;  // 队列中同时排队的最大描述符数
+    uint32_t tx_throttled;      // 当前是否被对端 RTS 暂停（1=暂停）
+    uint32_t tx_throttle_events;// 被暂停的次数
+    uint32_t tx_throttled_ticks;// 累计暂停时间（UART_ASYNC_NOW 的 tick，含正在进行的暂停，uart_async_get_stats() 时计算）
+    uint32_t tx_last_enqueue;   // 最近完成的一次传输：入队时刻
+    uint32_t tx_last_first;     // 最近完成的一次传输：第一个字节开始上线的时刻（估算）
+    uint32_t tx_last_done;      // 最近完成的一次传输：最后一个字节发完的时刻（估算）
+    uart_async_lat_hist_t tx_queue_lat; // 排队延迟：入队 → 第一个字节上线
+    uart_async_lat_hist_t tx_wire_lat;  // 线路时间：第一个字节上线 → 最后一个字节发完
+    uart_async_lat_hist_t tx_total_lat; // 端到端：入队 → 最后一个字节发完
+    uint32_t rx_bytes;          // 收到并放进 RX 环的字节数
+    uint32_t rx_interrupts;     // RX 中断次数（RRDY / 老化 / 空闲）
+    uint32_t rx_idle_events;    // 空闲检测次数
+    uint32_t rx_overruns;       // 硬件 RX FIFO 溢出次数（USR2.ORE）
+    uint32_t rx_dropped;        // RX 环满丢弃的字节数
+    uint32_t rx_errors;         // 帧错误 / 校验错误 / break 的字节数
 } uart_async_stats_t;
 
+// TX 描述符：send 追加到队列 head，中断从 tail 依次发送
+// 描述符统一描述 count 个等间距的元素：
+// - 复制发送：base 指向描述符自带的 data，count = 1
+// - 引用发送（send_ref）：base 指向调用者的缓冲区，发完最后一个字节后调用 done
+// - 编码发送（COBS 下的 send_ref / send_tagged）：同复制发送，但仍在发完后调用 done(param, done_count)
+typedef struct {
+    const uint8_t *base;        // 第一个元素
+    uint32_t elem_len;          // 每个元素的字节数
+    uint32_t stride;            // 元素间距
+    uint32_t count;             // 元素个数
+    uart_async_done_t done;     // 完成回调（复制发送为 NULL）
+    void *param;
+    uint32_t done_count;        // 传给 done 的元素个数（编码发送时与 count 不同）
+    uint32_t t_enqueue;         // 入队时刻
+    uint32_t t_first;           // 第一个字节开始上线的时刻（中断里估算）
+    uint8_t data[UART_ASYNC_TX_BUFFER_SIZE];
+} uart_async_tx_desc_t;
+
+// 一个 UART 实例（uart_async_port_init() 初始化，之后只通过 uart_async_port_*() 访问）
+// 约 2.8KB（4 个描述符 + RX 环 + 统计），静态分配
+typedef struct uart_async_port {
+    UART_Type *regs;                    // 寄存器块（UART1 ~ UART8）
+    IRQn_Type irq;                      // 中断号
+    struct uart_async_port *next;       // 已初始化的实例链表（改时间源频率时逐个重算字符时间）
+
+    // TX 描述符队列：head 只由发送方（主循环 / 任务）修改，tail 只由中断修改，
+    // 单生产者单消费者不需要关中断
+    uart_async_tx_desc_t tx_queue[UART_ASYNC_TX_QUEUE_DEPTH];
+    volatile uint32_t tx_head;          // 已提交的描述符数（自由递增，取模得到下标）
+    volatile uint32_t tx_tail;          // 已写完 FIFO 的描述符数
+    uint32_t tx_elem;                   // tail 描述符当前发送到第几个元素
+    uint32_t tx_idx;                    // 当前元素发送到第几个字节
+    uint32_t framing;                   // 帧格式（UART_ASYNC_FRAMING_*）
+    uint32_t baud;                      // 当前波特率
+    uint32_t char_ticks_x256;           // 一个字符（10 位）的时间，UART_ASYNC_NOW tick x256（按 uart_async_get_clock_hz()）
+    volatile bool tx_throttled;         // 对端 RTS 无效，暂停补 FIFO（打开流控后只在中断里修改）
+    bool flow_enabled;                  // RTS/CTS 流控是否打开
+    volatile uint32_t throttle_start;   // 本次暂停开始的时间
+    volatile uint32_t throttled_ticks;  // 已结束的暂停累计时间（恢复时在中断里累加）
+
+    // 接收环形缓冲区：head 只由中断修改，tail 只由 uart_async_port_read() 修改
+    uint8_t rx_buffer[UART_ASYNC_RX_BUFFER_SIZE];
+    volatile uint32_t rx_head;          // 已收到的字节数（自由递增）
+    volatile uint32_t rx_tail;          // 已读走的字节数
+    bool rx_enabled;                    // uart_async_port_rx_enable() 之后才处理 RX
+    uart_async_rx_cb_t rx_cb;           // 接收事件回调（中断上下文）
+    void *rx_param;
+
+    uart_async_stats_t stats;           // 性能统计
+} uart_async_port_t;
+
+// 默认实例（UART_ASYNC_BASE / UART_ASYNC_IRQn），不带 port 的 uart_async_*() 都作用于它
+extern uart_async_port_t g_uart_async_default;
+
 // ==================== Function Prototypes ====================
 
 /**
- * @brief 初始化 UART 异步发送模块
+ * @brief 初始化 UART 异步发送模块（默认实例）
  * 
  * 配置 UART TX 中断，注册中断处理函数
  * 必须在 uart_init() 之后调用
@@ -41,29 +239,176 @@ void uart_async_init(void);
  * 
  * @param data 要发送的数据指针
  * @param len  数据长度（字节）
- * @return int 0=成功启动，-1=忙（上次发送未完成），-2=参数错误
+ * @return int 0=已入队，-1=忙（队列满），-2=参数错误
  * 
  * 注意：
  * - 函数会立即返回（不阻塞）
- * - 数据会被复制到内部缓冲区
+ * - 数据会被复制到一个 TX 描述符，接在已排队的数据后面发送
  * - 实际发送在中断中完成
  */
 int uart_async_send(uint8_t *data, uint32_t len);
 
+/**
+ * @brief 启动异步发送（分散/聚集版本）
+ * 
+ * @param base     第一个元素的地址
+ * @param elem_len 每个元素要发送的字节数
+ * @param stride   相邻元素之间的地址间距（>= elem_len）
+ * @param count    元素个数
+ * @return int 0=已入队，-1=忙（队列满），-2=参数错误（总长度超过缓冲区）
+ * 
+ * 注意：
+ * - 用于一次发送 Ring Buffer 中的一段连续槽（槽宽 4 字节对齐，包之间有填充）
+ * - 各元素首尾相连地复制到一个 TX 描述符，线路上没有填充字节
+ * - 整批只占一个描述符
+ */
+int uart_async_send_gather(const uint8_t *base, uint32_t elem_len,
+                           uint32_t stride, uint32_t count);
+
+/**
+ * @brief 零拷贝异步发送（引用调用者的缓冲区）
+ * 
+ * @param base     第一个元素的地址
+ * @param elem_len 每个元素要发送的字节数
+ * @param stride   相邻元素之间的地址间距（>= elem_len）
+ * @param count    元素个数
+ * @param done     完成回调（可为 NULL），发完后在中断中调用 done(param, count)
+ * @param param    回调参数
+ * @return int 0=已入队，-1=忙（队列满），-2=参数错误
+ * 
+ * 注意：
+ * - 数据不复制，中断直接从 base 读取；done 被调用之前缓冲区不能修改或复用
+ * - 典型用法：ring_spsc_claim_span() 领取的槽直接交给 UART，done 里 release_claimed
+ * - COBS 帧格式下数据必须编码，仍然编码进内部缓冲区（长度限制同 gather），
+ *   缓冲区在函数返回后就不再读取，但 done 同样在编码后的数据写进 FIFO 后、在中断中调用
+ */
+int uart_async_send_ref(const uint8_t *base, uint32_t elem_len, uint32_t stride,
+                        uint32_t count, uart_async_done_t done, void *param);
+
+/**
+ * @brief 带标签的异步发送（逻辑通道，见 bsp_uart_channel.h）
+ * 
+ * @param tag      帧的第一个字节（非 0），上位机按它分流
+ * @param base     第一个元素的地址
+ * @param elem_len 每个元素要发送的字节数
+ * @param stride   相邻元素之间的地址间距（>= elem_len）
+ * @param count    元素个数
+ * @param done     完成回调（可为 NULL），编码后的数据写进 FIFO 后在中断中调用 done(param, count)
+ * @param param    回调参数
+ * @return int 0=已入队，-1=忙（队列满），-2=参数错误（不是 COBS 帧格式 / 总长度超过缓冲区）
+ * 
+ * 每个元素编码成一个 COBS 帧：COBS(tag + 元素) + 0x00，每帧比不带标签多 1 字节
+ * 数据总要编码复制，调用者的缓冲区在函数返回后就可以复用
+ */
+int uart_async_send_tagged(uint8_t tag, const uint8_t *base, uint32_t elem_len,
+                           uint32_t stride, uint32_t count,
+                           uart_async_done_t done, void *param);
+
+/**
+ * @brief 设置帧格式
+ * 
+ * @param framing UART_ASYNC_FRAMING_RAW / UART_ASYNC_FRAMING_COBS
+ * 
+ * 只在空闲时调用（uart_async_init() 之后、开始发送之前）
+ */
+void uart_async_set_framing(uint32_t framing);
+
+/**
+ * @brief 计算 len 字节数据在当前帧格式下占用的 TX 缓冲区字节数
+ * 
+ * 用于决定一次 gather 最多能装几个元素
+ */
+uint32_t uart_async_wire_len(uint32_t len);
+
+/**
+ * @brief 设置波特率
+ * 
+ * @param baud 目标波特率（<= UART_ASYNC_REF_CLK_HZ / 16，80MHz 时最高 5M）
+ * @return int 0=成功，-2=参数错误（波特率为 0 或超过 16 倍过采样的上限）
+ * 
+ * 按 UART_ASYNC_REF_CLK_HZ 计算 UBIR / UBMR：(UBIR + 1) / (UBMR + 1) = 16 x baud / ref，
+ * 约分后 115200 / 460800 / 921600 / 3000000 都是整除，没有误差
+ * 调用前先 uart_async_wait_complete()，否则 FIFO 里的字节会以新波特率发出
+ */
+int uart_async_set_baud(uint32_t baud);
+
+/**
+ * @brief 当前波特率（uart_async_init() 时为 UART_ASYNC_BAUD_DEFAULT）
+ */
+uint32_t uart_async_get_baud(void);
+
+/**
+ * @brief 打开 / 关闭 RTS/CTS 硬件流控（TX 方向）
+ * 
+ * @param enable true=对端 RTS 无效时暂停发送，false=忽略 RTS 引脚（默认）
+ * 
+ * 打开时配置 UART1_RTS_B 引脚复用和 RTS 变化中断：
+ * - RTS 无效：发送器停在字符边界，TX 中断不再补 FIFO，开始计时
+ * - RTS 有效：累加暂停时间，队列里有数据时重新打开 TX 中断，从断点继续发送
+ * 在 uart_async_init() 之后、开始发送之前调用
+ */
+void uart_async_set_flow_control(bool enable);
+
 /**
  * @brief 检查发送是否忙
  * 
- * @return bool true=正在发送，false=空闲
+ * @return bool true=队列里还有没写进 FIFO 的数据，false=空闲
+ * 
+ * 队列未满时 send 仍然可以入队，判断能否发送用 uart_async_tx_free()
  */
 bool uart_async_is_busy(void);
 
+/**
+ * @brief 空闲 TX 描述符个数
+ * 
+ * @return uint32_t 0 ~ UART_ASYNC_TX_QUEUE_DEPTH，大于 0 时下一次 send 不会返回 -1
+ */
+uint32_t uart_async_tx_free(void);
+
 /**
  * @brief 等待发送完成
  * 
- * 阻塞等待当前发送完成
- * 用于需要确保数据发送完成的场景（如关机前）
+ * @return int 0=已发完，-1=超时（UART_ASYNC_WAIT_TIMEOUT_MS，一般是流控暂停了发送）
+ * 
+ * 阻塞等待队列里所有数据发送完成（包括 TX FIFO 和移位寄存器里的字节）
+ * 用于需要确保数据发送完成的场景（如关机前、改波特率前）
+ * 
+ * 注意：uart_async_is_busy() 在最后一批字节写进 FIFO 时就返回 false，
+ * 此时 FIFO 里可能还有最多 32 字节在发送；新的发送会接在后面，不受影响
+ */
+int uart_async_wait_complete(void);
+
+/**
+ * @brief 发送是否被对端 RTS 暂停
+ * 
+ * @return bool true=流控已打开且对端 RTS 无效，写 FIFO 的阻塞输出（printf）会一直等下去
  */
-void uart_async_wait_complete(void);
+bool uart_async_is_throttled(void);
+
+/**
+ * @brief 使能中断接收
+ * 
+ * @param cb    RX 事件回调（可为 NULL，只用 uart_async_read() 轮询）
+ * @param param 回调参数
+ * 
+ * 配置 RXTL、老化定时器、空闲检测和溢出中断，在 uart_async_init() 之后、开始发送之前调用
+ * 收到的字节进入 UART_ASYNC_RX_BUFFER_SIZE 字节的环形缓冲区，满时丢新字节（rx_dropped）
+ */
+void uart_async_rx_enable(uart_async_rx_cb_t cb, void *param);
+
+/**
+ * @brief RX 环中可读的字节数
+ */
+uint32_t uart_async_rx_available(void);
+
+/**
+ * @brief 从 RX 环读取数据（不阻塞）
+ * 
+ * @param buf 目标缓冲区
+ * @param max 最多读取的字节数
+ * @return uint32_t 实际读取的字节数（没有数据时为 0）
+ */
+uint32_t uart_async_read(uint8_t *buf, uint32_t max);
 
 /**
  * @brief 获取统计信息
@@ -73,11 +418,114 @@ void uart_async_wait_complete(void);
 uart_async_stats_t* uart_async_get_stats(void);
 
 /**
- * @brief UART TX 中断处理函数
+ * @brief 打印 TX 延迟直方图（排队 / 线路 / 端到端，单位 us）
+ * 
+ * 每次传输（一次 send / gather / send_ref）记录三个时刻：
+ * - 入队：tx_queue_push() 时读 UART_ASYNC_NOW()
+ * - 第一个字节上线 / 最后一个字节发完：中断把字节写进 FIFO 的时刻
+ *   + FIFO 里排在它前面的字节数 x 字符时间（10 位，按当前波特率）
+ *   TX FIFO 里的字节数读不出来，中断入口 FIFO 非空时按 TXTL 个字节估算：
+ *   通常偏早不到 1 个字符，中断来得晚（FIFO 已低于 TXTL）时最多偏早 TXTL 个字符
+ * 流控暂停期间 FIFO 里的字节不走，这部分时间不计入线路时间
+ * 在主循环 / 任务里调用（格式化输出，较慢），不要在中断里调用
+ * 
+ * @param print 输出函数，NULL 时用 printf；开了逻辑通道时传 uart_channel_log，不打断二进制帧
+ */
+void uart_async_dump_latency(uart_async_print_t print);
+
+/**
+ * @brief 清空 TX 延迟直方图（改波特率 / 批量大小后重新统计）
+ * 
+ * 与中断并发时可能少算或多算正在完成的一次传输
+ */
+void uart_async_reset_latency(void);
+
+/**
+ * @brief 设置时间源（UART_ASYNC_NOW）的实际频率
+ * 
+ * 字符时间（延迟估算）、延迟直方图的 tick → us、wait_complete 超时、日志通道老化都按它换算；
+ * 没调用时按 UART_ASYNC_NOW_HZ。在 timebase_calibrate() 之后调用：
+ * uart_async_set_clock_hz(timebase_rate_hz())，已初始化的实例立即按新频率重算字符时间，
+ * 之后初始化的实例直接用新频率
+ * 
+ * @param hz 频率（Hz），低于 1000 时忽略
+ */
+void uart_async_set_clock_hz(uint32_t hz);
+
+/**
+ * @brief 当前使用的时间源频率（Hz）
+ */
+uint32_t uart_async_get_clock_hz(void);
+
+// ==================== 多实例接口 ====================
+// 行为、参数、返回值与上面同名的函数相同，只是作用于 port：
+// uart_async_xxx(...) 等价于 uart_async_port_xxx(&g_uart_async_default, ...)
+
+/**
+ * @brief 初始化一个 UART 实例的异步收发
+ * 
+ * @param port 实例（静态分配，初始化前内容不限）
+ * @param regs 寄存器块
+ * @param irq  中断号，注册 uart_async_irq_handler()，参数为 port
+ * 
+ * 只配置 TX 中断和 FIFO 阈值，UART 本身（引脚、8N1、使能）要已经初始化：
+ * 默认实例由 BSP uart_init() 完成，其他实例用 uart_async_port_open()
+ */
+void uart_async_port_init(uart_async_port_t *port, UART_Type *regs, IRQn_Type irq);
+
+/**
+ * @brief 初始化一个 BSP 没有初始化过的 UART 实例并打开异步收发
+ * 
+ * @param baud 初始波特率
+ * @return int 0=成功，-1=软复位超时（UART_ASYNC_RESET_TIMEOUT_MS，实例没有初始化），-2=参数错误（波特率）
+ * 
+ * 软复位 → 8N1、忽略 RTS_B、收发使能 → uart_async_port_init() → uart_async_port_set_baud(baud)
+ * 引脚复用由调用者配置；各 UART 共用 UART_CLK_ROOT（UART_ASYNC_REF_CLK_HZ），时钟门控在 clk_enable() 里已打开
+ */
+int uart_async_port_open(uart_async_port_t *port, UART_Type *regs, IRQn_Type irq, uint32_t baud);
+
+int uart_async_port_send(uart_async_port_t *port, uint8_t *data, uint32_t len);
+int uart_async_port_send_gather(uart_async_port_t *port, const uint8_t *base, uint32_t elem_len,
+                                uint32_t stride, uint32_t count);
+int uart_async_port_send_ref(uart_async_port_t *port, const uint8_t *base, uint32_t elem_len,
+                             uint32_t stride, uint32_t count, uart_async_done_t done, void *param);
+int uart_async_port_send_tagged(uart_async_port_t *port, uint8_t tag, const uint8_t *base,
+                                uint32_t elem_len, uint32_t stride, uint32_t count,
+                                uart_async_done_t done, void *param);
+void uart_async_port_set_framing(uart_async_port_t *port, uint32_t framing);
+uint32_t uart_async_port_wire_len(uart_async_port_t *port, uint32_t len);
+int uart_async_port_set_baud(uart_async_port_t *port, uint32_t baud);
+uint32_t uart_async_port_get_baud(uart_async_port_t *port);
+void uart_async_port_set_flow_control(uart_async_port_t *port, bool enable);  // 不配置 RTS 引脚复用
+bool uart_async_port_is_busy(uart_async_port_t *port);
+uint32_t uart_async_port_tx_free(uart_async_port_t *port);
+int uart_async_port_wait_complete(uart_async_port_t *port);
+bool uart_async_port_is_throttled(uart_async_port_t *port);
+void uart_async_port_rx_enable(uart_async_port_t *port, uart_async_rx_cb_t cb, void *param);
+uint32_t uart_async_port_rx_available(uart_async_port_t *port);
+uint32_t uart_async_port_read(uart_async_port_t *port, uint8_t *buf, uint32_t max);
+uart_async_stats_t* uart_async_port_get_stats(uart_async_port_t *port);
+void uart_async_port_dump_latency(uart_async_port_t *port, uart_async_print_t print);
+void uart_async_port_reset_latency(uart_async_port_t *port);
+
+/**
+ * @brief UART 中断处理函数（流控 → RX → TX）
+ * 
+ * @param param 注册时传入的 uart_async_port_t
  * 
  * 内部函数，由中断系统调用
  * 不要直接调用！
  */
+void uart_async_irq_handler(unsigned int giccIar, void *param);
+
+/**
+ * @brief 默认实例的中断处理函数（同 uart_async_irq_handler(0, &g_uart_async_default)）
+ */
+void uart1_irq_handler(void);
+
+/**
+ * @brief 默认实例的 TX 中断处理函数（由中断处理函数调用）
+ */
 void uart1_tx_irq_handler(void);
 
 #endif // _BSP_UART_ASYNC_H
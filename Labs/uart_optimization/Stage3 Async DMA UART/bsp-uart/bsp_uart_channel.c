@@ -0,0 +1,178 @@
+#include "bsp_uart_channel.h"
+#include <stdarg.h>
+#include "../../stdio/include/string.h"
+#include "../../stdio/include/stdio.h"
+
+// ==================== Private Variables ====================
+
+static bool uart_channel_enabled;      // uart_channel_init() 之后才加标签
+
+// 日志环形缓冲区：head / tail 都只在主循环里修改
+static uint8_t uart_log_buffer[UART_CHANNEL_LOG_BUFFER_SIZE];
+static uint32_t uart_log_head;          // 已写入的字节数（自由递增）
+static uint32_t uart_log_tail;          // 已发出的字节数
+static uint32_t uart_log_since;         // 缓冲区里最早的日志开始等待的时间
+static char uart_log_line[UART_CHANNEL_LOG_LINE_MAX];
+
+// 各通道入队前要保留的空闲描述符数
+static const uint32_t uart_channel_reserve[UART_CHANNEL_COUNT] = {
+    UART_CHANNEL_RESERVE_CONTROL,
+    UART_CHANNEL_RESERVE_TELEMETRY,
+    UART_CHANNEL_RESERVE_LOG,
+};
+
+static uart_channel_stats_t g_channel_stats;
+
+// ==================== Private Functions ====================
+
+static void channel_account(uart_channel_t ch, int ret, uint32_t frames, uint32_t bytes)
+{
+    if (ret == 0) {
+        g_channel_stats.frames[ch] += frames;
+        g_channel_stats.bytes[ch] += bytes;
+    } else if (ret == -1) {
+        g_channel_stats.busy[ch]++;
+    }
+}
+
+// 日志能否入队：平时等队列为空，等太久后与遥测同级
+static int channel_log_ready(void)
+{
+    if (uart_channel_tx_ready(UART_CHANNEL_LOG)) {
+        return 1;
+    }
+    return UART_ASYNC_NOW() - uart_log_since > UART_CHANNEL_LOG_AGING_MS * (uart_async_get_clock_hz() / 1000) &&
+           uart_channel_tx_ready(UART_CHANNEL_TELEMETRY);
+}
+
+// ==================== Public Functions ====================
+
+void uart_channel_init(void)
+{
+    uart_log_head = 0;
+    uart_log_tail = 0;
+    uart_log_since = 0;
+    memset(&g_channel_stats, 0, sizeof(g_channel_stats));
+
+    uart_async_set_framing(UART_ASYNC_FRAMING_COBS);
+    uart_channel_enabled = true;
+
+    printf("[CHAN] Logical channels enabled: control=0x%02X telemetry=0x%02X log=0x%02X\r\n",
+           UART_CHANNEL_TAG(UART_CHANNEL_CONTROL), UART_CHANNEL_TAG(UART_CHANNEL_TELEMETRY),
+           UART_CHANNEL_TAG(UART_CHANNEL_LOG));
+}
+
+int uart_channel_tx_ready(uart_channel_t ch)
+{
+    if (!uart_channel_enabled) {
+        return uart_async_tx_free() > 0;
+    }
+    return uart_async_tx_free() > uart_channel_reserve[ch];
+}
+
+uint32_t uart_channel_wire_len(uint32_t len)
+{
+    if (!uart_channel_enabled) {
+        return uart_async_wire_len(len);
+    }
+    return UART_ASYNC_COBS_LEN(len + 1);
+}
+
+int uart_channel_send(uart_channel_t ch, const uint8_t *data, uint32_t len)
+{
+    int ret;
+
+    if (!uart_channel_enabled) {
+        return uart_async_send((uint8_t *)data, len);
+    }
+    ret = uart_async_send_tagged(UART_CHANNEL_TAG(ch), data, len, len, 1, NULL, NULL);
+    channel_account(ch, ret, 1, len);
+    return ret;
+}
+
+int uart_channel_send_ref(uart_channel_t ch, const uint8_t *base, uint32_t elem_len,
+                          uint32_t stride, uint32_t count,
+                          uart_async_done_t done, void *param)
+{
+    int ret;
+
+    if (!uart_channel_enabled) {
+        return uart_async_send_ref(base, elem_len, stride, count, done, param);
+    }
+    ret = uart_async_send_tagged(UART_CHANNEL_TAG(ch), base, elem_len, stride, count, done, param);
+    channel_account(ch, ret, count, elem_len * count);
+    return ret;
+}
+
+int uart_channel_log(const char *fmt, ...)
+{
+    va_list args;
+    uint32_t len, used, i;
+    int n;
+
+    va_start(args, fmt);
+    n = vsnprintf(uart_log_line, sizeof uart_log_line, fmt, args);
+    va_end(args);
+    if (n < 0) {
+        return 0;
+    }
+    // 返回值是不截断时的长度，超长时只有 sizeof - 1 个字节写进了缓冲区
+    len = ((uint32_t)n < sizeof uart_log_line) ? (uint32_t)n : sizeof uart_log_line - 1;
+
+    if (!uart_channel_enabled) {
+        // printf 轮询写 FIFO，流控暂停时会一直等下去，丢掉这一行
+        if (uart_async_is_throttled()) {
+            g_channel_stats.log_dropped++;
+            return 0;
+        }
+        printf("%s", uart_log_line);
+        return len;
+    }
+
+    // 整条放不下就整条丢弃，不留半行
+    used = uart_log_head - uart_log_tail;
+    if (len > UART_CHANNEL_LOG_BUFFER_SIZE - used) {
+        g_channel_stats.log_dropped++;
+        return 0;
+    }
+    if (used == 0) {
+        uart_log_since = UART_ASYNC_NOW();
+    }
+    for (i = 0; i < len; i++) {
+        uart_log_buffer[(uart_log_head + i) & (UART_CHANNEL_LOG_BUFFER_SIZE - 1)] = uart_log_line[i];
+    }
+    uart_log_head += len;
+
+    g_channel_stats.log_lines++;
+    if (used + len > g_channel_stats.log_high_water) {
+        g_channel_stats.log_high_water = used + len;
+    }
+    return len;
+}
+
+void uart_channel_poll(void)
+{
+    // 队列为空时才发日志：最多推迟遥测一个日志帧；饿了 UART_CHANNEL_LOG_AGING_MS 后每次放行一帧
+    while (uart_channel_enabled && uart_log_head != uart_log_tail && channel_log_ready()) {
+        uint32_t offset = uart_log_tail & (UART_CHANNEL_LOG_BUFFER_SIZE - 1);
+        uint32_t len = uart_log_head - uart_log_tail;
+
+        // 不跨回绕点，回绕点后面的留给下一帧
+        if (len > UART_CHANNEL_LOG_BUFFER_SIZE - offset) {
+            len = UART_CHANNEL_LOG_BUFFER_SIZE - offset;
+        }
+        if (len > UART_CHANNEL_LOG_FRAME_MAX) {
+            len = UART_CHANNEL_LOG_FRAME_MAX;
+        }
+        if (uart_channel_send(UART_CHANNEL_LOG, &uart_log_buffer[offset], len) != 0) {
+            break;
+        }
+        uart_log_tail += len;   // 带标签发送是复制编码，返回时缓冲区已经可以复用
+        uart_log_since = UART_ASYNC_NOW();  // 剩下的重新计时
+    }
+}
+
+uart_channel_stats_t *uart_channel_get_stats(void)
+{
+    return &g_channel_stats;
+}
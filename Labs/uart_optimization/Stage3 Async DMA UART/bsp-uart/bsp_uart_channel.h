@@ -0,0 +1,133 @@
+#ifndef _BSP_UART_CHANNEL_H
+#define _BSP_UART_CHANNEL_H
+
+#include "../../stdio/include/types.h"
+#include "bsp_uart_async.h"
+// ==================== UART 逻辑通道 ====================
+// 遥测、日志、控制应答共用 UART1，每帧带一个通道标签，上位机按标签分流
+// 问题: printf() 直接轮询写 UTXD，统计信息会插进正在发送的二进制帧中间，上位机只能跳过乱码
+// 做法: 打开通道后所有帧都是 COBS(标签 + 负载) + 0x00，运行期的文本改走日志通道
+//
+// 帧（COBS 解码后）：
+//   偏移  长度  内容
+//   0     1     标签 UART_CHANNEL_TAG(ch)：0xC0 控制 / 0xC1 遥测 / 0xC2 日志
+//   1     n     负载：控制 = link_control 应答帧；遥测 = 单包 / 批量帧；日志 = 文本（不保证按行切分）
+// 不带标签的帧（第一个字节 0xAA / 0xA5）仍按负载包头识别，上位机两种都能收
+//
+// 优先级：TX 描述符队列先进先出，按通道预留空闲描述符
+// - 通道只有在空闲描述符数 > 它的预留数时才能入队（uart_channel_tx_ready）
+// - 控制不预留；遥测给控制留 1 个；日志只在队列为空时发，每帧最多 UART_CHANNEL_LOG_FRAME_MAX 字节
+// - 已入队的帧不会被插队：高优先级帧最多等前面排着的帧，遥测最多被一个日志帧（加 FIFO 里的字节）推迟
+// - 遥测占满线路时日志不会饿死：等了 UART_CHANNEL_LOG_AGING_MS 的日志按遥测的预留数入队，
+//   每 100ms 放行一帧，日志最多占约 1.3KB/s
+// 日志先格式化进环形缓冲区，由 uart_channel_poll() 在队列空闲时发出；缓冲区满时丢弃整条，不阻塞
+
+// ==================== Configuration ====================
+
+typedef enum {
+    UART_CHANNEL_CONTROL = 0,   // 控制应答（最高优先级）
+    UART_CHANNEL_TELEMETRY,     // 传感器数据
+    UART_CHANNEL_LOG,           // 文本日志（最低优先级）
+    UART_CHANNEL_COUNT,
+} uart_channel_t;
+
+#define UART_CHANNEL_TAG(ch)            (0xC0 | (ch))   // 与包头 0xAA / 0xA5 不冲突
+
+// 各通道入队前要保留的空闲描述符数
+#define UART_CHANNEL_RESERVE_CONTROL    0
+#define UART_CHANNEL_RESERVE_TELEMETRY  1
+#define UART_CHANNEL_RESERVE_LOG        (UART_ASYNC_TX_QUEUE_DEPTH - 1)
+
+// 日志环形缓冲区（2 的幂），一次 5 秒统计信息约 1.2KB
+#ifndef UART_CHANNEL_LOG_BUFFER_SIZE
+#define UART_CHANNEL_LOG_BUFFER_SIZE    2048
+#endif
+
+#if (UART_CHANNEL_LOG_BUFFER_SIZE & (UART_CHANNEL_LOG_BUFFER_SIZE - 1)) != 0
+#error "UART_CHANNEL_LOG_BUFFER_SIZE must be a power of 2"
+#endif
+
+// 每个日志帧的最大负载：115200 下约 11ms，即遥测被日志推迟的上限
+#define UART_CHANNEL_LOG_FRAME_MAX      128
+
+// 日志等待超过这个时间后与遥测同级（防止遥测占满线路时日志饿死）
+#define UART_CHANNEL_LOG_AGING_MS       100
+
+// 单条日志格式化后的最大长度（含结尾的 0，超长截断）
+#define UART_CHANNEL_LOG_LINE_MAX       160
+
+// ==================== Data Structures ====================
+
+typedef struct {
+    uint32_t frames[UART_CHANNEL_COUNT];    // 各通道入队的帧数
+    uint32_t bytes[UART_CHANNEL_COUNT];     // 各通道的负载字节数（不含标签和 COBS 开销）
+    uint32_t busy[UART_CHANNEL_COUNT];      // 入队失败次数（队列满）
+    uint32_t log_lines;                     // 写进日志缓冲区的条数
+    uint32_t log_dropped;                   // 日志缓冲区满（或流控暂停时 printf 会阻塞）丢弃的条数
+    uint32_t log_high_water;                // 日志缓冲区最大占用字节数
+} uart_channel_stats_t;
+
+// ==================== Function Prototypes ====================
+
+/**
+ * @brief 打开逻辑通道
+ *
+ * 把帧格式切到 COBS，之后 uart_channel_send* 发出的帧都带通道标签
+ * 在 uart_async_init() 之后、开始发送之前调用
+ * 不调用时下面的函数退化为原来的行为：不带标签发送，日志直接 printf
+ */
+void uart_channel_init(void);
+
+/**
+ * @brief 通道 ch 现在能否入队
+ *
+ * @return int 1=空闲描述符多于该通道的预留数，0=让给更高优先级的通道
+ */
+int uart_channel_tx_ready(uart_channel_t ch);
+
+/**
+ * @brief len 字节负载在当前帧格式下占用的 TX 缓冲区字节数（含标签）
+ */
+uint32_t uart_channel_wire_len(uint32_t len);
+
+/**
+ * @brief 在通道 ch 上发送一帧（复制）
+ *
+ * @return int 0=已入队，-1=忙（队列满），-2=参数错误
+ */
+int uart_channel_send(uart_channel_t ch, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief 在通道 ch 上发送 count 个元素，每个元素一帧
+ *
+ * 参数和返回值同 uart_async_send_ref()
+ * 通道打开时数据要加标签编码（复制），没打开时就是 uart_async_send_ref()（零拷贝），
+ * 两种情况下 done 都在发完后、在 UART 中断中调用
+ */
+int uart_channel_send_ref(uart_channel_t ch, const uint8_t *base, uint32_t elem_len,
+                          uint32_t stride, uint32_t count,
+                          uart_async_done_t done, void *param);
+
+/**
+ * @brief 写一条日志（用法同 printf）
+ *
+ * @return int 写进缓冲区的字节数，丢弃时为 0
+ *
+ * 格式化后放进日志缓冲区立即返回，由 uart_channel_poll() 发送；只能在主循环 / 任务里调用
+ * 单条不超过 UART_CHANNEL_LOG_LINE_MAX 字节；通道没打开时直接 printf（流控暂停时丢弃，返回 0）
+ */
+int uart_channel_log(const char *fmt, ...);
+
+/**
+ * @brief 发送排队的日志
+ *
+ * 主循环每轮调用，TX 队列为空（或日志已等待 UART_CHANNEL_LOG_AGING_MS）时发日志
+ */
+void uart_channel_poll(void);
+
+/**
+ * @brief 获取统计信息
+ */
+uart_channel_stats_t *uart_channel_get_stats(void);
+
+#endif // _BSP_UART_CHANNEL_H
@@ -1,78 +1,80 @@
 #include "irq_dma.h"
+#include "packet_crc.h"
+#include "batch_frame.h"
+#include "link_control.h"
+#include "link_arq.h"
+#include "link_stripe.h"
+#include "timebase_frame.h"
 #include "../bsp/int/bsp_int.h"
 #include "../bsp/led/bsp_led.h"
 #include "../bsp/uart/bsp_uart_async.h"  // ← 使用异步 UART
+#include "../bsp/uart/bsp_uart_channel.h" // ← 遥测 / 日志 / 控制分通道
+#include "../bsp/icm20608/bsp_icm20608_async.h"  // ← 异步 SPI 读取传感器
+#include "../bsp/timebase/bsp_timebase.h"  // ← GPT1 扩展到 64 位
 #include "../stdio/include/string.h"
 #include "../stdio/include/stdio.h"
 
 // ==================== Global Variables ====================
 
-ring_buffer_t g_ring_buffer_dma;  // 重命名避免冲突
+RING_SPSC_DEFINE(g_ring_buffer_dma, sensor_packet_t, DMA_RING_SIZE);  // 重命名避免冲突
 static uint16_t g_seq_num_dma = 0;
 static uint32_t last_send_time_dma = 0;
 
 // ISR 用的全局变量
 uint32_t g_isr_led_count_dma = 0;
+static uint32_t g_sensor_busy_skips_dma = 0;
+performance_stats_t g_perf_stats_dma;  // Stage 3 自己的中断耗时统计
+// 批量帧
+static volatile uint32_t g_batch_size_dma = SENSOR_BATCH_DEFAULT;
+#if SENSOR_BATCH_MODE
+static batch_frame_t g_batch_frame;
+static uint32_t g_batch_frames_dma = 0;
+static uint32_t g_batch_bytes_dma = 0;
+#endif
+#if SENSOR_FIFO_MODE
+static uint32_t g_fifo_drain_time = 0;      // 本次 FIFO 读取的启动时间（最新样本的时间基准）
+#endif
+static uint32_t g_timebase_frames_dma = 0;  // 发出的时间基准帧
+static timebase_periodic_t g_sample_timer_dma;  // 采样定时器（OCR[0]，绝对截止时刻）
 
-// ==================== Ring Buffer Implementation ====================
-// 与 Stage 2 完全相同，但函数名加 _dma 后缀
-
-void ring_buffer_dma_init(void)
-{
-    g_ring_buffer_dma.write_idx = 0;
-    g_ring_buffer_dma.read_idx = 0;
-    g_ring_buffer_dma.overflow_count = 0;
-    g_ring_buffer_dma.total_samples = 0;
-    
-    printf("[DMA] Ring buffer initialized (size=%d)\r\n", RING_BUFFER_SIZE);
-}
-
-uint32_t ring_buffer_dma_available(void)
+#if SENSOR_BATCH_MODE
+// 批量帧的发送出口：可靠模式下进重传窗口，由 link_arq_poll() 发出；条带化时轮流走各个 UART
+static int telemetry_tx_ready_dma(void)
 {
-    uint32_t write = g_ring_buffer_dma.write_idx;
-    uint32_t read = g_ring_buffer_dma.read_idx;
-    
-    if (write >= read) {
-        return write - read;
-    } else {
-        return RING_BUFFER_SIZE - (read - write);
+#if SENSOR_UART_RELIABLE
+    if (link_arq_enabled()) {
+        return link_arq_window_free() > 0;
     }
+#endif
+#if SENSOR_UART_STRIPE
+    if (link_stripe_enabled()) {
+        return link_stripe_tx_room(BATCH_FRAME_MAX_LEN) > 0;
+    }
+#endif
+    return uart_channel_tx_ready(UART_CHANNEL_TELEMETRY);
 }
 
-uint32_t ring_buffer_dma_free_space(void)
-{
-    return RING_BUFFER_SIZE - ring_buffer_dma_available() - 1;
-}
-
-int ring_buffer_dma_write(sensor_packet_t *packet)
+static int telemetry_send_dma(const uint8_t *frame, uint32_t len)
 {
-    if (ring_buffer_dma_free_space() == 0) {
-        g_ring_buffer_dma.overflow_count++;
-        return -1;
+#if SENSOR_UART_RELIABLE
+    if (link_arq_enabled()) {
+        return link_arq_send(frame, len);
     }
-    
-    uint32_t write_idx = g_ring_buffer_dma.write_idx;
-    memcpy(&g_ring_buffer_dma.buffer[write_idx], packet, sizeof(sensor_packet_t));
-    
-    g_ring_buffer_dma.write_idx = (write_idx + 1) & (RING_BUFFER_SIZE - 1);
-    g_ring_buffer_dma.total_samples++;
-    
-    return 0;
+#endif
+#if SENSOR_UART_STRIPE
+    if (link_stripe_enabled()) {
+        return link_stripe_send(frame, len, len, 1);
+    }
+#endif
+    return uart_channel_send(UART_CHANNEL_TELEMETRY, frame, len);
 }
-
-int ring_buffer_dma_read(sensor_packet_t *packet)
+#else
+// 零拷贝发送完成回调（UART1 中断上下文）：槽里的包已全部写进 TX FIFO，归还给生产者
+static void uart_done_release_dma(void *param, uint32_t count)
 {
-    if (ring_buffer_dma_available() == 0) {
-        return -1;
-    }
-    
-    uint32_t read_idx = g_ring_buffer_dma.read_idx;
-    memcpy(packet, &g_ring_buffer_dma.buffer[read_idx], sizeof(sensor_packet_t));
-    
-    g_ring_buffer_dma.read_idx = (read_idx + 1) & (RING_BUFFER_SIZE - 1);
-    
-    return 0;
+    ring_spsc_release_claimed((ring_spsc_t *)param, count);
 }
+#endif
 
 // ==================== GPT1 Timer Interrupt ====================
 // 与 Stage 2 完全相同，但函数名加 _dma 后缀
@@ -83,44 +85,183 @@ void gpt1_timer_dma_init(void)
     
     GPT1->CR = 0;
     GPT1->PR = 65;
-    GPT1->OCR[0] = PERIOD_TICKS;
+    GPT1->CR = (1 << 9) | (1 << 6) | (1 << 1);
+    timebase_calibrate(GPT1);   // 周期、超时都按标定频率换算，要在算 SAMPLE_TIMER_TICKS 之前
+    uart_async_set_clock_hz(timebase_rate_hz());   // UART 延迟估算 / 等待超时 / 日志老化同样按标定频率
+    timebase_periodic_init(&g_sample_timer_dma, GPT1, 0, SAMPLE_TIMER_TICKS);
     GPT1->SR = 0x3F;
+#if SENSOR_DRDY_MODE
+    GPT1->IR = 0;         // 只作时间基准，采样由 DRDY 中断驱动
+#else
     GPT1->IR = 1 << 0;
-    GPT1->CR = (1 << 9) | (1 << 6) | (1 << 1);
+#endif
     
     system_register_irqhandler(GPT1_IRQn, (system_irq_handler_t)gpt1_irq_handler_dma, NULL);
     GIC_EnableIRQ(GPT1_IRQn);
     
     GPT1->CR |= (1 << 0);
+    timebase_init(GPT1);    // 溢出中断也走 gpt1_irq_handler_dma()
     
-    printf("[DMA] GPT1 timer started: %dms period, FreeRun mode\r\n", PERIOD_MS);
+    printf("[DMA] GPT1 timer started: %ums period, FreeRun mode\r\n",
+           timebase_ticks_to_us(SAMPLE_TIMER_TICKS) / 1000);
 }
 
-void gpt1_irq_handler_dma(void)
+#if SENSOR_ASYNC_READ
+// SPI 读取完成回调（ECSPI3 中断上下文）
+static void sensor_read_done_dma(const uint8_t *data, uint32_t len, void *param)
 {
-    GPT1->SR = 1 << 0;
-    GPT1->OCR[0] = GPT1->CNT + PERIOD_TICKS;
+    uint32_t entry_time = get_system_tick();
+    sensor_packet_t *packet = (sensor_packet_t *)param;
+    
+    icm20608_async_decode(data, &packet->accel_x, &packet->accel_y, &packet->accel_z,
+                          &packet->gyro_x, &packet->gyro_y, &packet->gyro_z);
+    
+    packet->process_ticks = entry_time - packet->timestamp;  // 启动 SPI → 数据就绪
+    packet->send_ticks = last_send_time_dma;
+    packet_seal(packet);
+    
+    ring_spsc_commit(&g_ring_buffer_dma);
+    perf_stats_isr_record(&g_perf_stats_dma, entry_time);
+}
+#endif
+
+#if SENSOR_FIFO_MODE
+// FIFO 读取完成回调（ECSPI3 中断上下文）
+// 一次读出 n 个样本，每个样本生成一个数据包
+static void sensor_fifo_done_dma(const uint8_t *records, uint32_t n, void *param)
+{
+    uint32_t entry_time = get_system_tick();
+    uint32_t k;
+    
+    for (k = 0; k < n; k++) {
+        uint16_t seq = g_seq_num_dma++;
+        sensor_packet_t *packet = ring_spsc_reserve(&g_ring_buffer_dma);
+        if (packet == NULL) {
+            continue;  // Buffer 满，丢弃该样本（seq 照样递增，上位机可统计丢包）
+        }
+        
+        // 时间戳重建：最新样本 ≈ 读取启动时刻，之前的按 ODR 间隔往前推
+        packet->header[0] = 0xAA;
+        packet->header[1] = 0x55;
+        packet->seq_num = seq;
+        packet->timestamp = g_fifo_drain_time - (n - 1 - k) * SENSOR_FIFO_SAMPLE_TICKS;
+        
+        icm20608_fifo_decode(records + k * ICM20608_FIFO_RECORD_LEN,
+                             &packet->accel_x, &packet->accel_y, &packet->accel_z,
+                             &packet->gyro_x, &packet->gyro_y, &packet->gyro_z);
+        
+        packet->process_ticks = entry_time - g_fifo_drain_time;  // 启动读取 → 数据就绪
+        packet->send_ticks = last_send_time_dma;
+        packet_seal(packet);
+        
+        ring_spsc_commit(&g_ring_buffer_dma);
+    }
     
+    perf_stats_isr_record(&g_perf_stats_dma, entry_time);
+}
+#endif
+
+// 采样一次：在 Ring Buffer 空槽内组包并启动读取
+// entry_time: 中断入口时间（定时器模式）或 DRDY 边沿时间，作为样本时间戳
+static void sensor_sample_dma(uint32_t entry_time)
+{
     g_isr_led_count_dma++;
     
-    // 读取传感器并写入 Ring Buffer
-    sensor_packet_t packet;
-    packet.header[0] = 0xAA;
-    packet.header[1] = 0x55;
-    packet.seq_num = g_seq_num_dma++;
-    packet.timestamp = get_system_tick();
+#if SENSOR_ASYNC_READ
+    // 上一次读取还没完成，跳过本次采样
+    if (icm20608_async_is_busy()) {
+        g_seq_num_dma++;
+        g_sensor_busy_skips_dma++;
+        return;
+    }
+#endif
     
+    // 在 Ring Buffer 空槽内直接构造数据包（零拷贝）
+    uint16_t seq = g_seq_num_dma++;
+    sensor_packet_t *packet = ring_spsc_reserve(&g_ring_buffer_dma);
+    if (packet == NULL) {
+        return;  // Buffer 满，丢弃本次采样
+    }
+    packet->header[0] = 0xAA;
+    packet->header[1] = 0x55;
+    packet->seq_num = seq;
+    packet->timestamp = entry_time;
+    
+#if SENSOR_ASYNC_READ
+    // 只启动 SPI 传输，ISR 立即返回
+    icm20608_async_read(ICM20608_REG_ACCEL_XOUT_H, ICM20608_SENSOR_DATA_LEN,
+                        sensor_read_done_dma, packet);
+#else
     uint32_t read_start = get_system_tick();
-    icm20608_read_data(&packet.accel_x, &packet.accel_y, &packet.accel_z,
-                        &packet.gyro_x, &packet.gyro_y, &packet.gyro_z);
+    icm20608_read_data(&packet->accel_x, &packet->accel_y, &packet->accel_z,
+                        &packet->gyro_x, &packet->gyro_y, &packet->gyro_z);
     uint32_t read_end = get_system_tick();
     
-    packet.process_time_us = read_end - read_start;
-    packet.send_time_us = last_send_time_dma;
-    packet.padding = 0;
-    packet.checksum = calculate_checksum(&packet);
+    packet->process_ticks = read_end - read_start;
+    packet->send_ticks = last_send_time_dma;
+    packet_seal(packet);
+    
+    ring_spsc_commit(&g_ring_buffer_dma);
+#endif
     
-    ring_buffer_dma_write(&packet);
+    perf_stats_isr_record(&g_perf_stats_dma, entry_time);
+}
+
+#if SENSOR_DRDY_MODE
+// DRDY 回调（GPIO 中断上下文）：每次转换完成读一次，不会重复读同一样本
+static void sensor_drdy_dma(uint32_t edge_time, void *param)
+{
+    sensor_sample_dma(edge_time);
+}
+#endif
+
+void gpt1_irq_handler_dma(void)
+{
+    uint32_t entry_time = get_system_tick();
+    
+    timebase_irq_handler();
+    // 只有溢出中断（或 DRDY 模式下没打开的比较中断）：不采样
+    if (!(GPT1->SR & GPT1->IR & (1 << 0))) {
+        return;
+    }
+    GPT1->SR = 1 << 0;
+    
+    // OCR 按截止时刻累加（timebase_periodic_advance），中断延迟不会累积成采样相位漂移
+#if SENSOR_FIFO_MODE
+    // 错过的截止时刻不用补：样本在传感器 FIFO 里，这次一起读出
+    timebase_periodic_advance(&g_sample_timer_dma, entry_time);
+    g_isr_led_count_dma++;
+    
+    // 只启动 FIFO 读取，组包在 ECSPI3 完成回调中进行
+    if (icm20608_async_is_busy()) {
+        g_sensor_busy_skips_dma++;
+        return;
+    }
+    g_fifo_drain_time = entry_time;
+    icm20608_fifo_drain(sensor_fifo_done_dma, NULL);
+#else
+    // 错过的采样点不补读（补读到的也是同一时刻的数据），序号跳过，上位机按丢包统计
+    g_seq_num_dma += timebase_periodic_advance(&g_sample_timer_dma, entry_time) - 1;
+    sensor_sample_dma(entry_time);
+#endif
+}
+
+// ==================== Batch Size ====================
+
+void irq_dma_set_batch_size(uint32_t n)
+{
+    uint32_t capacity = ring_spsc_capacity(&g_ring_buffer_dma);
+
+    if (n == 0) {
+        n = 1;
+    }
+    if (n > BATCH_FRAME_MAX_SAMPLES) {
+        n = BATCH_FRAME_MAX_SAMPLES;
+    }
+    if (n > capacity) {
+        n = capacity;   // 否则永远攒不够
+    }
+    g_batch_size_dma = n;
 }
 
 // ==================== Main Loop (Stage 3: Async UART) ====================
@@ -131,53 +272,235 @@ void irq_dma_loop(void)
     printf("========================================\r\n");
     printf("  Stage 3: IRQ + Ring Buffer + Async TX\r\n");
     printf("========================================\r\n");
+#if SENSOR_DRDY_MODE
+    printf("Sampling rate: %d Hz (ICM20608 DRDY interrupt)\r\n", SENSOR_DRDY_ODR_HZ);
+#elif SENSOR_FIFO_MODE
+    printf("Sampling rate: %d Hz (ICM20608 FIFO, drained every %d ms)\r\n",
+           SENSOR_FIFO_ODR_HZ, SENSOR_FIFO_DRAIN_MS);
+#else
     printf("Sampling rate: %d ms (%d Hz)\r\n", PERIOD_MS, 1000/PERIOD_MS);
-    printf("Buffer size: %d packets\r\n", RING_BUFFER_SIZE);
+#endif
+    printf("Buffer size: %d packets\r\n", DMA_RING_SIZE);
     printf("TX Mode: Asynchronous (Interrupt-driven)\r\n");
+#if SENSOR_BATCH_MODE
+    printf("Frame: batched%s, %d samples/frame (max %d)\r\n",
+           SENSOR_BATCH_COMPRESS ? " + delta/varint" : "",
+           SENSOR_BATCH_DEFAULT, BATCH_FRAME_MAX_SAMPLES);
+#endif
     printf("\r\n");
     
     // 显式初始化全局变量
     g_isr_led_count_dma = 0;
     g_seq_num_dma = 0;
     last_send_time_dma = 0;
+    g_sensor_busy_skips_dma = 0;
+#if SENSOR_BATCH_MODE
+    g_batch_frames_dma = 0;
+    g_batch_bytes_dma = 0;
+#endif
+#if SENSOR_FIFO_MODE
+    g_fifo_drain_time = 0;
+#endif
+    perf_stats_reset(&g_perf_stats_dma);
     
     // 初始化各模块
-    ring_buffer_dma_init();
+    packet_crc_init();
+#if PACKET_CRC_BENCHMARK
+    packet_crc_benchmark();
+#endif
+    ring_spsc_reset(&g_ring_buffer_dma);
+    ring_spsc_set_policy(&g_ring_buffer_dma, RING_BUFFER_POLICY, 0);
+    printf("[DMA] Ring buffer initialized (size=%d, policy=%d)\r\n", DMA_RING_SIZE, RING_BUFFER_POLICY);
+    irq_dma_set_batch_size(SENSOR_BATCH_DEFAULT);
     uart_async_init();    // ← 初始化异步 UART
-    gpt1_timer_dma_init();
+#if SENSOR_COBS_FRAMING
+    uart_async_set_framing(UART_ASYNC_FRAMING_COBS);
+#endif
+#if SENSOR_UART_CHANNELS
+    uart_channel_init();               // ← 之后的文本走日志通道（uart_channel_log）
+#endif
+    uart_async_rx_enable(NULL, NULL);  // ← 中断接收（上位机 → 板子），主循环不阻塞
+#if SENSOR_UART_FLOW_CONTROL
+    uart_async_set_flow_control(true); // ← 上位机 RTS 无效时暂停发送
+#endif
+    link_control_init();               // ← 115200 起步，等上位机协商更高波特率
+#if SENSOR_UART_RELIABLE
+    link_arq_init();                   // ← 上位机 --reliable 时打开选择重传
+#endif
+#if SENSOR_UART_STRIPE
+    link_stripe_init();                // ← UART3 待命，上位机 --stripe 时遥测分到两个 UART
+#endif
+#if SENSOR_ASYNC_READ
+    icm20608_async_init();  // ← 异步 SPI 读取（icm20608_init() 之后）
+#endif
+#if SENSOR_FIFO_MODE
+    icm20608_fifo_config(SENSOR_FIFO_ODR_HZ);  // 阻塞写寄存器，必须在定时器启动前
+#endif
+#if SENSOR_DRDY_MODE
+    icm20608_drdy_init(SENSOR_DRDY_ODR_HZ, sensor_drdy_dma, NULL);
+#endif
+    gpt1_timer_dma_init();   // DRDY 模式下只作时间基准
+#if SENSOR_DRDY_MODE
+    icm20608_drdy_enable();
+#endif
     
-    printf("[DMA] System started. LED will blink every ~500ms.\r\n");
-    printf("[DMA] Sending data to PC (async mode)...\r\n\r\n");
+    uart_channel_log("[DMA] System started. LED will blink every ~500ms.\r\n");
+    uart_channel_log("[DMA] Sending data to PC (async mode)...\r\n\r\n");
     
     uint32_t packets_sent = 0;
     uint32_t last_led_check = 0;
     uint32_t last_stats_time = get_system_tick();
+    uint32_t last_timebase_time = last_stats_time - TIMEBASE_FRAME_PERIOD_TICKS;  // 第一帧马上发
     
     // 主循环
     while(1) {
+        // ===== 任务 0：链路控制（波特率协商 / 回退）=====
+        link_control_poll();
+        if (link_control_tx_allowed()) {
+            uart_channel_poll();    // TX 队列空闲时发出排队的日志（切换波特率期间不发）
+        }
+        
         // ===== 任务 1：异步发送数据 =====
         // 关键改变：uart_async_send() 立即返回，不阻塞！
-        if (ring_buffer_dma_available() > 0 && !uart_async_is_busy()) {
-            sensor_packet_t packet;
-            if (ring_buffer_dma_read(&packet) == 0) {
-                // 测量启动时间（应该非常短，~1μs）
+        // 一次领取回绕点之前所有排队的包，整批只占一个 TX 描述符
+        // UART 卡顿后积压的包也能一次发完，恢复时间只取决于字节数
+        // 不用等上一次发送完成：只要 TX 队列有空位就入队，中断接着上一批发，线路不停顿
+#if SENSOR_BATCH_MODE
+        // 攒够 N 个样本再打成一帧：逐个 peek 写入帧缓冲区后立即归还槽
+        // 遇到 seq 不连续（丢包）或 dt 溢出时提前结束本帧，剩下的留给下一帧
+        uint32_t batch_size = g_batch_size_dma;
+        if (link_control_tx_allowed() && telemetry_tx_ready_dma() &&
+            ring_spsc_available(&g_ring_buffer_dma) >= batch_size) {
+            uint32_t send_start = get_system_tick();
+            sensor_packet_t *pkt;
+            
+            batch_frame_begin(&g_batch_frame, batch_size, SENSOR_BATCH_COMPRESS);
+            while ((pkt = ring_spsc_peek(&g_ring_buffer_dma)) != NULL) {
+                if (batch_frame_add(&g_batch_frame, pkt) != 0) {
+                    break;
+                }
+                ring_spsc_release(&g_ring_buffer_dma);
+            }
+            
+            uint32_t frame_len = batch_frame_finish(&g_batch_frame);
+            int ret = telemetry_send_dma(g_batch_frame.buf, frame_len);
+            uint32_t send_end = get_system_tick();
+            
+            if (ret == 0) {
+                last_send_time_dma = send_end - send_start;  // 含组帧和 CRC 的时间
+                packets_sent += g_batch_frame.count;
+                g_batch_frames_dma++;
+                g_batch_bytes_dma += frame_len;
+            } else {
+                uart_channel_log("[DMA] Warning: async send failed, ret=%d\r\n", ret);
+            }
+        }
+#else
+        // 零拷贝：领取的槽直接交给 UART 中断读取（跳过槽间填充），
+        // 发完后在完成回调里归还，包从 SPI 回调写入槽到进 TX FIFO 之间没有 memcpy
+        // 上限按 COBS 编码后装得进一个描述符计算（COBS 时仍要编码复制）
+        uint32_t count = 0;
+        uint8_t *span = NULL;
+#if SENSOR_UART_RELIABLE
+        // 可靠模式：包要留在重传窗口里等确认，复制进窗口后立即归还槽
+        // 刚打开时可能还有零拷贝发送没完成，等它们归还后再领取（归还按领取顺序）
+        if (link_arq_enabled()) {
+            uint32_t n = 0;
+            uint8_t *pkts = NULL;
+            if (g_ring_buffer_dma.claim == g_ring_buffer_dma.tail && link_arq_window_free() > 0) {
+                pkts = ring_spsc_claim_span(&g_ring_buffer_dma, link_arq_window_free(), &n);
+            }
+            if (pkts != NULL) {
                 uint32_t send_start = get_system_tick();
+                uint32_t k;
                 
-                // 启动异步发送（立即返回！）
-                int ret = uart_async_send((uint8_t*)&packet, sizeof(packet));
-                
-                uint32_t send_end = get_system_tick();
+                for (k = 0; k < n; k++) {
+                    link_arq_send(pkts + k * g_ring_buffer_dma.stride, sizeof(sensor_packet_t));
+                }
+                ring_spsc_release_claimed(&g_ring_buffer_dma, n);
+                last_send_time_dma = get_system_tick() - send_start;
+                packets_sent += n;
+            }
+        } else
+#endif
+#if SENSOR_UART_STRIPE
+        // 条带化：包加上条带头复制进各链路的描述符（每条链路一个），入队后立即归还槽
+        // 刚打开时可能还有零拷贝发送没完成，同样等它们归还后再领取
+        if (link_stripe_enabled()) {
+            uint32_t n = 0;
+            uint32_t room = 0;
+            uint8_t *pkts = NULL;
+            if (link_control_tx_allowed() && g_ring_buffer_dma.claim == g_ring_buffer_dma.tail) {
+                room = link_stripe_tx_room(sizeof(sensor_packet_t));
+            }
+            if (room > 0) {
+                pkts = ring_spsc_claim_span(&g_ring_buffer_dma, room, &n);
+            }
+            if (pkts != NULL) {
+                uint32_t send_start = get_system_tick();
+                int ret = link_stripe_send(pkts, sizeof(sensor_packet_t), g_ring_buffer_dma.stride, n);
                 
                 if (ret == 0) {
-                    // 成功启动
-                    last_send_time_dma = send_end - send_start;  // 应该接近 0
-                    packets_sent++;
+                    ring_spsc_release_claimed(&g_ring_buffer_dma, n);
+                    last_send_time_dma = get_system_tick() - send_start;
+                    packets_sent += n;
                 } else {
-                    // 发送失败（应该不会发生，因为我们检查了 busy）
-                    printf("[DMA] Warning: async send failed, ret=%d\r\n", ret);
+                    ring_spsc_claim_cancel(&g_ring_buffer_dma, n);
+                    uart_channel_log("[DMA] Warning: stripe send failed, ret=%d\r\n", ret);
                 }
-                
-                // ← CPU 立即可以继续，不用等待 4ms！
+            }
+        } else
+#endif
+        if (link_control_tx_allowed() && uart_channel_tx_ready(UART_CHANNEL_TELEMETRY)) {
+            span = ring_spsc_claim_span(&g_ring_buffer_dma,
+                                        UART_ASYNC_TX_BUFFER_SIZE /
+                                        uart_channel_wire_len(sizeof(sensor_packet_t)),
+                                        &count);
+        }
+        if (span != NULL) {
+            // 测量启动时间（应该非常短，~1μs）
+            uint32_t send_start = get_system_tick();
+            
+            // 启动异步发送（立即返回！）
+            int ret = uart_channel_send_ref(UART_CHANNEL_TELEMETRY, span, sizeof(sensor_packet_t),
+                                            g_ring_buffer_dma.stride, count,
+                                            uart_done_release_dma, &g_ring_buffer_dma);
+            
+            uint32_t send_end = get_system_tick();
+            
+            if (ret == 0) {
+                // 成功入队：槽由完成回调归还
+                last_send_time_dma = send_end - send_start;  // 应该接近 0
+                packets_sent += count;
+            } else {
+                // 发送失败（应该不会发生，因为我们检查了队列空位），撤销领取下次重试
+                ring_spsc_claim_cancel(&g_ring_buffer_dma, count);
+                uart_channel_log("[DMA] Warning: async send failed, ret=%d\r\n", ret);
+            }
+            
+            // ← CPU 立即可以继续，不用等待 4ms！
+        }
+#endif
+        
+#if SENSOR_UART_RELIABLE
+        // 可靠模式：窗口里的丢失帧和新帧由这里发出（切换波特率期间不发）
+        if (link_control_tx_allowed()) {
+            link_arq_poll();
+        }
+#endif
+        
+        // ===== 任务 1.5：时间基准帧 =====
+        // 每秒一个 64 位计数，上位机据此还原包里 32 位时间戳的高位；TX 队列忙就下一轮再试
+        if (link_control_tx_allowed() &&
+            get_system_tick() - last_timebase_time >= TIMEBASE_FRAME_PERIOD_TICKS &&
+            uart_channel_tx_ready(UART_CHANNEL_TELEMETRY)) {
+            uint8_t frame[TIMEBASE_FRAME_LEN];
+            uint64_t now = timebase_now64();
+            
+            timebase_frame_build(frame, now);
+            if (uart_channel_send(UART_CHANNEL_TELEMETRY, frame, TIMEBASE_FRAME_LEN) == 0) {
+                last_timebase_time = (uint32_t)now;
+                g_timebase_frames_dma++;
             }
         }
         
@@ -185,20 +508,98 @@ void irq_dma_loop(void)
         // 现在 CPU 有更多空闲时间来处理这个任务
         uint32_t current_count = g_isr_led_count_dma;
         if ((current_count / 10) != (last_led_check / 10)) {
+            // LED 和 ICM20608 CS 同在 GPIO1，读-改-写期间关中断
+            uint32_t cpsr;
+            ICM20608_ASYNC_GPIO_LOCK(cpsr);
             led0_switch();
+            ICM20608_ASYNC_GPIO_UNLOCK(cpsr);
             last_led_check = current_count;
         }
         
         // ===== 任务 3：定期打印统计信息 =====
         // 每 5 秒打印一次（可选，用于调试）
         uint32_t current_time = get_system_tick();
-        if (current_time - last_stats_time > 3225000) {  // 5 秒
+        if (current_time - last_stats_time > timebase_ms_to_ticks(5000)) {
             uart_async_stats_t *stats = uart_async_get_stats();
-            printf("[DMA] Stats: packets=%u, bytes=%u, interrupts=%u, errors=%u\r\n",
-                   stats->total_packets, stats->total_bytes, 
-                   stats->total_interrupts, stats->errors);
-            printf("[DMA] Ring: available=%u, overflow=%u\r\n",
-                   ring_buffer_dma_available(), g_ring_buffer_dma.overflow_count);
+            uart_channel_log("[DMA] Stats: packets=%u, bytes=%u, interrupts=%u, errors=%u\r\n",
+                             stats->total_packets, stats->total_bytes, 
+                             stats->total_interrupts, stats->errors);
+            uart_channel_log("[DMA] TX IRQ: bytes/irq=%u.%02u, max=%u, queue_high_water=%u/%u\r\n",
+                             stats->bytes_per_irq_x100 / 100, stats->bytes_per_irq_x100 % 100,
+                             stats->max_bytes_per_irq, stats->queue_high_water, UART_ASYNC_TX_QUEUE_DEPTH);
+            uart_async_dump_latency(uart_channel_log);  // 排队 / 线路 / 端到端延迟分布，用来调波特率和批量大小
+#if SENSOR_UART_FLOW_CONTROL
+            uart_channel_log("[DMA] Flow: throttled=%u, events=%u, throttled_ms=%u\r\n",
+                             stats->tx_throttled, stats->tx_throttle_events,
+                             timebase_ticks_to_us(stats->tx_throttled_ticks) / 1000);
+#endif
+            uart_channel_log("[DMA] RX: bytes=%u, irqs=%u, idle=%u, overruns=%u, dropped=%u, errors=%u\r\n",
+                             stats->rx_bytes, stats->rx_interrupts, stats->rx_idle_events,
+                             stats->rx_overruns, stats->rx_dropped, stats->rx_errors);
+            link_control_stats_t *link = link_control_get_stats();
+            uart_channel_log("[DMA] Link: baud=%u, frames=%u, bad=%u, switches=%u, rejects=%u, fallbacks=%u\r\n",
+                             link_control_baud(), link->frames, link->bad_frames,
+                             link->switches, link->rejects, link->fallbacks);
+#if SENSOR_UART_RELIABLE
+            link_arq_stats_t *arq = link_arq_get_stats();
+            uart_channel_log("[DMA] ARQ: %s, frames=%u, retransmits=%u, timeouts=%u, abandoned=%u, acks=%u, rto=%ums, window_full=%u, high_water=%u/%u, fallbacks=%u\r\n",
+                             link_arq_enabled() ? "on" : "off", arq->frames, arq->retransmits,
+                             arq->timeouts, arq->abandoned, arq->acks, arq->rto / LINK_TICKS_PER_MS,
+                             arq->window_full, arq->window_high_water, LINK_ARQ_WINDOW, arq->fallbacks);
+#endif
+#if SENSOR_UART_STRIPE
+            link_stripe_stats_t *stripe = link_stripe_get_stats();
+            uart_async_stats_t *link1 = uart_async_port_get_stats(link_stripe_port(1));
+            uart_channel_log("[DMA] Stripe: %s, frames=%u/%u, bytes=%u/%u, stalls=%u, link1 queue_high_water=%u/%u, link1 errors=%u\r\n",
+                             link_stripe_enabled() ? "on" : "off", stripe->frames[0], stripe->frames[1],
+                             stripe->bytes[0], stripe->bytes[1], stripe->stalls,
+                             link1->queue_high_water, UART_ASYNC_TX_QUEUE_DEPTH, link1->errors);
+#endif
+#if SENSOR_UART_CHANNELS
+            uart_channel_stats_t *chan = uart_channel_get_stats();
+            uart_channel_log("[DMA] Channels: frames ctl/tlm/log=%u/%u/%u, busy=%u/%u/%u, log_dropped=%u, log_high_water=%u/%u\r\n",
+                             chan->frames[UART_CHANNEL_CONTROL], chan->frames[UART_CHANNEL_TELEMETRY],
+                             chan->frames[UART_CHANNEL_LOG], chan->busy[UART_CHANNEL_CONTROL],
+                             chan->busy[UART_CHANNEL_TELEMETRY], chan->busy[UART_CHANNEL_LOG],
+                             chan->log_dropped, chan->log_high_water, UART_CHANNEL_LOG_BUFFER_SIZE);
+#endif
+            uart_channel_log("[DMA] Ring: available=%u, overflow=%u, high_water=%u/%u, full_ticks=%u, torn=%u\r\n",
+                             ring_spsc_available(&g_ring_buffer_dma), g_ring_buffer_dma.overflow_count,
+                             g_ring_buffer_dma.high_water, DMA_RING_SIZE,
+                             g_ring_buffer_dma.time_at_full, g_ring_buffer_dma.torn_count);
+#if !SENSOR_DRDY_MODE
+            timebase_interval_t *timer = &g_sample_timer_dma.stats;
+            uart_channel_log("[DMA] Timer: count=%u, missed=%u, interval_err min/max/mean=%d/%d/%d ticks, mean_abs=%u ticks, latency_max=%u ticks\r\n",
+                             timer->count, timer->missed,
+                             timer->err_count ? timer->err_min : 0,
+                             timer->err_count ? timer->err_max : 0,
+                             timer->err_count ? timer->err_sum / (int32_t)timer->err_count : 0,
+                             timer->err_count ? timer->err_abs_sum / timer->err_count : 0,
+                             timer->latency_max);
+#endif
+            uart_channel_log("[DMA] Timebase: wraps=%u, cnt=%u, frames=%u\r\n",
+                             timebase_wraps(), get_system_tick(), g_timebase_frames_dma);
+            uart_channel_log("[DMA] ISR: count=%u, max=%u ticks, avg=%u ticks, sensor_skips=%u\r\n",
+                             g_perf_stats_dma.isr_count, g_perf_stats_dma.max_isr_time,
+                             g_perf_stats_dma.isr_count ? g_perf_stats_dma.total_isr_time / g_perf_stats_dma.isr_count : 0,
+                             g_sensor_busy_skips_dma);
+#if SENSOR_BATCH_MODE
+            uart_channel_log("[DMA] Batch: frames=%u, samples=%u, size=%u, bytes/sample=%u.%02u\r\n",
+                             g_batch_frames_dma, packets_sent, g_batch_size_dma,
+                             packets_sent ? g_batch_bytes_dma / packets_sent : 0,
+                             packets_sent ? (g_batch_bytes_dma * 100 / packets_sent) % 100 : 0);
+#endif
+#if SENSOR_DRDY_MODE
+            icm20608_async_stats_t *icm = icm20608_async_get_stats();
+            uart_channel_log("[DMA] DRDY: edges=%u, max_latency=%u ticks\r\n",
+                             icm->drdy_edges, icm->drdy_max_latency);
+#endif
+#if SENSOR_FIFO_MODE
+            icm20608_async_stats_t *icm = icm20608_async_get_stats();
+            uart_channel_log("[DMA] FIFO: drains=%u, records=%u, max_batch=%u, overflows=%u\r\n",
+                             icm->fifo_drains, icm->fifo_records,
+                             icm->fifo_max_records, icm->fifo_overflows);
+#endif
             last_stats_time = current_time;
         }
         
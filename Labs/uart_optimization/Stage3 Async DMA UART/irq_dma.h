@@ -11,23 +11,107 @@
 
 // ==================== Configuration ====================
 
-// Ring Buffer 配置（与 Stage 2 相同）
-#define RING_BUFFER_SIZE    16      // 16 个数据包（2的幂次）
-#define PERIOD_MS           50      // 采样周期：50ms = 20Hz
-#define PERIOD_TICKS        32250   // 50ms * 645kHz = 32250 ticks
+// Ring Buffer 配置与 Stage 2 相同（RING_BUFFER_SIZE / PERIOD_MS / PERIOD_TICKS 见 irq_ringbuffer.h）
 
-extern ring_buffer_t g_ring_buffer;
+// FIFO 突发模式：ICM20608 以 SENSOR_FIFO_ODR_HZ 采样写入自身 FIFO，
+// GPT1 每 SENSOR_FIFO_DRAIN_MS 读空一次，每个样本仍然是一个 sensor_packet_t
+// ICM20608 没有 FIFO 水位中断，所以用定时读取代替
+// 注意：1kHz x 30 字节 = 30KB/s，超过 115200 波特率的带宽，需要配合更高波特率
+#ifndef SENSOR_FIFO_MODE
+#define SENSOR_FIFO_MODE            0
+#endif
+
+#if SENSOR_FIFO_MODE && !SENSOR_ASYNC_READ
+#error "SENSOR_FIFO_MODE requires SENSOR_ASYNC_READ"
+#endif
+
+#define SENSOR_FIFO_ODR_HZ          1000
+#define SENSOR_FIFO_DRAIN_MS        20
+#define SENSOR_FIFO_SAMPLE_TICKS    (timebase_rate_hz() / SENSOR_FIFO_ODR_HZ)   // 样本间隔（GPT1 tick）
+#define SENSOR_FIFO_DRAIN_TICKS     timebase_ms_to_ticks(SENSOR_FIFO_DRAIN_MS)
+
+// DRDY 模式：ICM20608 INT 引脚（GPIO 中断）驱动采样，时间戳在中断边沿锁存
+// GPT1 仍然自由运行作为时间基准，但不再产生比较中断
+#ifndef SENSOR_DRDY_MODE
+#define SENSOR_DRDY_MODE            0
+#endif
+
+#if SENSOR_DRDY_MODE && (!SENSOR_ASYNC_READ || SENSOR_FIFO_MODE)
+#error "SENSOR_DRDY_MODE requires SENSOR_ASYNC_READ and excludes SENSOR_FIFO_MODE"
+#endif
+
+// 启动时打印 CRC / 累加和的周期数对比（PMU 周期计数器）
+#ifndef PACKET_CRC_BENCHMARK
+#define PACKET_CRC_BENCHMARK        0
+#endif
+
+// 批量帧：主循环攒够 N 个样本打成一帧发送（格式见 batch_frame.h）
+// 每个样本 14 字节（单包 30 字节），115200 波特率下可支持的采样率约翻一倍
+// N 可在运行时用 irq_dma_set_batch_size() 修改
+#ifndef SENSOR_BATCH_MODE
+#define SENSOR_BATCH_MODE           0
+#endif
+#define SENSOR_BATCH_DEFAULT        8
+
+// 批量帧压缩：差分 + zigzag + varint（每帧第一个样本为关键帧），安静信号下每样本约 7 字节
+#ifndef SENSOR_BATCH_COMPRESS
+#define SENSOR_BATCH_COMPRESS       0
+#endif
+
+// COBS 帧：每个包 / 批量帧编码成一个 COBS 帧（0x00 结尾），上位机 --framing cobs
+// 每个 30 字节单包多 2 字节，帧边界不会和数据混淆
+#ifndef SENSOR_COBS_FRAMING
+#define SENSOR_COBS_FRAMING         0
+#endif
+
+// RTS/CTS 硬件流控：上位机来不及收时暂停发送，积压传回采样 Ring（overflow_count），
+// 而不是在线路上悄悄丢字节；上位机用 generic_receiver.py --rtscts
+#ifndef SENSOR_UART_FLOW_CONTROL
+#define SENSOR_UART_FLOW_CONTROL    0
+#endif
+
+// 逻辑通道（bsp_uart_channel.h）：遥测 / 日志 / 控制应答各带标签，COBS 分帧，上位机 --framing cobs 分流
+// 运行期的统计信息走日志通道，不再插进二进制帧中间
+#ifndef SENSOR_UART_CHANNELS
+#define SENSOR_UART_CHANNELS        0
+#endif
+
+// 可靠模式（link_arq.h）：上位机 --reliable 打开后，遥测帧带 ARQ 序号留在重传窗口里，
+// 上位机回 ACK，板子只重发丢失的帧；上位机不回 ACK 时自动回到尽力而为
+#ifndef SENSOR_UART_RELIABLE
+#define SENSOR_UART_RELIABLE        0
+#endif
+
+#if SENSOR_UART_RELIABLE && !SENSOR_COBS_FRAMING && !SENSOR_UART_CHANNELS
+#error "SENSOR_UART_RELIABLE requires SENSOR_COBS_FRAMING or SENSOR_UART_CHANNELS"
+#endif
+
+// 条带化（link_stripe.h）：上位机 --stripe PORT2 打开后，遥测帧轮流走 UART1 和 UART3，
+// 各链路独立编号，上位机按序合并，原始带宽翻倍；控制应答和日志仍只走 UART1
+#ifndef SENSOR_UART_STRIPE
+#define SENSOR_UART_STRIPE          0
+#endif
+
+#if SENSOR_UART_STRIPE && ((!SENSOR_COBS_FRAMING && !SENSOR_UART_CHANNELS) || SENSOR_UART_RELIABLE)
+#error "SENSOR_UART_STRIPE requires SENSOR_COBS_FRAMING or SENSOR_UART_CHANNELS and excludes SENSOR_UART_RELIABLE"
+#endif
+
+#define SENSOR_DRDY_ODR_HZ          (1000 / PERIOD_MS)  // 与定时器模式相同的采样率
+
+#if SENSOR_FIFO_MODE
+#define SAMPLE_TIMER_TICKS          SENSOR_FIFO_DRAIN_TICKS
+#define DMA_RING_SIZE               64      // 每次读出约 20 个样本
+#else
+#define SAMPLE_TIMER_TICKS          PERIOD_TICKS
+#define DMA_RING_SIZE               RING_BUFFER_SIZE
+#endif
+
+extern ring_spsc_t g_ring_buffer_dma;
+extern performance_stats_t g_perf_stats_dma;
 extern uint32_t g_isr_led_count;
 
 // ==================== Function Declarations ====================
 
-// Ring Buffer 管理（DMA 版本，加后缀避免冲突）
-void ring_buffer_dma_init(void);
-uint32_t ring_buffer_dma_available(void);
-uint32_t ring_buffer_dma_free_space(void);
-int ring_buffer_dma_write(sensor_packet_t *packet);
-int ring_buffer_dma_read(sensor_packet_t *packet);
-
 // GPT1 定时器（DMA 版本，加后缀避免冲突）
 void gpt1_timer_dma_init(void);
 void gpt1_irq_handler_dma(void);
@@ -35,4 +119,7 @@ void gpt1_irq_handler_dma(void);
 // Stage 3 主循环
 void irq_dma_loop(void);
 
+// 批量帧样本数（1 ~ min(BATCH_FRAME_MAX_SAMPLES, Ring 容量)，超出范围时截断）
+void irq_dma_set_batch_size(uint32_t n);
+
 #endif // _IRQ_DMA_H
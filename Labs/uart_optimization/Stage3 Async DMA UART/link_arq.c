@@ -0,0 +1,338 @@
+#include "link_arq.h"
+#include "link_control.h"
+#include "packet_crc.h"
+#include "../bsp/uart/bsp_uart_channel.h"
+#include "../stdio/include/string.h"
+
+// ==================== Private Variables ====================
+
+typedef enum {
+    ARQ_SLOT_QUEUED = 0,        // 在窗口里，还没发过
+    ARQ_SLOT_SENT,              // 已发出，等确认
+    ARQ_SLOT_LOST,              // 判定丢失，等重传
+    ARQ_SLOT_DONE,              // 已确认（或已放弃），等窗口前移
+} arq_slot_state_t;
+
+typedef struct {
+    uint8_t state;              // arq_slot_state_t
+    uint8_t retries;            // 已重传次数
+    uint16_t len;               // 整帧字节数（含序号头和 CRC）
+    uint32_t sent_at;           // 最近一次发出的时间
+    uint32_t tx_order;          // 最近一次发出的发送顺序号
+    uint32_t first_order;       // 第一次发出的发送顺序号
+    uint8_t frame[LINK_ARQ_FRAME_MAX];
+} arq_slot_t;
+
+static arq_slot_t arq_slots[LINK_ARQ_WINDOW];
+
+static bool arq_available;      // link_arq_init() 之后才接受 ARQ 命令
+static bool arq_enabled;
+
+// 序号都是自由递增的 32 位计数，线上只带低 16 位
+static uint32_t arq_base;       // 最早的未确认帧
+static uint32_t arq_send_next;  // 下一个第一次发送的帧
+static uint32_t arq_next;       // 下一个进入窗口的帧
+static uint32_t arq_tx_order;   // 每发出一帧（含重传）+1
+static uint32_t arq_last_ack;   // 上一次收到 ACK（或打开可靠模式）的时间
+static uint32_t arq_rto_at;     // 上一次超时重传的时间（超时后重新计时）
+static uint32_t arq_srtt;       // 平滑往返时间（tick），0 = 还没有采样
+static uint32_t arq_rttvar;     // 往返时间的平均偏差（tick）
+static bool arq_full;           // 上一次查询时窗口是否已满
+
+static link_arq_stats_t arq_stats;
+
+// ==================== Private Functions ====================
+
+static arq_slot_t *arq_slot(uint32_t seq)
+{
+    return &arq_slots[seq & (LINK_ARQ_WINDOW - 1)];
+}
+
+// 线上的 16 位序号还原成窗口附近的 32 位序号
+static uint32_t arq_unwrap(uint16_t seq)
+{
+    return arq_base + (uint32_t)(int32_t)(int16_t)(seq - (uint16_t)arq_base);
+}
+
+static void arq_reset(void)
+{
+    arq_base = 0;
+    arq_send_next = 0;
+    arq_next = 0;
+    arq_tx_order = 0;
+    arq_last_ack = LINK_CONTROL_NOW();
+    arq_rto_at = arq_last_ack;
+    arq_srtt = 0;
+    arq_rttvar = 0;
+    arq_stats.rto = LINK_ARQ_RTO_MAX_MS * LINK_TICKS_PER_MS;
+    arq_full = false;
+}
+
+// 往返时间采样（RFC 6298 的整数版本：srtt 增益 1/8，rttvar 增益 1/4）
+static void arq_rtt_sample(uint32_t rtt)
+{
+    uint32_t rto;
+
+    if (arq_srtt == 0) {
+        arq_srtt = rtt;
+        arq_rttvar = rtt / 2;
+    } else {
+        uint32_t err = (rtt > arq_srtt) ? rtt - arq_srtt : arq_srtt - rtt;
+        arq_rttvar = arq_rttvar - arq_rttvar / 4 + err / 4;
+        arq_srtt = arq_srtt - arq_srtt / 8 + rtt / 8;
+    }
+
+    rto = arq_srtt + 4 * arq_rttvar;
+    if (rto < LINK_ARQ_RTO_MIN_MS * LINK_TICKS_PER_MS) {
+        rto = LINK_ARQ_RTO_MIN_MS * LINK_TICKS_PER_MS;
+    }
+    if (rto > LINK_ARQ_RTO_MAX_MS * LINK_TICKS_PER_MS) {
+        rto = LINK_ARQ_RTO_MAX_MS * LINK_TICKS_PER_MS;
+    }
+    arq_stats.rto = rto;
+}
+
+// 确认一帧，返回它第一次的发送顺序号（已确认过返回 0）
+// 重传过的帧不知道是哪一次到的，只能保证第一次发出之前的帧都已经过了线路，按它判丢才不会误判
+// *rtt 取没重传过的帧里最长的往返时间：同一个 ACK 确认的最早那帧包含了上位机攒 ACK 的延迟，
+// 按它算 RTO 才不会提前超时；重传过的帧分不清确认的是哪一次，不采样
+static uint32_t arq_ack_slot(uint32_t seq, uint32_t now, uint32_t *rtt)
+{
+    arq_slot_t *slot = arq_slot(seq);
+
+    if (slot->state != ARQ_SLOT_SENT && slot->state != ARQ_SLOT_LOST) {
+        return 0;
+    }
+    slot->state = ARQ_SLOT_DONE;
+    if (slot->retries == 0 && now - slot->sent_at > *rtt) {
+        *rtt = now - slot->sent_at;
+    }
+    return slot->first_order;
+}
+
+static void arq_mark_lost(arq_slot_t *slot)
+{
+    if (slot->retries >= LINK_ARQ_MAX_RETRIES) {
+        slot->state = ARQ_SLOT_DONE;    // 放弃：上位机收到更新的帧后会跳过这个空洞
+        arq_stats.abandoned++;
+        return;
+    }
+    slot->state = ARQ_SLOT_LOST;
+}
+
+// 窗口前移：跳过开头已确认 / 已放弃的帧
+static void arq_advance(void)
+{
+    while (arq_base != arq_send_next && arq_slot(arq_base)->state == ARQ_SLOT_DONE) {
+        arq_base++;
+    }
+}
+
+// 找最早的待重传帧，没有时返回 arq_send_next（下一个新帧；等于 arq_next 时没有可发的）
+static uint32_t arq_find_lost(void)
+{
+    uint32_t seq;
+
+    for (seq = arq_base; seq != arq_send_next; seq++) {
+        if (arq_slot(seq)->state == ARQ_SLOT_LOST) {
+            break;
+        }
+    }
+    return seq;
+}
+
+// ==================== Public Functions ====================
+
+void link_arq_init(void)
+{
+    memset(&arq_stats, 0, sizeof(arq_stats));
+    arq_reset();
+    arq_enabled = false;
+    arq_available = true;
+}
+
+uint32_t link_arq_enable(uint32_t enable)
+{
+    if (!arq_available) {
+        return 0;
+    }
+    if (!enable) {
+        arq_enabled = false;
+        return 0;
+    }
+    // 已经打开时只重发应答：上位机没收到应答而重发命令时，不能把序号清零
+    if (!arq_enabled) {
+        arq_reset();
+        arq_enabled = true;
+        uart_channel_log("[ARQ] reliable mode on, window=%d\r\n", LINK_ARQ_WINDOW);
+    }
+    return LINK_ARQ_WINDOW;
+}
+
+int link_arq_enabled(void)
+{
+    return arq_enabled;
+}
+
+void link_arq_on_ack(uint16_t next, uint16_t sack)
+{
+    uint32_t now = LINK_CONTROL_NOW();
+    uint32_t ack = arq_unwrap(next);
+    uint32_t newest = 0;    // 本次确认的帧里最晚的（第一次）发送顺序号
+    uint32_t rtt = 0;       // 本次确认的、没重传过的帧里最长的往返时间
+    uint32_t order, seq, i;
+
+    if (!arq_enabled) {
+        return;
+    }
+    arq_stats.acks++;
+    arq_last_ack = now;
+
+    // 1. 累积确认：ack 之前的帧全部收到（ack 落在窗口之前说明上位机还没跳过已放弃的帧）
+    if ((int32_t)(ack - arq_base) > 0 && ack - arq_base <= arq_send_next - arq_base) {
+        for (seq = arq_base; seq != ack; seq++) {
+            order = arq_ack_slot(seq, now, &rtt);
+            if (order > newest) {
+                newest = order;
+            }
+        }
+    }
+
+    // 2. 选择确认
+    for (i = 0; i < 16; i++) {
+        if (!(sack & (1u << i))) {
+            continue;
+        }
+        seq = arq_unwrap((uint16_t)(next + 1 + i));
+        if (seq - arq_base < arq_send_next - arq_base) {
+            order = arq_ack_slot(seq, now, &rtt);
+            if (order > newest) {
+                newest = order;
+            }
+        }
+    }
+
+    if (rtt != 0) {
+        arq_rtt_sample(rtt);
+    }
+
+    // 3. 快速重传：比已确认帧更早发出、却还没确认的帧已经丢了
+    //    只判这个 ACK 覆盖的范围（next+16 之前），更后面的帧收没收到不知道
+    for (seq = arq_base; seq != arq_send_next && (int32_t)(seq - ack) <= 16; seq++) {
+        arq_slot_t *slot = arq_slot(seq);
+        if (slot->state == ARQ_SLOT_SENT && slot->tx_order < newest) {
+            arq_mark_lost(slot);
+        }
+    }
+
+    arq_advance();
+}
+
+uint32_t link_arq_window_free(void)
+{
+    uint32_t free = LINK_ARQ_WINDOW - (arq_next - arq_base);
+
+    if (free == 0 && !arq_full) {
+        arq_stats.window_full++;
+    }
+    arq_full = (free == 0);
+    return free;
+}
+
+int link_arq_send(const uint8_t *payload, uint32_t len)
+{
+    arq_slot_t *slot;
+    uint16_t crc;
+
+    if (payload == NULL || len == 0 || len > LINK_ARQ_PAYLOAD_MAX) {
+        return -2;
+    }
+    if (arq_next - arq_base >= LINK_ARQ_WINDOW) {
+        return -1;
+    }
+
+    slot = arq_slot(arq_next);
+    slot->frame[0] = LINK_ARQ_HEADER0;
+    slot->frame[1] = LINK_ARQ_HEADER1;
+    slot->frame[2] = (uint8_t)(arq_next & 0xFF);
+    slot->frame[3] = (uint8_t)((arq_next >> 8) & 0xFF);
+    memcpy(&slot->frame[LINK_ARQ_HEAD_LEN], payload, len);
+    crc = crc16_ccitt(slot->frame, LINK_ARQ_HEAD_LEN + len);
+    slot->frame[LINK_ARQ_HEAD_LEN + len] = (uint8_t)(crc >> 8);
+    slot->frame[LINK_ARQ_HEAD_LEN + len + 1] = (uint8_t)(crc & 0xFF);
+    slot->len = (uint16_t)(LINK_ARQ_HEAD_LEN + len + LINK_ARQ_CRC_LEN);
+    slot->retries = 0;
+    slot->state = ARQ_SLOT_QUEUED;
+    arq_next++;
+
+    arq_stats.frames++;
+    if (arq_next - arq_base > arq_stats.window_high_water) {
+        arq_stats.window_high_water = arq_next - arq_base;
+    }
+    return 0;
+}
+
+void link_arq_poll(void)
+{
+    uint32_t now = LINK_CONTROL_NOW();
+    uint32_t seq;
+
+    if (!arq_enabled) {
+        return;
+    }
+
+    // 1. 上位机没有回应：清空窗口，回到尽力而为
+    if (arq_base != arq_send_next &&
+        now - arq_last_ack > LINK_ARQ_ACK_TIMEOUT_MS * LINK_TICKS_PER_MS) {
+        arq_stats.fallbacks++;
+        arq_enabled = false;
+        uart_channel_log("[ARQ] no ACK for %d ms, back to best effort (%u frames dropped)\r\n",
+                         LINK_ARQ_ACK_TIMEOUT_MS, arq_next - arq_base);
+        return;
+    }
+
+    // 2. 超时重传：只看最早的未确认帧，判丢后重新计时
+    //    后面的帧多半已经到了，只是超出了 sack 的 16 帧范围，空洞补上后会被累积确认
+    for (seq = arq_base; seq != arq_send_next; seq++) {
+        arq_slot_t *slot = arq_slot(seq);
+        if (slot->state != ARQ_SLOT_SENT) {
+            continue;
+        }
+        if (now - slot->sent_at > arq_stats.rto && now - arq_rto_at > arq_stats.rto) {
+            arq_stats.timeouts++;
+            arq_rto_at = now;
+            arq_mark_lost(slot);
+            arq_advance();
+        }
+        break;
+    }
+
+    // 3. 先补最早的丢失帧，再发新帧；遥测通道给控制应答留描述符
+    while (uart_channel_tx_ready(UART_CHANNEL_TELEMETRY)) {
+        arq_slot_t *slot;
+
+        seq = arq_find_lost();
+        if (seq == arq_next) {
+            break;
+        }
+        slot = arq_slot(seq);
+        if (uart_channel_send(UART_CHANNEL_TELEMETRY, slot->frame, slot->len) != 0) {
+            break;
+        }
+        slot->tx_order = ++arq_tx_order;
+        if (seq == arq_send_next) {
+            slot->first_order = slot->tx_order;
+            arq_send_next++;
+        } else {
+            slot->retries++;
+            arq_stats.retransmits++;
+        }
+        slot->state = ARQ_SLOT_SENT;
+        slot->sent_at = now;
+    }
+}
+
+link_arq_stats_t *link_arq_get_stats(void)
+{
+    return &arq_stats;
+}
@@ -0,0 +1,90 @@
+#ifndef __LINK_ARQ_H
+#define __LINK_ARQ_H
+
+#include "../stdio/include/types.h"
+#include "batch_frame.h"
+// ==================== 链路可靠模式：选择重传 ====================
+// 尽力而为模式下，线路错误 / 校验失败的帧直接丢掉，上位机只能看到 seq 断档
+// 可靠模式：每个遥测帧带一个 ARQ 序号，发出后留在重传窗口里，上位机经 RX 回 ACK，
+// 只重发确认丢失的帧；窗口（最多 LINK_ARQ_WINDOW 帧未确认）限制缓存大小，
+// 干净线路上 ACK 持续推进窗口，吞吐与尽力而为模式相同
+//
+// 需要 COBS 分帧（SENSOR_COBS_FRAMING 或 SENSOR_UART_CHANNELS），上位机 --framing cobs --reliable
+//
+//   上位机                              板子
+//   ARQ(1)                    ──→       打开可靠模式，序号从 0 开始
+//                             ←──       ARQ|0x80(窗口大小)（0 = 固件没打开 SENSOR_UART_RELIABLE）
+//                             ←──       DATA(0) DATA(1) DATA(2) ...
+//   ACK(next=1, sack=0b10)    ──→       1 丢了、2 / 3 到了：只重发 1
+//
+// 数据帧（遥测通道的一个 COBS 帧）：
+//   偏移  长度  内容
+//   0     2     0xAA 0x52
+//   2     2     ARQ 序号（小端，每帧 +1，与样本 seq 无关）
+//   4     n     负载：单包 / 批量帧 / 压缩批量帧（原样）
+//   4+n   2     CRC-16/CCITT-FALSE（覆盖前面所有字节，高字节在前）
+//
+// ACK（link_control 控制帧 LINK_CMD_ACK，参数 32 位，不应答）：
+//   bit 0~15   next：下一个期望的序号，之前的帧全部收到（累积确认）
+//   bit 16~31  sack：bit i = 1 表示 next+1+i 已经收到（选择确认，next 本身必然缺失）
+//
+// 板子侧：
+// - 快速重传：UART 不会乱序，比某帧晚发出的帧已被确认，而它还没有确认，它就丢了
+//   （按发送顺序号判断，重传过的帧不会被更早帧的确认再次判丢）
+// - 超时重传：最早的未确认帧发出一个 RTO 还没确认（ACK 丢失 / 重传又丢 / 窗口尾部丢失），
+//   每次只判这一帧、之后重新计时，超出 sack 范围的帧不会一起超时重发
+// - RTO 按实测往返时间自适应（srtt + 4 x rttvar，只用没重传过的帧采样），
+//   限制在 LINK_ARQ_RTO_MIN_MS ~ LINK_ARQ_RTO_MAX_MS，上位机 USB 延迟小时空洞补得更快
+// - 一帧重传 LINK_ARQ_MAX_RETRIES 次仍未确认时放弃，窗口照常前移
+// - 有未确认的帧却 LINK_ARQ_ACK_TIMEOUT_MS 没收到任何 ACK（上位机退出）：清空窗口，回到尽力而为
+// - 窗口满时遥测留在 Ring Buffer 里，积压过多按 Ring 的满策略丢弃（overflow_count）
+// 上位机侧：空洞等待超过 2 秒、或收到的序号超出空洞一个窗口时（板子已放弃）跳过，计为丢失
+
+#define LINK_ARQ_HEADER0            0xAA
+#define LINK_ARQ_HEADER1            0x52
+#define LINK_ARQ_HEAD_LEN           4
+#define LINK_ARQ_CRC_LEN            2
+#define LINK_ARQ_PAYLOAD_MAX        BATCH_FRAME_MAX_LEN     // 最大的遥测帧
+#define LINK_ARQ_FRAME_MAX          (LINK_ARQ_HEAD_LEN + LINK_ARQ_PAYLOAD_MAX + LINK_ARQ_CRC_LEN)
+
+// 窗口大小（2 的幂）：921600 下 64 个单包约 27ms，大于上位机 ACK 往返时间
+// 占用 64 x 约 480 字节 ≈ 30KB（按最大批量帧分配）
+#ifndef LINK_ARQ_WINDOW
+#define LINK_ARQ_WINDOW             64
+#endif
+
+#if (LINK_ARQ_WINDOW & (LINK_ARQ_WINDOW - 1)) != 0 || LINK_ARQ_WINDOW > 32768
+#error "LINK_ARQ_WINDOW must be a power of 2 and at most 32768"
+#endif
+
+#define LINK_ARQ_RTO_MIN_MS         50      // 上位机 USB 延迟有抖动，太小会误判超时
+#define LINK_ARQ_RTO_MAX_MS         200     // 也是还没有采样时的初值
+#define LINK_ARQ_MAX_RETRIES        8
+#define LINK_ARQ_ACK_TIMEOUT_MS     3000
+
+// ==================== Data Structures ====================
+
+typedef struct {
+    uint32_t frames;            // 进入窗口的新帧
+    uint32_t retransmits;       // 重传次数（快速 + 超时）
+    uint32_t timeouts;          // 超时判丢次数
+    uint32_t abandoned;         // 超过重传上限放弃的帧
+    uint32_t acks;              // 收到的 ACK
+    uint32_t window_full;       // 窗口满、遥测留在 Ring 里的次数
+    uint32_t window_high_water; // 窗口最大占用帧数
+    uint32_t fallbacks;         // 没有 ACK、退回尽力而为的次数
+    uint32_t rto;               // 当前 RTO（GPT1 tick）
+} link_arq_stats_t;
+
+// ==================== Function Declarations ====================
+
+void link_arq_init(void);                       // 允许上位机打开可靠模式（不调用时 ARQ 命令应答 0）
+uint32_t link_arq_enable(uint32_t enable);      // ARQ 命令：1=打开 / 0=关闭，返回应答参数（窗口大小，不支持时 0）
+int link_arq_enabled(void);                     // 1=遥测走 link_arq_send()
+void link_arq_on_ack(uint16_t next, uint16_t sack);  // ACK 命令（link_control_poll() 里调用）
+uint32_t link_arq_window_free(void);            // 窗口还能放几帧
+int link_arq_send(const uint8_t *payload, uint32_t len);  // 复制进窗口，0=成功，-1=窗口满，-2=参数错误
+void link_arq_poll(void);                       // 主循环每轮调用（切换波特率期间不调用）：判丢、重传、发新帧
+link_arq_stats_t *link_arq_get_stats(void);
+
+#endif // __LINK_ARQ_H
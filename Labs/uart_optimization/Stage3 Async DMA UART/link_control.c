@@ -0,0 +1,246 @@
+#include "link_control.h"
+#include "link_arq.h"
+#include "link_stripe.h"
+#include "packet_crc.h"
+#include "../imx6ul/imx6ul.h"
+#include "../bsp/uart/bsp_uart_async.h"
+#include "../bsp/uart/bsp_uart_channel.h"
+
+// ==================== Private Variables ====================
+
+typedef enum {
+    LINK_STATE_RUNNING = 0,     // 正常发送遥测
+    LINK_STATE_SWITCHING,       // 等 TX 发空后切换分频（不发遥测）
+    LINK_STATE_CONFIRM,         // 已切换，等上位机在新波特率下发 PING
+} link_state_t;
+
+// 支持的波特率（80MHz 参考时钟下都能整除）
+static const uint32_t link_bauds[] = { 115200, 460800, 921600, 3000000 };
+
+static link_state_t link_state;
+static uint32_t link_pending_baud;      // SWITCHING：要切到的波特率
+static uint32_t link_state_since;       // 进入当前状态的时间
+static uint32_t link_last_ping;         // 上一次收到 PING 的时间
+static uint32_t link_err_window;        // 错误计数窗口起点
+static uint32_t link_err_base;          // 窗口起点的 RX 错误 + 溢出计数
+
+// 控制帧接收
+static uint8_t link_rx_frame[LINK_FRAME_LEN];
+static uint32_t link_rx_len;
+
+static link_control_stats_t link_stats;
+
+// ==================== Private Functions ====================
+
+static uint32_t link_rx_error_count(void)
+{
+    uart_async_stats_t *st = uart_async_get_stats();
+    return st->rx_errors + st->rx_overruns;
+}
+
+static int link_baud_supported(uint32_t baud)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(link_bauds) / sizeof(link_bauds[0]); i++) {
+        if (link_bauds[i] == baud) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int link_send_reply(uint8_t cmd, uint32_t arg)
+{
+    uint8_t frame[LINK_FRAME_LEN];
+    uint16_t crc;
+
+    frame[0] = LINK_FRAME_HEADER0;
+    frame[1] = LINK_FRAME_HEADER1;
+    frame[2] = cmd | LINK_CMD_REPLY;
+    frame[3] = (uint8_t)(arg & 0xFF);
+    frame[4] = (uint8_t)((arg >> 8) & 0xFF);
+    frame[5] = (uint8_t)((arg >> 16) & 0xFF);
+    frame[6] = (uint8_t)(arg >> 24);
+    crc = crc16_ccitt(frame, 7);
+    frame[7] = (uint8_t)(crc >> 8);
+    frame[8] = (uint8_t)(crc & 0xFF);
+
+    return uart_channel_send(UART_CHANNEL_CONTROL, frame, LINK_FRAME_LEN);
+}
+
+// 开始切换：停发遥测，等 TX 发空后在 link_control_poll() 里改分频
+static void link_begin_switch(uint32_t baud, uint32_t now)
+{
+    link_pending_baud = baud;
+    link_state = LINK_STATE_SWITCHING;
+    link_state_since = now;
+}
+
+static void link_fallback(uint32_t now, const char *reason)
+{
+    link_stats.fallbacks++;
+    link_begin_switch(UART_ASYNC_BAUD_DEFAULT, now);
+    uart_channel_log("[LINK] fallback to %d (%s)\r\n", UART_ASYNC_BAUD_DEFAULT, reason);
+}
+
+static void link_handle_frame(const uint8_t *frame, uint32_t now)
+{
+    uint8_t cmd = frame[2];
+    uint32_t arg = (uint32_t)frame[3] | ((uint32_t)frame[4] << 8) |
+                   ((uint32_t)frame[5] << 16) | ((uint32_t)frame[6] << 24);
+
+    link_stats.frames++;
+
+    if (cmd == LINK_CMD_BAUD) {
+        if (link_state == LINK_STATE_SWITCHING) {
+            return;     // 上一次切换还没完成，上位机会重发
+        }
+        if (!link_baud_supported(arg)) {
+            link_stats.rejects++;
+            link_send_reply(LINK_CMD_BAUD, 0);
+            return;
+        }
+        // 应答以当前波特率发出，排在已入队的遥测后面；发不出去时等上位机重发
+        if (link_send_reply(LINK_CMD_BAUD, arg) == 0) {
+            link_begin_switch(arg, now);
+        }
+    } else if (cmd == LINK_CMD_PING) {
+        link_last_ping = now;
+        if (link_state == LINK_STATE_CONFIRM) {
+            link_state = LINK_STATE_RUNNING;
+            link_stats.switches++;
+            link_err_window = now;
+            link_err_base = link_rx_error_count();
+        }
+    } else if (cmd == LINK_CMD_ARQ) {
+        link_send_reply(LINK_CMD_ARQ, link_arq_enable(arg));  // 应答丢了上位机会重发，重复打开不清零序号
+    } else if (cmd == LINK_CMD_ACK) {
+        link_arq_on_ack((uint16_t)(arg & 0xFFFF), (uint16_t)(arg >> 16));
+    } else if (cmd == LINK_CMD_STRIPE) {
+        link_send_reply(LINK_CMD_STRIPE, link_stripe_enable(arg));
+    }
+}
+
+// 逐字节找帧头、收满 9 字节后校验 CRC
+static void link_rx_byte(uint8_t byte, uint32_t now)
+{
+    if (link_rx_len == 0 && byte != LINK_FRAME_HEADER0) {
+        return;
+    }
+    if (link_rx_len == 1 && byte != LINK_FRAME_HEADER1) {
+        link_rx_len = (byte == LINK_FRAME_HEADER0) ? 1 : 0;
+        return;
+    }
+
+    link_rx_frame[link_rx_len++] = byte;
+    if (link_rx_len < LINK_FRAME_LEN) {
+        return;
+    }
+    link_rx_len = 0;
+
+    if (crc16_ccitt(link_rx_frame, 7) !=
+        (((uint16_t)link_rx_frame[7] << 8) | link_rx_frame[8])) {
+        link_stats.bad_frames++;
+        return;
+    }
+    link_handle_frame(link_rx_frame, now);
+}
+
+// ==================== Public Functions ====================
+
+void link_control_init(void)
+{
+    uint32_t now = LINK_CONTROL_NOW();
+
+    link_state = LINK_STATE_RUNNING;
+    link_pending_baud = UART_ASYNC_BAUD_DEFAULT;
+    link_state_since = now;
+    link_last_ping = now;
+    link_err_window = now;
+    link_err_base = link_rx_error_count();
+    link_rx_len = 0;
+
+    link_stats.frames = 0;
+    link_stats.bad_frames = 0;
+    link_stats.switches = 0;
+    link_stats.rejects = 0;
+    link_stats.fallbacks = 0;
+
+    uart_channel_log("[LINK] %d baud, waiting for host negotiation\r\n", uart_async_get_baud());
+}
+
+void link_control_poll(void)
+{
+    uint8_t buf[32];
+    uint32_t now = LINK_CONTROL_NOW();
+    uint32_t n, i;
+
+    // 1. 解析上位机发来的控制帧
+    while ((n = uart_async_read(buf, sizeof(buf))) > 0) {
+        for (i = 0; i < n; i++) {
+            link_rx_byte(buf[i], now);
+        }
+    }
+
+    switch (link_state) {
+    case LINK_STATE_SWITCHING:
+        // 2. ACK（和它前面的遥测）全部发出后再换分频，条带化的其他链路一起切换
+        if (uart_async_is_busy() || link_stripe_is_busy() || uart_async_is_throttled()) {
+            break;
+        }
+        if (uart_async_wait_complete() != 0) {
+            break;                      // FIFO 里最多 32 字节，发不完说明被流控暂停了，下一轮再等
+        }
+        uart_async_set_baud(link_pending_baud);
+        uart_async_reset_latency();     // 线路时间随波特率变化，重新统计
+        link_stripe_set_baud(link_pending_baud);
+        link_last_ping = now;
+        link_state_since = now;
+        link_err_window = now;
+        link_err_base = link_rx_error_count();
+        link_state = (link_pending_baud == UART_ASYNC_BAUD_DEFAULT) ?
+                     LINK_STATE_RUNNING : LINK_STATE_CONFIRM;
+        break;
+
+    case LINK_STATE_CONFIRM:
+        // 3. 上位机没跟上：回退
+        if (now - link_state_since > LINK_CONFIRM_MS * LINK_TICKS_PER_MS) {
+            link_fallback(now, "no confirm");
+        }
+        break;
+
+    case LINK_STATE_RUNNING:
+    default:
+        if (uart_async_get_baud() == UART_ASYNC_BAUD_DEFAULT) {
+            break;
+        }
+        // 4. 高波特率下的回退条件：保活超时 / 错误计数上升
+        if (now - link_last_ping > LINK_KEEPALIVE_MS * LINK_TICKS_PER_MS) {
+            link_fallback(now, "keepalive timeout");
+        } else if (now - link_err_window > LINK_ERROR_WINDOW_MS * LINK_TICKS_PER_MS) {
+            uint32_t errors = link_rx_error_count();
+            if (errors - link_err_base > LINK_ERROR_LIMIT) {
+                link_fallback(now, "rx errors");
+            }
+            link_err_window = now;
+            link_err_base = errors;
+        }
+        break;
+    }
+}
+
+int link_control_tx_allowed(void)
+{
+    return link_state != LINK_STATE_SWITCHING;
+}
+
+uint32_t link_control_baud(void)
+{
+    return uart_async_get_baud();
+}
+
+link_control_stats_t *link_control_get_stats(void)
+{
+    return &link_stats;
+}
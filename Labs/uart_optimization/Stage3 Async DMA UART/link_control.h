@@ -0,0 +1,74 @@
+#ifndef __LINK_CONTROL_H
+#define __LINK_CONTROL_H
+
+#include "../stdio/include/types.h"
+#include "../bsp/timebase/bsp_timebase.h"
+// ==================== 链路控制：波特率协商 ====================
+// 上电固定 115200，上位机通过 UART RX 发控制帧协商更高的波特率：
+//
+//   上位机                              板子
+//   BAUD(921600)      @115200  ──→
+//                                ←──    BAUD|0x80(921600)  @115200（0 = 不支持）
+//                                       等 ACK 发完 → 切换分频
+//   切换串口波特率
+//   PING              @921600  ──→      收到 PING：确认切换
+//   PING（每秒一次） @921600  ──→      保活
+//
+// 回退到 115200（板子侧）：
+// - 切换后 LINK_CONFIRM_MS 内没收到 PING（上位机没跟上）
+// - 超过 LINK_KEEPALIVE_MS 没收到 PING（上位机退出或已回退）
+// - 一个窗口内 RX 帧错误 + 溢出超过 LINK_ERROR_LIMIT（线路质量不够）
+// 上位机侧：校验错误持续增加或长时间收不到有效包时自己回退，不再发 PING，板子随后超时回退
+//
+// 控制帧（两个方向相同，9 字节，与遥测帧头 0xAA 不冲突）：
+//   偏移  长度  内容
+//   0     2     0xA5 0x5A
+//   2     1     命令（应答 = 命令 | 0x80）
+//   3     4     参数（小端）
+//   7     2     CRC-16/CCITT-FALSE（覆盖前 7 字节，高字节在前）
+//
+// 切换期间（ACK 排队到发完、分频切换）主循环不要再发遥测：link_control_tx_allowed()
+// 可靠模式的 ARQ / ACK 命令也走控制帧，转给 link_arq.c 处理；条带化的 STRIPE 命令转给 link_stripe.c
+// 条带化打开时（SENSOR_UART_STRIPE）切换对所有链路生效，等每条链路都发空后一起改分频
+
+#define LINK_FRAME_HEADER0          0xA5
+#define LINK_FRAME_HEADER1          0x5A
+#define LINK_FRAME_LEN              9
+
+#define LINK_CMD_BAUD               0x01    // 参数：目标波特率
+#define LINK_CMD_PING               0x02    // 参数：0（确认切换 / 保活）
+#define LINK_CMD_ARQ                0x03    // 参数：1=打开 / 0=关闭可靠模式，应答窗口大小（见 link_arq.h）
+#define LINK_CMD_ACK                0x04    // 参数：next(u16) | sack(u16) << 16，不应答
+#define LINK_CMD_STRIPE             0x05    // 参数：1=打开 / 0=关闭条带化，应答链路数（见 link_stripe.h）
+#define LINK_CMD_REPLY              0x80
+
+#define LINK_TICKS_PER_MS           (timebase_rate_hz() / 1000)     // GPT1 标定频率（约 645kHz）
+#define LINK_CONFIRM_MS             1000
+#define LINK_KEEPALIVE_MS           3000
+#define LINK_ERROR_WINDOW_MS        1000
+#define LINK_ERROR_LIMIT            8
+
+// 时间源，默认 GPT1 自由计数器
+#ifndef LINK_CONTROL_NOW
+#define LINK_CONTROL_NOW()          (GPT1->CNT)
+#endif
+
+// ==================== Data Structures ====================
+
+typedef struct {
+    uint32_t frames;            // 收到的有效控制帧
+    uint32_t bad_frames;        // CRC 错误的控制帧
+    uint32_t switches;          // 切换成功（收到确认）次数
+    uint32_t rejects;           // 不支持的波特率请求
+    uint32_t fallbacks;         // 回退到默认波特率的次数
+} link_control_stats_t;
+
+// ==================== Function Declarations ====================
+
+void link_control_init(void);                   // uart_async_init() / uart_async_rx_enable() 之后调用
+void link_control_poll(void);                   // 主循环每轮调用：解析 RX、推进切换状态机、检查回退条件
+int link_control_tx_allowed(void);              // 1=可以发遥测，0=正在切换波特率
+uint32_t link_control_baud(void);               // 当前波特率
+link_control_stats_t *link_control_get_stats(void);
+
+#endif // __LINK_CONTROL_H
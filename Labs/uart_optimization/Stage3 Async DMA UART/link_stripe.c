@@ -0,0 +1,213 @@
+#include "link_stripe.h"
+#include "../imx6ul/imx6ul.h"
+#include "../bsp/uart/bsp_uart_channel.h"
+#include "../stdio/include/string.h"
+
+// ==================== Private Variables ====================
+
+// 链路 1 ~ LINK_STRIPE_LINKS-1 的 UART 实例（链路 0 是默认实例 UART1，由 uart_channel 发送）
+static uart_async_port_t stripe_ports[LINK_STRIPE_LINKS - 1];
+
+static bool stripe_available;   // link_stripe_init() 之后才接受 STRIPE 命令
+static bool stripe_enabled;
+static bool stripe_stalled;     // 上一次查询时轮到的链路是否忙
+
+static uint32_t stripe_next;                    // 下一帧走的链路
+static uint16_t stripe_seq[LINK_STRIPE_LINKS];  // 各链路下一帧的链路序号
+static uint8_t stripe_stage[LINK_STRIPE_STAGE_SIZE];
+
+static link_stripe_stats_t stripe_stats;
+
+// ==================== Private Functions ====================
+
+// 链路 link 上一帧（条带头 + len 字节负载）占用的 TX 缓冲区字节数
+static uint32_t stripe_wire_len(uint32_t link, uint32_t len)
+{
+    if (link == 0) {
+        return uart_channel_wire_len(LINK_STRIPE_HEAD_LEN + len);
+    }
+    return uart_async_port_wire_len(&stripe_ports[link - 1], LINK_STRIPE_HEAD_LEN + len);
+}
+
+// 链路 link 能否再入队一个描述符（UART1 上给控制应答留的描述符照样保留）
+static int stripe_link_ready(uint32_t link)
+{
+    if (link == 0) {
+        return uart_channel_tx_ready(UART_CHANNEL_TELEMETRY);
+    }
+    return uart_async_port_tx_free(&stripe_ports[link - 1]) > 0;
+}
+
+// ==================== Public Functions ====================
+
+void link_stripe_init(void)
+{
+    uint32_t i;
+
+    stripe_enabled = false;
+    stripe_available = false;
+
+    // 链路 1：只接 TX 引脚，以 UART1 当前的波特率和帧格式起步
+    // 打不开（软复位超时）就不支持条带化：STRIPE 命令应答 0，遥测只走 UART1
+    IOMUXC_SetPinMux(LINK_STRIPE_TX_PINMUX, 0);
+    IOMUXC_SetPinConfig(LINK_STRIPE_TX_PINMUX, 0x10B0);
+    if (uart_async_port_open(&stripe_ports[0], LINK_STRIPE_UART, LINK_STRIPE_IRQn, uart_async_get_baud()) != 0) {
+        return;
+    }
+    uart_async_port_set_framing(&stripe_ports[0], UART_ASYNC_FRAMING_COBS);
+
+    memset(&stripe_stats, 0, sizeof(stripe_stats));
+    for (i = 0; i < LINK_STRIPE_LINKS; i++) {
+        stripe_seq[i] = 0;
+    }
+    stripe_next = 0;
+    stripe_stalled = false;
+    stripe_available = true;
+}
+
+uint32_t link_stripe_enable(uint32_t enable)
+{
+    uint32_t i;
+
+    if (!stripe_available) {
+        return 0;
+    }
+    if (!enable) {
+        stripe_enabled = false;
+        return 0;
+    }
+    // 已经打开时只重发应答：上位机没收到应答而重发命令时，不能把帧号清零
+    if (!stripe_enabled) {
+        for (i = 0; i < LINK_STRIPE_LINKS; i++) {
+            stripe_seq[i] = 0;
+        }
+        stripe_next = 0;
+        stripe_enabled = true;
+        stripe_stats.enables++;
+        uart_channel_log("[STRIPE] telemetry striped over %d UARTs\r\n", LINK_STRIPE_LINKS);
+    }
+    return LINK_STRIPE_LINKS;
+}
+
+int link_stripe_enabled(void)
+{
+    return stripe_enabled;
+}
+
+uint32_t link_stripe_tx_room(uint32_t elem_len)
+{
+    uint32_t per_link = UART_ASYNC_TX_BUFFER_SIZE;
+    uint32_t ready, link, n;
+
+    // 从轮到的链路开始数连续空闲的链路：轮到的链路忙时整批等待，不能跳过它
+    for (ready = 0; ready < LINK_STRIPE_LINKS; ready++) {
+        link = (stripe_next + ready) % LINK_STRIPE_LINKS;
+        if (!stripe_link_ready(link)) {
+            break;
+        }
+        n = UART_ASYNC_TX_BUFFER_SIZE / stripe_wire_len(link, elem_len);
+        if (n < per_link) {
+            per_link = n;
+        }
+    }
+
+    if (ready == 0) {
+        if (!stripe_stalled) {
+            stripe_stats.stalls++;  // 只在开始等待时计一次
+        }
+        stripe_stalled = true;
+        return 0;
+    }
+    stripe_stalled = false;
+    if (per_link == 0) {
+        return 0;                   // 一帧都装不进描述符
+    }
+    // 全部空闲：每条链路各装满一个描述符；否则前 ready 条链路各一帧
+    return (ready == LINK_STRIPE_LINKS) ? per_link * LINK_STRIPE_LINKS : ready;
+}
+
+int link_stripe_send(const uint8_t *base, uint32_t elem_len, uint32_t stride, uint32_t count)
+{
+    uint32_t len = LINK_STRIPE_HEAD_LEN + elem_len;
+    uint32_t k, i, n, link;
+    int ret;
+
+    if (!stripe_enabled || base == NULL || elem_len == 0 || count == 0 || stride < elem_len) {
+        return -2;
+    }
+    if (count > link_stripe_tx_room(elem_len)) {
+        return -1;
+    }
+
+    // 第 i 个元素走链路 (stripe_next + i) % LINK_STRIPE_LINKS：每条链路上的元素间隔 LINK_STRIPE_LINKS 个，
+    // 加上条带头拼进暂存区后一次入队（一条链路一个描述符）
+    for (k = 0; k < LINK_STRIPE_LINKS && k < count; k++) {
+        link = (stripe_next + k) % LINK_STRIPE_LINKS;
+        n = 0;
+        for (i = k; i < count; i += LINK_STRIPE_LINKS) {
+            uint8_t *frame = &stripe_stage[n * len];
+            uint16_t seq = (uint16_t)(stripe_seq[link] + n);
+
+            frame[0] = LINK_STRIPE_HEADER0;
+            frame[1] = LINK_STRIPE_HEADER1;
+            frame[2] = (uint8_t)link;
+            frame[3] = (uint8_t)(seq & 0xFF);
+            frame[4] = (uint8_t)(seq >> 8);
+            frame[5] = (uint8_t)(frame[0] + frame[1] + frame[2] + frame[3] + frame[4]);
+            memcpy(&frame[LINK_STRIPE_HEAD_LEN], base + i * stride, elem_len);
+            n++;
+        }
+
+        // COBS 帧格式下两种发送都是编码复制，返回后暂存区就可以给下一条链路用
+        if (link == 0) {
+            ret = uart_channel_send_ref(UART_CHANNEL_TELEMETRY, stripe_stage, len, len, n, NULL, NULL);
+        } else {
+            ret = uart_async_port_send_gather(&stripe_ports[link - 1], stripe_stage, len, len, n);
+        }
+        if (ret != 0) {
+            return ret;             // 上面已检查过空闲描述符，不会发生
+        }
+        stripe_seq[link] += n;
+        stripe_stats.frames[link] += n;
+        stripe_stats.bytes[link] += n * elem_len;
+    }
+
+    stripe_next = (stripe_next + count) % LINK_STRIPE_LINKS;
+    return 0;
+}
+
+int link_stripe_is_busy(void)
+{
+    uint32_t i;
+
+    for (i = 0; stripe_available && i < LINK_STRIPE_LINKS - 1; i++) {
+        if (uart_async_port_is_busy(&stripe_ports[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void link_stripe_set_baud(uint32_t baud)
+{
+    uint32_t i;
+
+    for (i = 0; stripe_available && i < LINK_STRIPE_LINKS - 1; i++) {
+        uart_async_port_wait_complete(&stripe_ports[i]);    // 超时也照常切换，残留字节上位机按 CRC 丢弃
+        uart_async_port_set_baud(&stripe_ports[i], baud);
+        uart_async_port_reset_latency(&stripe_ports[i]);
+    }
+}
+
+uart_async_port_t *link_stripe_port(uint32_t link)
+{
+    if (link == 0 || link >= LINK_STRIPE_LINKS) {
+        return NULL;
+    }
+    return &stripe_ports[link - 1];
+}
+
+link_stripe_stats_t *link_stripe_get_stats(void)
+{
+    return &stripe_stats;
+}
@@ -0,0 +1,82 @@
+#ifndef __LINK_STRIPE_H
+#define __LINK_STRIPE_H
+
+#include "../stdio/include/types.h"
+#include "batch_frame.h"
+#include "../bsp/uart/bsp_uart_async.h"
+// ==================== 多 UART 条带化：遥测带宽叠加 ====================
+// 单个 UART 的带宽不够高采样率 IMU 采集时，把遥测帧轮流分到两个 UART 上发，原始带宽翻倍
+// 链路 0 是 UART1（控制台，仍承载控制应答和日志），链路 1 是 LINK_STRIPE_UART（只发遥测）
+// 包格式不变：每个遥测负载（单包 / 批量帧 / 压缩批量帧）前面加一个条带头，各链路独立编号
+//
+// 需要 COBS 分帧（SENSOR_COBS_FRAMING 或 SENSOR_UART_CHANNELS），上位机 --framing cobs --stripe PORT2
+//
+//   上位机                              板子
+//   STRIPE(1)        @UART1   ──→       打开条带化，全局帧号从 0 开始
+//                             ←──       STRIPE|0x80(链路数)（0 = 固件没打开 SENSOR_UART_STRIPE）
+//                   UART1     ←──       S(0, 0) S(0, 1) S(0, 2) ...     帧 0 2 4 ...
+//                   UART3     ←──       S(1, 0) S(1, 1) S(1, 2) ...     帧 1 3 5 ...
+//
+// 帧（各链路一个 COBS 帧；链路 0 开了逻辑通道时带遥测标签，链路 1 不带标签）：
+//   偏移  长度  内容
+//   0     2     0xAA 0x53
+//   2     1     链路号（0 ~ LINK_STRIPE_LINKS-1）
+//   3     2     链路序号（小端，本链路每帧 +1）
+//   5     1     头校验和（前 5 字节求和取低 8 位）：负载的 CRC / 校验和不覆盖条带头，
+//                 链路序号错了会让上位机把后面的好帧都当成迟到的
+//   6     n     负载（原样，自带 CRC / 校验和）
+//
+// 分配：严格轮转，全局第 g 帧走链路 g % LINK_STRIPE_LINKS、链路序号 g / LINK_STRIPE_LINKS，
+// 上位机由 (链路号, 链路序号) 还原 g 后按序合并；链路序号断档说明该链路丢了帧，跳过不等
+// 轮到的链路没有空闲描述符时整批等待（遥测留在 Ring 里），不跳到另一条链路，否则合并要等超时
+// 波特率协商对所有链路生效（link_control 切换时一起改分频），上位机两个串口一起切换
+// 与可靠模式（SENSOR_UART_RELIABLE）互斥
+
+#define LINK_STRIPE_HEADER0         0xAA
+#define LINK_STRIPE_HEADER1         0x53
+#define LINK_STRIPE_HEAD_LEN        6
+
+#define LINK_STRIPE_LINKS           2
+
+// 链路 1：UART3（UART3_TX_DATA 引脚），只用 TX
+#ifndef LINK_STRIPE_UART
+#define LINK_STRIPE_UART            UART3
+#endif
+#ifndef LINK_STRIPE_IRQn
+#define LINK_STRIPE_IRQn            UART3_IRQn
+#endif
+#ifndef LINK_STRIPE_TX_PINMUX
+#define LINK_STRIPE_TX_PINMUX       IOMUXC_UART3_TX_DATA_UART3_TX
+#endif
+
+// 一次 link_stripe_send() 在一条链路上的帧先拼进暂存区（带条带头），再编码进 TX 描述符
+// 编码后才受描述符大小限制，所以暂存区与描述符一样大就够（最大批量帧 + 条带头也装得下）
+#define LINK_STRIPE_STAGE_SIZE      UART_ASYNC_TX_BUFFER_SIZE
+
+#if LINK_STRIPE_HEAD_LEN + BATCH_FRAME_MAX_LEN > LINK_STRIPE_STAGE_SIZE
+#error "LINK_STRIPE_STAGE_SIZE must hold the largest batch frame"
+#endif
+
+// ==================== Data Structures ====================
+
+typedef struct {
+    uint32_t frames[LINK_STRIPE_LINKS];     // 各链路发出的帧数
+    uint32_t bytes[LINK_STRIPE_LINKS];      // 各链路的负载字节数（不含条带头和 COBS 开销）
+    uint32_t stalls;                        // 轮到的链路没有空闲描述符、遥测等待的次数
+    uint32_t enables;                       // 上位机打开条带化的次数
+} link_stripe_stats_t;
+
+// ==================== Function Declarations ====================
+
+void link_stripe_init(void);                    // 打开链路 1 的 UART（uart_async_init() / 设置帧格式之后调用，打不开时不支持条带化）
+uint32_t link_stripe_enable(uint32_t enable);   // STRIPE 命令：1=打开 / 0=关闭，返回应答参数（链路数，不支持时 0）
+int link_stripe_enabled(void);                  // 1=遥测走 link_stripe_send()
+uint32_t link_stripe_tx_room(uint32_t elem_len);  // 现在一次最多能发几个 elem_len 字节的帧（0=轮到的链路忙）
+int link_stripe_send(const uint8_t *base, uint32_t elem_len,
+                     uint32_t stride, uint32_t count);  // 第 i 个元素走下一条轮到的链路，0=成功，-1=忙，-2=参数错误
+int link_stripe_is_busy(void);                  // 链路 1 还有没写进 FIFO 的数据
+void link_stripe_set_baud(uint32_t baud);       // 链路 1 跟随 UART1 切换波特率（等发完再改分频）
+uart_async_port_t *link_stripe_port(uint32_t link);  // 链路 link（>= 1）的 UART 实例，统计用
+link_stripe_stats_t *link_stripe_get_stats(void);
+
+#endif // __LINK_STRIPE_H
@@ -0,0 +1,23 @@
+#include "timebase_frame.h"
+#include "packet_crc.h"
+
+uint32_t timebase_frame_build(uint8_t *buf, uint64_t now)
+{
+    uint16_t crc;
+    uint32_t i, hz = timebase_rate_hz();
+
+    buf[0] = TIMEBASE_FRAME_HEADER0;
+    buf[1] = TIMEBASE_FRAME_HEADER1;
+    for (i = 0; i < 8; i++) {
+        buf[2 + i] = (uint8_t)(now >> (8 * i));
+    }
+    for (i = 0; i < 4; i++) {
+        buf[10 + i] = (uint8_t)(hz >> (8 * i));
+    }
+    buf[14] = timebase_calibrated() ? TIMEBASE_FRAME_FLAG_CALIBRATED : 0;
+    crc = crc16_ccitt(buf, TIMEBASE_FRAME_LEN - 2);
+    buf[TIMEBASE_FRAME_LEN - 2] = (uint8_t)(crc >> 8);
+    buf[TIMEBASE_FRAME_LEN - 1] = (uint8_t)(crc & 0xFF);
+
+    return TIMEBASE_FRAME_LEN;
+}
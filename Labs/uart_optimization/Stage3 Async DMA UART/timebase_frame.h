@@ -0,0 +1,29 @@
+#ifndef __TIMEBASE_FRAME_H
+#define __TIMEBASE_FRAME_H
+
+#include "../stdio/include/types.h"
+#include "../bsp/timebase/bsp_timebase.h"
+// ==================== 时间基准帧 ====================
+// 包里的时间戳只有 32 位（64 位计数的低 32 位，约 1.85 小时回绕），格式不改
+// 遥测流里每秒插一个时间基准帧，带完整的 64 位计数，上位机取离它最近的那一圈还原每个时间戳的高位：
+// 只要时间戳和最近的基准帧相差不到半圈（约 55 分钟）就唯一确定，多天的采集也不用猜回绕
+//
+//   偏移  长度  内容
+//   0     2     帧头 0xAA 0x58
+//   2     8     timebase_now64()（小端）
+//   10    4     GPT 频率 Hz（timebase_rate_hz()，小端）：上位机按它把 tick 换算成时间
+//   14    1     标志：bit 0 = 频率是启动时对 RTC 标定出来的（timebase_calibrated()）
+//   15    2     CRC-16/CCITT-FALSE（高字节在前）
+//
+// 和遥测走同一条路（逻辑通道的遥测标签 / 条带化时只走链路 0），可靠模式下不进重传窗口，丢了等下一秒
+
+#define TIMEBASE_FRAME_HEADER0      0xAA
+#define TIMEBASE_FRAME_HEADER1      0x58
+#define TIMEBASE_FRAME_LEN          17
+#define TIMEBASE_FRAME_PERIOD_TICKS timebase_rate_hz()  // 1 秒
+
+#define TIMEBASE_FRAME_FLAG_CALIBRATED  (1 << 0)
+
+uint32_t timebase_frame_build(uint8_t *buf, uint64_t now);  // 写 TIMEBASE_FRAME_LEN 字节，返回帧长
+
+#endif // __TIMEBASE_FRAME_H